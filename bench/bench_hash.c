@@ -0,0 +1,606 @@
+/**
+ * @file bench_hash.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Measures the throughput and the quality of the hash functions the maps can use
+ * @details For every entry of the variants table it reports bytes per cycle for keys of 1 byte to 4 KB, the worst
+ * avalanche bias over every input and output bit, and a chi-squared test of how evenly hash % capacity spreads
+ * a set of key corpora over the buckets, for a power of two and an odd capacity. The corpora are generated to
+ * look like common real keys, and more can be read from files given on the command line, one key per line.
+ * A variant that fails a quality test makes the program exit with 1, so a hash change can be gated on it. To
+ * compare a new hash function, add an adapter for it to the variants table.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "murmur3.h"
+#include "siphash.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define BENCH_HAVE_TSC 1
+#else
+    #define BENCH_HAVE_TSC 0
+#endif
+
+#define SEED                0x5eed5eed5eed5eedULL
+#define MAX_KEY_LENGTH      4096            // Longest key timed
+#define TIMED_BYTES         (16 << 20)      // Bytes hashed per timed key length
+#define MAX_TIMED_HASHES    (1 << 21)       // Most hashes timed per key length
+#define TIMED_REPEATS       5               // Timed passes per key length after the warm-up, the best one is kept
+#define AVALANCHE_TRIALS    4000            // Random keys per avalanche length
+#define AVALANCHE_LIMIT     6.0             // Largest z-score of a flip probability that passes
+#define CORPUS_KEYS         200000          // Keys per generated corpus
+#define CORPUS_KEY_LENGTH   96              // Longest key of a corpus, longer lines of a file are cut
+#define POWER_BUCKETS       65536           // Power of two capacity, where only the low bits pick the bucket
+#define PRIME_BUCKETS       65521           // Prime capacity, where every bit does
+#define CHI_SQUARED_LIMIT   4.0             // Largest z-score of the chi-squared statistic that passes
+
+typedef uint64_t (*bench_hash_fn_t)(const void* key, size_t len, uint64_t seed);
+
+/**
+ * @brief A hash function to measure, returning the word the maps take hash % capacity of
+ * 
+ */
+typedef struct
+{
+    const char* name;
+    bench_hash_fn_t fn;
+    unsigned int bits;      // Bits of output
+}hash_variant_t;
+
+/**
+ * @brief Keys stored back to back, each NUL terminated
+ * 
+ */
+typedef struct
+{
+    char name[64];
+    char* keys;             // CORPUS_KEY_LENGTH bytes per key
+    size_t count;
+}corpus_t;
+
+/**
+ * @brief MurmurHash3_x86_32, the hash of maps on 32 bit platforms
+ * 
+ * @param key - bytes to hash
+ * @param len - number of bytes
+ * @param seed - seed, folded to 32 bits like the maps do
+ * @return uint64_t
+ */
+static uint64_t hash_x86_32(const void* key, size_t len, uint64_t seed)
+{
+    uint32_t hash = 0;
+
+    MurmurHash3_x86_32(key, (int)len, (uint32_t)(seed ^ (seed >> 32)), &hash);
+    return hash;
+}
+
+/**
+ * @brief First 64 bits of MurmurHash3_x86_128
+ * 
+ * @param key - bytes to hash
+ * @param len - number of bytes
+ * @param seed - seed, truncated to 32 bits
+ * @return uint64_t
+ */
+static uint64_t hash_x86_128(const void* key, size_t len, uint64_t seed)
+{
+    uint32_t hash[4] = {0};
+
+    MurmurHash3_x86_128(key, (int)len, (uint32_t)seed, hash);
+    return (uint64_t)hash[0] | ((uint64_t)hash[1] << 32);
+}
+
+/**
+ * @brief First 64 bits of MurmurHash3_x64_128
+ * 
+ * @param key - bytes to hash
+ * @param len - number of bytes
+ * @param seed - seed, truncated to 32 bits
+ * @return uint64_t
+ */
+static uint64_t hash_x64_128(const void* key, size_t len, uint64_t seed)
+{
+    uint64_t hash[2] = {0};
+
+    MurmurHash3_x64_128(key, (int)len, (uint32_t)seed, hash);
+    return hash[0];
+}
+
+/**
+ * @brief First 64 bits of MurmurHash3_x64_128 with a 64 bit seed, the hash of maps on 64 bit platforms
+ * 
+ * @param key - bytes to hash
+ * @param len - number of bytes
+ * @param seed - seed
+ * @return uint64_t
+ */
+static uint64_t hash_x64_128_seed64(const void* key, size_t len, uint64_t seed)
+{
+    uint64_t hash[2] = {0};
+
+    MurmurHash3_x64_128_seed64(key, (int)len, seed, hash);
+    return hash[0];
+}
+
+/**
+ * @brief SipHash-1-3, the hash of maps created with HASHMAP_FLAG_SIPHASH
+ * 
+ * @param key - bytes to hash
+ * @param len - number of bytes
+ * @param seed - first half of the key, the second is derived from it like the maps do
+ * @return uint64_t
+ */
+static uint64_t hash_siphash13(const void* key, size_t len, uint64_t seed)
+{
+    const uint64_t sip_key[2] = { seed, MurmurHash3_fmix64(seed ^ 0x9e3779b97f4a7c15ULL) };
+
+    return SipHash13(key, len, sip_key);
+}
+
+// Hash functions compared. Add an adapter here to measure a new one against the others.
+static const hash_variant_t variants[] =
+{
+    { "murmur3_x86_32",         hash_x86_32,            32 },
+    { "murmur3_x86_128",        hash_x86_128,           64 },
+    { "murmur3_x64_128",        hash_x64_128,           64 },
+    { "murmur3_x64_128_seed64", hash_x64_128_seed64,    64 },
+    { "siphash13",              hash_siphash13,         64 },
+};
+
+#define VARIANT_COUNT (sizeof(variants) / sizeof(variants[0]))
+
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds
+ * 
+ * @return double
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the time stamp counter, or 0 where there is none
+ * 
+ * @return uint64_t
+ */
+static uint64_t now_cycles(void)
+{
+#if BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Small xorshift generator so every run sees the same keys
+ * 
+ * @param state - generator state
+ * @return uint64_t
+ */
+static uint64_t next_random(uint64_t* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/**
+ * @brief Prints bytes per cycle, or GB/s without a cycle counter, of every variant for keys of 1 byte to 4 KB
+ * @details The key start moves through the buffer so consecutive hashes don't see the exact same bytes. An untimed
+ * pass warms the caches, branch predictors and clock first, then the fastest of TIMED_REPEATS passes is reported
+ * since anything slower was slowed by something other than the hash.
+ * 
+ */
+static void bench_throughput(void)
+{
+    const char* function_name = "hashmap_hashbench():";
+    uint8_t* data = (uint8_t *)malloc(MAX_KEY_LENGTH + 256);
+    uint64_t state = SEED;
+    volatile uint64_t sink = 0;
+
+    if(data == NULL) return;
+
+    for(size_t i = 0; i < MAX_KEY_LENGTH + 256; i++) data[i] = (uint8_t)next_random(&state);
+
+    printf("%s throughput in %s\n%8s", function_name, BENCH_HAVE_TSC ? "bytes/cycle (TSC cycles)" : "GB/s", "length");
+    for(size_t v = 0; v < VARIANT_COUNT; v++) printf(" %23s", variants[v].name);
+    printf("\n");
+
+    for(size_t len = 1; len <= MAX_KEY_LENGTH; len *= 2)
+    {
+        size_t hashes = TIMED_BYTES / len;
+
+        if(hashes > MAX_TIMED_HASHES) hashes = MAX_TIMED_HASHES;
+
+        printf("%8zu", len);
+
+        for(size_t v = 0; v < VARIANT_COUNT; v++)
+        {
+            double best = 0;
+
+            for(size_t pass = 0; pass <= TIMED_REPEATS; pass++)
+            {
+                uint64_t result = 0;
+                double start = now_ns();
+                uint64_t start_cycles = now_cycles();
+                double rate = 0;
+
+                for(size_t i = 0; i < hashes; i++) result ^= variants[v].fn(data + (i & 255), len, SEED);
+
+                if(BENCH_HAVE_TSC) rate = (double)(len * hashes) / (double)(now_cycles() - start_cycles);
+                else rate = (double)(len * hashes) / (now_ns() - start);
+
+                sink ^= result;
+
+                // Pass 0 is the warm-up
+                if(pass > 0 && rate > best) best = rate;
+            }
+
+            printf(" %23.3f", best);
+        }
+
+        printf("\n");
+    }
+
+    (void)sink;
+    free(data);
+}
+
+/**
+ * @brief Flips every input bit of random keys and returns the worst z-score of an output bit's flip probability
+ * @details A perfect hash flips each output bit with probability 0.5 whatever input bit changed
+ * 
+ * @param variant - the hash
+ * @param len - key length in bytes
+ * @param worst_bias - set to the largest |P(flip) - 0.5| * 2
+ * @return double - the z-score, NAN if memory ran out
+ */
+static double avalanche(const hash_variant_t* variant, size_t len, double* worst_bias)
+{
+    size_t input_bits = len * 8;
+    uint32_t* flips = (uint32_t *)calloc(input_bits * variant->bits, sizeof(uint32_t));
+    uint8_t key[64];
+    uint64_t state = SEED ^ len;
+    uint32_t worst = AVALANCHE_TRIALS / 2;
+
+    if(flips == NULL || len > sizeof(key))
+    {
+        free(flips);
+        *worst_bias = NAN;
+        return NAN;
+    }
+
+    for(size_t trial = 0; trial < AVALANCHE_TRIALS; trial++)
+    {
+        uint64_t base = 0;
+
+        for(size_t i = 0; i < len; i++) key[i] = (uint8_t)next_random(&state);
+
+        base = variant->fn(key, len, SEED);
+
+        for(size_t bit = 0; bit < input_bits; bit++)
+        {
+            uint64_t diff = 0;
+
+            key[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+            diff = base ^ variant->fn(key, len, SEED);
+            key[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+
+            for(unsigned int out = 0; out < variant->bits; out++) flips[bit * variant->bits + out] += (diff >> out) & 1;
+        }
+    }
+
+    // The count furthest from half the trials, on either side
+    for(size_t cell = 0; cell < input_bits * variant->bits; cell++)
+    {
+        uint32_t distance = (flips[cell] > AVALANCHE_TRIALS / 2) ? flips[cell] - AVALANCHE_TRIALS / 2 : AVALANCHE_TRIALS / 2 - flips[cell];
+        uint32_t worst_distance = (worst > AVALANCHE_TRIALS / 2) ? worst - AVALANCHE_TRIALS / 2 : AVALANCHE_TRIALS / 2 - worst;
+
+        if(distance > worst_distance) worst = flips[cell];
+    }
+
+    free(flips);
+
+    *worst_bias = fabs((double)worst / AVALANCHE_TRIALS - 0.5) * 2;
+
+    return fabs((double)worst - AVALANCHE_TRIALS / 2.0) / sqrt(AVALANCHE_TRIALS / 4.0);
+}
+
+/**
+ * @brief Places a corpus in buckets with hash % buckets and returns the z-score of the chi-squared statistic
+ * @details Keys placed uniformly at random give about 0. Large positive values mean some buckets get far more
+ * keys than they should.
+ * 
+ * @param variant - the hash
+ * @param corpus - the keys
+ * @param buckets - capacity of the imagined map
+ * @return double - the z-score, NAN if memory ran out
+ */
+static double chi_squared(const hash_variant_t* variant, const corpus_t* corpus, size_t buckets)
+{
+    uint32_t* counts = (uint32_t *)calloc(buckets, sizeof(uint32_t));
+    double expected = (double)corpus->count / (double)buckets;
+    double statistic = 0;
+    double freedom = (double)buckets - 1;
+
+    if(counts == NULL) return NAN;
+
+    for(size_t i = 0; i < corpus->count; i++)
+    {
+        const char* key = corpus->keys + i * CORPUS_KEY_LENGTH;
+
+        counts[variant->fn(key, strlen(key), SEED) % buckets]++;
+    }
+
+    for(size_t bucket = 0; bucket < buckets; bucket++)
+    {
+        double difference = (double)counts[bucket] - expected;
+
+        statistic += difference * difference / expected;
+    }
+
+    free(counts);
+
+    return (statistic - freedom) / sqrt(2 * freedom);
+}
+
+/**
+ * @brief Allocates an empty corpus
+ * 
+ * @param name - name printed with its results
+ * @param count - room for this many keys
+ * @return corpus_t* - NULL if memory ran out
+ */
+static corpus_t* corpus_create(const char* name, size_t count)
+{
+    corpus_t* corpus = (corpus_t *)calloc(1, sizeof(corpus_t));
+
+    if(corpus == NULL) return NULL;
+
+    corpus->keys = (char *)malloc(count * CORPUS_KEY_LENGTH);
+
+    if(corpus->keys == NULL)
+    {
+        free(corpus);
+        return NULL;
+    }
+
+    snprintf(corpus->name, sizeof(corpus->name), "%s", name);
+
+    return corpus;
+}
+
+/**
+ * @brief Frees a corpus
+ * 
+ * @param corpus - the corpus, may be NULL
+ */
+static void corpus_destroy(corpus_t* corpus)
+{
+    if(corpus == NULL) return;
+
+    free(corpus->keys);
+    free(corpus);
+}
+
+/**
+ * @brief Generates CORPUS_KEYS keys shaped like one kind of real keys
+ * @details Sequential ids, UUIDs, URLs, file paths and IPv4 addresses. The sequential ones differ in only a few
+ * low bytes, which is where weak hashes cluster.
+ * 
+ * @param kind - 0 to 4
+ * @return corpus_t* - NULL if memory ran out
+ */
+static corpus_t* corpus_generate(int kind)
+{
+    static const char* names[] = { "sequential ids", "uuids", "urls", "file paths", "ipv4 addresses" };
+    corpus_t* corpus = corpus_create(names[kind], CORPUS_KEYS);
+    uint64_t state = SEED + (uint64_t)kind;
+
+    if(corpus == NULL) return NULL;
+
+    for(size_t i = 0; i < CORPUS_KEYS; i++)
+    {
+        char* key = corpus->keys + i * CORPUS_KEY_LENGTH;
+        uint64_t r1 = next_random(&state);
+        uint64_t r2 = next_random(&state);
+
+        switch(kind)
+        {
+            case 0:
+                snprintf(key, CORPUS_KEY_LENGTH, "user:%zu", i);
+                break;
+            case 1:
+                snprintf(key, CORPUS_KEY_LENGTH, "%08x-%04x-4%03x-%04x-%012llx", (unsigned int)r1, (unsigned int)(r1 >> 32) & 0xffff,
+                         (unsigned int)(r1 >> 48) & 0xfff, (unsigned int)(0x8000 | (r2 & 0x3fff)), (unsigned long long)(r2 >> 16));
+                break;
+            case 2:
+                snprintf(key, CORPUS_KEY_LENGTH, "https://www.example.com/catalog/%u/item?id=%zu&ref=%u", (unsigned int)(r1 % 500),
+                         i, (unsigned int)(r2 % 16));
+                break;
+            case 3:
+                snprintf(key, CORPUS_KEY_LENGTH, "/home/user%u/projects/src/module_%u/file_%zu.c", (unsigned int)(r1 % 8),
+                         (unsigned int)(r2 % 200), i);
+                break;
+            default:
+                snprintf(key, CORPUS_KEY_LENGTH, "10.%zu.%zu.%zu", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+                break;
+        }
+    }
+
+    corpus->count = CORPUS_KEYS;
+
+    return corpus;
+}
+
+/**
+ * @brief Reads a corpus from a file with one key per line, dropping empty lines and duplicates of the line before
+ * 
+ * @param path - the file
+ * @return corpus_t* - NULL if it could not be read or holds no keys
+ */
+static corpus_t* corpus_load(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    corpus_t* corpus = NULL;
+    char line[CORPUS_KEY_LENGTH];
+    size_t capacity = 1024;
+
+    if(file == NULL) return NULL;
+
+    corpus = corpus_create(path, capacity);
+
+    while(corpus != NULL && fgets(line, sizeof(line), file) != NULL)
+    {
+        char* key = NULL;
+
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if(line[0] == '\0') continue;
+        if(corpus->count > 0 && strcmp(line, corpus->keys + (corpus->count - 1) * CORPUS_KEY_LENGTH) == 0) continue;
+
+        if(corpus->count == capacity)
+        {
+            char* keys = (char *)realloc(corpus->keys, capacity * 2 * CORPUS_KEY_LENGTH);
+
+            if(keys == NULL) break;
+
+            corpus->keys = keys;
+            capacity *= 2;
+        }
+
+        key = corpus->keys + corpus->count++ * CORPUS_KEY_LENGTH;
+        memcpy(key, line, strlen(line) + 1);
+    }
+
+    fclose(file);
+
+    if(corpus != NULL && corpus->count == 0)
+    {
+        corpus_destroy(corpus);
+        return NULL;
+    }
+
+    return corpus;
+}
+
+/**
+ * @brief Prints the chi-squared results of every variant for a corpus
+ * 
+ * @param corpus - the keys
+ * @param failed - set for each variant that failed
+ */
+static void report_corpus(const corpus_t* corpus, int* failed)
+{
+    const char* function_name = "hashmap_hashbench():";
+
+    // Small corpora get fewer buckets so each still expects a few keys
+    size_t power = POWER_BUCKETS;
+    size_t prime = PRIME_BUCKETS;
+
+    while(power > 16 && corpus->count / power < 2)
+    {
+        power /= 2;
+        prime = power - 1;
+    }
+
+    printf("%s %s, %zu keys, %zu and %zu buckets\n", function_name, corpus->name, corpus->count, power, prime);
+
+    for(size_t v = 0; v < VARIANT_COUNT; v++)
+    {
+        double power_z = chi_squared(&variants[v], corpus, power);
+        double prime_z = chi_squared(&variants[v], corpus, prime);
+        int pass = power_z <= CHI_SQUARED_LIMIT && prime_z <= CHI_SQUARED_LIMIT;
+
+        printf("    %-24s chi-squared z %8.2f (power of two) %8.2f (odd)  %s\n", variants[v].name, power_z, prime_z, pass ? "ok" : "FAIL");
+        if(!pass) failed[v] = 1;
+    }
+}
+
+/**
+ * @brief Entry point for the hash benchmark
+ * @details Usage: hashmap_hashbench [corpus files...]. Exits with 1 if a variant failed a quality test.
+ * 
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char** argv)
+{
+    const char* function_name = "hashmap_hashbench():";
+    static const size_t avalanche_lengths[] = { 4, 16, 64 };
+    int failed[VARIANT_COUNT] = {0};
+    int any_failed = 0;
+
+    bench_throughput();
+
+    printf("%s avalanche, worst flip bias over every input and output bit of %d random keys\n", function_name, AVALANCHE_TRIALS);
+
+    for(size_t v = 0; v < VARIANT_COUNT; v++)
+    {
+        printf("    %-24s", variants[v].name);
+
+        for(size_t l = 0; l < sizeof(avalanche_lengths) / sizeof(avalanche_lengths[0]); l++)
+        {
+            double bias = 0;
+            double z = avalanche(&variants[v], avalanche_lengths[l], &bias);
+
+            printf(" %2zuB %6.2f%% (z %5.2f)", avalanche_lengths[l], bias * 100, z);
+            // A test that could not run is not a pass
+            if(!(z <= AVALANCHE_LIMIT)) failed[v] = 1;
+        }
+
+        printf("  %s\n", failed[v] ? "FAIL" : "ok");
+    }
+
+    for(int kind = 0; kind < 5; kind++)
+    {
+        corpus_t* corpus = corpus_generate(kind);
+
+        if(corpus == NULL) continue;
+
+        report_corpus(corpus, failed);
+        corpus_destroy(corpus);
+    }
+
+    for(int arg = 1; arg < argc; arg++)
+    {
+        corpus_t* corpus = corpus_load(argv[arg]);
+
+        if(corpus == NULL)
+        {
+            printf("%s %s skipped, no keys could be read\n", function_name, argv[arg]);
+            continue;
+        }
+
+        report_corpus(corpus, failed);
+        corpus_destroy(corpus);
+    }
+
+    for(size_t v = 0; v < VARIANT_COUNT; v++)
+    {
+        if(failed[v]) printf("%s %s failed a quality test\n", function_name, variants[v].name);
+        any_failed |= failed[v];
+    }
+
+    return any_failed;
+}
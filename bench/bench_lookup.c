@@ -0,0 +1,169 @@
+/**
+ * @file bench_lookup.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Measures random lookup latency on large maps for each bucket array placement
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hashmap.h"
+#include "hashmap_u64.h"
+
+#define DEFAULT_ENTRIES 2000000
+#define LOOKUPS         5000000
+#define KEY_LENGTH      24
+
+/**
+ * @brief A bucket array placement to measure
+ * 
+ */
+typedef struct
+{
+    const char* name;
+    hashmap_config_t config;
+}placement_t;
+
+static const placement_t placements[] =
+{
+    { "calloc",             { HASHMAP_FLAG_NONE, 0, NULL } },
+    { "hugepage",           { HASHMAP_FLAG_HUGEPAGE, 0, NULL } },
+    { "hugetlb",            { HASHMAP_FLAG_HUGETLB, 0, NULL } },
+    { "numa-interleave",    { HASHMAP_FLAG_NUMA_INTERLEAVE, 0, NULL } },
+    { "hugepage+interleave",{ HASHMAP_FLAG_HUGEPAGE | HASHMAP_FLAG_NUMA_INTERLEAVE, 0, NULL } },
+};
+
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds
+ * 
+ * @return double 
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Small xorshift generator so every placement sees the same lookup order
+ * 
+ * @param state - generator state
+ * @return unsigned long long 
+ */
+static unsigned long long next_random(unsigned long long* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/**
+ * @brief Measures random lookups on an integer keyed map of the same size
+ * 
+ * @param entries - number of keys
+ */
+static void bench_u64(size_t entries)
+{
+    const char* function_name = "hashmap_bench():";
+    hashmap_u64_t* map = hashmap_u64_create(entries);
+    unsigned long long state = 0x9e3779b97f4a7c15ULL;
+    size_t found = 0;
+    double start = 0;
+    int value = 1;
+
+    if(map == NULL) return;
+
+    for(size_t i = 0; i < entries; i++)
+    {
+        hashmap_u64_push(map, i, &value);
+    }
+
+    start = now_ns();
+
+    for(size_t i = 0; i < LOOKUPS; i++)
+    {
+        if(hashmap_u64_get(map, next_random(&state) % entries) != NULL) found++;
+    }
+
+    printf("%s %-20s %8.1f ns/lookup (%zu hits)\n", function_name, "hashmap_u64", (now_ns() - start) / LOOKUPS, found);
+
+    hashmap_u64_destroy(map, NULL);
+}
+
+/**
+ * @brief Entry point for the lookup benchmark
+ * @details Usage: hashmap_bench [entries]. The map capacity equals the entry count so chains stay short and
+ * the measurement is dominated by the bucket array access.
+ * 
+ * @param argc 
+ * @param argv 
+ * @return int 
+ */
+int main(int argc, char** argv)
+{
+    const char* function_name = "hashmap_bench():";
+    size_t entries = (argc > 1) ? strtoull(argv[1], NULL, 10) : DEFAULT_ENTRIES;
+    char* keys = NULL;
+    int value = 1;
+
+    if(entries == 0) return -1;
+
+    keys = (char *)malloc(entries * KEY_LENGTH);
+    if(keys == NULL) return -1;
+
+    for(size_t i = 0; i < entries; i++)
+    {
+        snprintf(keys + i * KEY_LENGTH, KEY_LENGTH, "user:%zu", i);
+    }
+
+    printf("%s %zu entries, %d random lookups\n", function_name, entries, LOOKUPS);
+
+    for(size_t p = 0; p < sizeof(placements) / sizeof(placements[0]); p++)
+    {
+        hashmap_t* map = hashmap_create_ex(entries, &placements[p].config);
+        unsigned long long state = 0x9e3779b97f4a7c15ULL;
+        size_t found = 0;
+        double start = 0;
+        double elapsed = 0;
+
+        if(map == NULL)
+        {
+            printf("%s %-20s skipped (%s)\n", function_name, placements[p].name, hashmap_strerror());
+            continue;
+        }
+
+        for(size_t i = 0; i < entries; i++)
+        {
+            hashmap_push(map, keys + i * KEY_LENGTH, &value);
+        }
+
+        start = now_ns();
+
+        for(size_t i = 0; i < LOOKUPS; i++)
+        {
+            if(hashmap_get(map, keys + (next_random(&state) % entries) * KEY_LENGTH) != NULL) found++;
+        }
+
+        elapsed = now_ns() - start;
+        printf("%s %-20s %8.1f ns/lookup (%zu hits)\n", function_name, placements[p].name, elapsed / LOOKUPS, found);
+
+        hashmap_destroy(map, NULL);
+    }
+
+    bench_u64(entries);
+    free(keys);
+
+    return 0;
+}
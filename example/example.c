@@ -34,7 +34,9 @@ void freeAccount(void* acc);
 int main(void)
 {
     const char* function_name = "hashmap_example():";
-    hashmap_t* map = hashmap_create(3);
+    // Each key is the account's own email, which lives as long as the account, so the map can borrow it instead of copying
+    hashmap_config_t config = { HASHMAP_FLAG_BORROW_KEYS, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(3, &config);
 
     if(map == NULL || setupAndAddAccounts(map) == ERROR) return -1;
 
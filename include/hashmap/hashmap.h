@@ -17,9 +17,16 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 
 typedef void (*free_value_fn_t)(void *);
+typedef void (*hashmap_foreach_fn_t)(const char* key, void* value, void* ctx);
+typedef size_t (*hashmap_encode_fn_t)(const void* value, void* buf, size_t space);    // Writes value to buf if it fits, returns its size
+typedef void* (*hashmap_decode_fn_t)(const void* bytes, size_t len);                 // Returns a new value made from encoded bytes
+typedef void (*hashmap_task_fn_t)(void* arg);
+typedef void (*hashmap_executor_fn_t)(hashmap_task_fn_t task, void* arg, void* ctx);  // Runs task(arg) on another thread
 typedef struct hashmap hashmap_t;
+typedef struct hashmap_intern hashmap_intern_t;
 typedef int STATUS;
 
 #define SUCCESS 0
@@ -36,17 +43,108 @@ typedef enum HASHMAP_ERROR_TYPE
     HASHMAP_ERR_NULL_ARG,         // Null argument provided
     HASHMAP_ERR_ALLOC_FAILED,     // Memory allocation failed
     HASHMAP_ERR_NOT_FOUND,        // Key provided not found in the map
-    HASHMAP_ERR_DUPLICATE         // Key given is already in hashmap
+    HASHMAP_ERR_DUPLICATE,        // Key given is already in hashmap
+    HASHMAP_ERR_INVALID_CONFIG,   // Invalid or unsupported creation option given
+    HASHMAP_ERR_READ_ONLY,        // Map is a read-only snapshot
+    HASHMAP_ERR_CONFLICT,         // Value did not match the expected one
+    HASHMAP_ERR_IO                // Reading or writing a file failed
 }hashmap_err_t;
 
+/**
+ * @brief Creation flags for hashmap_config_t
+ * 
+ */
+typedef enum HASHMAP_FLAG_TYPE
+{
+    HASHMAP_FLAG_NONE             = 0,      // Default: bucket array comes from the heap, keys are copied
+    HASHMAP_FLAG_HUGEPAGE         = 1 << 0, // Back the bucket array with mmap() + MADV_HUGEPAGE (transparent huge pages)
+    HASHMAP_FLAG_HUGETLB          = 1 << 1, // Back the bucket array with explicit 2MB pages (MAP_HUGETLB), falls back to HASHMAP_FLAG_HUGEPAGE
+    HASHMAP_FLAG_NUMA_INTERLEAVE  = 1 << 2, // Interleave the bucket array pages across all online NUMA nodes
+    HASHMAP_FLAG_NUMA_BIND        = 1 << 3, // Bind the bucket array pages to hashmap_config_t.numa_node
+    HASHMAP_FLAG_SIPHASH          = 1 << 4, // Hash keys with keyed SipHash-1-3 instead of Murmur3
+    HASHMAP_FLAG_BORROW_KEYS      = 1 << 5, // Store the caller's key pointers, which must outlive their entries
+    HASHMAP_FLAG_BLOOM            = 1 << 6, // Keep a Bloom filter of the keys so most lookups of missing keys skip the buckets
+    HASHMAP_FLAG_MULTI            = 1 << 7, // Multimap: pushing a key again adds another value instead of failing
+    HASHMAP_FLAG_ORDERED          = 1 << 8  // Keep an ordered index of the keys for hashmap_prefix_scan() and hashmap_range_scan()
+}hashmap_flag_t;
+
+/**
+ * @brief Optional creation parameters for hashmap_create_ex()
+ * 
+ */
+typedef struct HASHMAP_CONFIG
+{
+    unsigned int flags; // OR of hashmap_flag_t values
+    int numa_node;      // Node used with HASHMAP_FLAG_NUMA_BIND
+    hashmap_intern_t* intern;   // Optional pool the keys are interned into instead of being copied
+}hashmap_config_t;
+
+/**
+ * @brief Statistics filled by hashmap_stats()
+ * 
+ */
+typedef struct HASHMAP_STATS
+{
+    size_t size;            // Number of keys in the map
+    size_t capacity;        // Number of buckets
+    size_t used_buckets;    // Number of buckets holding at least one key
+    size_t max_chain;       // Number of keys in the fullest bucket
+}hashmap_stats_t;
+
+/**
+ * @brief Options for the parallel bulk operations. Pass NULL for the defaults.
+ * 
+ */
+typedef struct HASHMAP_PARALLEL
+{
+    size_t threads;                 // Threads to split the work over, the caller's included. 0 for one per online CPU.
+    hashmap_executor_fn_t executor; // Optional, runs the other threads' share instead of the library's pool
+    void* executor_ctx;             // Passed through to executor
+}hashmap_parallel_t;
+
+/**
+ * @brief Position of hashmap_iter_next() in a map. Zero it to start from the first pair.
+ * 
+ */
+typedef struct HASHMAP_ITER
+{
+    size_t bucket;          // Bucket being walked
+    size_t pos;             // Position in the bucket
+    const void* entry;      // Entry returned last, NULL before the bucket's first one
+    size_t value_idx;       // Next value of entry to return
+}hashmap_iter_t;
+
 hashmap_t* hashmap_create(size_t size);
+hashmap_t* hashmap_create_ex(size_t size, const hashmap_config_t* config);
 void hashmap_destroy(hashmap_t* map, free_value_fn_t func);
+void hashmap_destroy_parallel(hashmap_t* map, free_value_fn_t func, const hashmap_parallel_t* parallel);
+void hashmap_destroy_deferred(hashmap_t* map, free_value_fn_t func);
+void hashmap_deferred_wait(void);
 STATUS hashmap_push(hashmap_t* map, const char* key, void* value);
 void* hashmap_get(const hashmap_t* map, const char* key);
+void* hashmap_get_n(const hashmap_t* map, const char* key, size_t len);
+void hashmap_prefetch(const hashmap_t* map, const char* key);
+STATUS hashmap_get_all(const hashmap_t* map, const char* key, void* const** values, size_t* count);
 STATUS hashmap_delete(hashmap_t* map, const char* key, free_value_fn_t func);
-void hashmap_set_seed(hashmap_t* map, size_t seed);
+STATUS hashmap_delete_value(hashmap_t* map, const char* key, void* value, free_value_fn_t func);
+STATUS hashmap_clear(hashmap_t* map, free_value_fn_t fn);
+STATUS hashmap_clear_parallel(hashmap_t* map, free_value_fn_t fn, const hashmap_parallel_t* parallel);
+STATUS hashmap_reserve(hashmap_t* map, size_t capacity);
+STATUS hashmap_reserve_parallel(hashmap_t* map, size_t capacity, const hashmap_parallel_t* parallel);
+hashmap_t* hashmap_snapshot(hashmap_t* map);
+void hashmap_set_seed(hashmap_t* map, uint64_t seed);
+STATUS hashmap_stats(const hashmap_t* map, hashmap_stats_t* stats);
+STATUS hashmap_stats_parallel(const hashmap_t* map, hashmap_stats_t* stats, const hashmap_parallel_t* parallel);
+size_t hashmap_size(const hashmap_t* map);
+STATUS hashmap_foreach(const hashmap_t* map, hashmap_foreach_fn_t fn, void* ctx);
+STATUS hashmap_foreach_parallel(const hashmap_t* map, hashmap_foreach_fn_t fn, void* ctx, const hashmap_parallel_t* parallel);
+STATUS hashmap_iter_next(const hashmap_t* map, hashmap_iter_t* iter, const char** key, void** value);
+STATUS hashmap_iter_seek(const hashmap_t* map, const char* key, size_t len, hashmap_iter_t* iter);
+STATUS hashmap_prefix_scan(const hashmap_t* map, const char* prefix, hashmap_foreach_fn_t fn, void* ctx);
+STATUS hashmap_range_scan(const hashmap_t* map, const char* low, const char* high, hashmap_foreach_fn_t fn, void* ctx);
 hashmap_err_t hashmap_errno(void);
 const char* hashmap_strerror(void);
+const char* hashmap_err_str(hashmap_err_t err);
 
 #ifdef __cplusplus
 }
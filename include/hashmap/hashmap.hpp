@@ -0,0 +1,384 @@
+/**
+ * @file hashmap.hpp
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Header-only C++17 wrapper owning a hashmap_t and values of one type
+ * @details chm::hashmap<T> is move-only and destroys its values with the map. Every value lives in a node
+ * together with its key bytes and the map is created with HASHMAP_FLAG_BORROW_KEYS, so a pair costs one
+ * allocation and the key is copied once. Lookups take a std::string_view and hash it in place through
+ * hashmap_get_n() without building a NUL terminated copy. Iterators are forward iterators over
+ * std::pair<const std::string_view, T>, usable with range-for and the standard algorithms, parallel ones
+ * included. Like hashmap_t, the map is not thread safe for writers.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_HPP
+#define _C_HASH_MAP_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "hashmap.h"
+
+namespace chm
+{
+
+/**
+ * @brief Thrown when the C library reports an error other than a failed allocation
+ * 
+ */
+class error : public std::runtime_error
+{
+public:
+    explicit error(hashmap_err_t code) : std::runtime_error(hashmap_err_str(code)), code_(code) {}
+
+    hashmap_err_t code() const noexcept { return code_; }
+
+private:
+    hashmap_err_t code_;    // Error reported by the library
+};
+
+/**
+ * @brief Hashmap from string keys to values of type T
+ * 
+ * @tparam T - type of the values
+ */
+template <typename T>
+class hashmap
+{
+public:
+    using key_type = std::string_view;
+    using mapped_type = T;
+    using value_type = std::pair<const std::string_view, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    /**
+     * @brief Forward iterator over the pairs, in the order of hashmap_foreach()
+     * @details Any push or erase invalidates every iterator
+     *
+     * @tparam Const - true for const_iterator
+     */
+    template <bool Const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename hashmap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        basic_iterator() noexcept = default;
+
+        /**
+         * @brief Converts an iterator to a const_iterator
+         *
+         */
+        template <bool Other, typename = std::enable_if_t<Const && !Other>>
+        basic_iterator(const basic_iterator<Other>& other) noexcept
+            : map_(other.map_), cursor_(other.cursor_), node_(other.node_), seeked_(other.seeked_) {}
+
+        reference operator*() const noexcept { return *node_; }
+        pointer operator->() const noexcept { return node_; }
+
+        basic_iterator& operator++() noexcept
+        {
+            void* value = nullptr;
+
+            // Iterators made from a lookup only find their place in the buckets once they are advanced
+            if(!seeked_) hashmap_iter_seek(map_, node_->first.data(), node_->first.size(), &cursor_);
+            seeked_ = true;
+
+            node_ = (hashmap_iter_next(map_, &cursor_, nullptr, &value) == SUCCESS) ? static_cast<value_type*>(value) : nullptr;
+
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            basic_iterator previous = *this;
+
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.node_ == b.node_; }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept { return a.node_ != b.node_; }
+
+    private:
+        friend class hashmap;
+        template <bool> friend class basic_iterator;
+
+        /**
+         * @brief Iterator at the first pair of map, or end() if it is empty
+         *
+         * @param map - the map, may be NULL
+         */
+        explicit basic_iterator(const hashmap_t* map) noexcept : map_(map)
+        {
+            void* value = nullptr;
+
+            if(map_ != nullptr && hashmap_iter_next(map_, &cursor_, nullptr, &value) == SUCCESS)
+            {
+                node_ = static_cast<value_type*>(value);
+            }
+        }
+
+        /**
+         * @brief Iterator at a pair found by a lookup
+         *
+         * @param map - the map
+         * @param node - the pair, NULL for end()
+         */
+        basic_iterator(const hashmap_t* map, value_type* node) noexcept : map_(map), node_(node), seeked_(false) {}
+
+        const hashmap_t* map_ = nullptr;    // The map
+        hashmap_iter_t cursor_ = {};        // Position of node_ in the map
+        value_type* node_ = nullptr;        // Current pair, NULL at the end
+        bool seeked_ = true;                // Set once cursor_ matches node_
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    /**
+     * @brief Creates an empty map
+     *
+     * @param capacity - number of buckets, as for hashmap_create()
+     * @param flags - OR of hashmap_flag_t values. HASHMAP_FLAG_MULTI is not supported, HASHMAP_FLAG_BORROW_KEYS is
+     * always added.
+     */
+    explicit hashmap(size_type capacity = 64, unsigned int flags = HASHMAP_FLAG_NONE)
+    {
+        hashmap_config_t config = { flags | HASHMAP_FLAG_BORROW_KEYS, 0, nullptr };
+
+        if(flags & HASHMAP_FLAG_MULTI) throw error(HASHMAP_ERR_INVALID_CONFIG);
+
+        map_ = hashmap_create_ex(capacity, &config);
+        if(map_ == nullptr) raise(hashmap_errno());
+    }
+
+    ~hashmap() { hashmap_destroy(map_, node_destroy); }
+
+    hashmap(const hashmap&) = delete;
+    hashmap& operator=(const hashmap&) = delete;
+
+    hashmap(hashmap&& other) noexcept : map_(std::exchange(other.map_, nullptr)) {}
+
+    hashmap& operator=(hashmap&& other) noexcept
+    {
+        if(this != &other)
+        {
+            hashmap_destroy(map_, node_destroy);
+            map_ = std::exchange(other.map_, nullptr);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Constructs a value from args under key, unless key is already in the map
+     * @details Nothing is constructed when the key is found
+     *
+     * @param key - the key, without NUL bytes
+     * @param args - arguments for T's constructor
+     * @return std::pair<iterator, bool> - the pair of key, and whether it was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(std::string_view key, Args&&... args)
+    {
+        value_type* node = find_node(key);
+
+        if(node != nullptr) return { iterator(map_, node), false };
+
+        if(std::memchr(key.data(), '\0', key.size()) != nullptr) throw std::invalid_argument("key holds a NUL byte");
+
+        node = node_create(key, std::forward<Args>(args)...);
+
+        if(hashmap_push(map_, node->first.data(), node) == ERROR)
+        {
+            hashmap_err_t err = hashmap_errno();
+
+            node_destroy(node);
+            raise(err);
+        }
+
+        return { iterator(map_, node), true };
+    }
+
+    /**
+     * @brief Assigns value to key if it is in the map, inserts it otherwise
+     *
+     * @param key - the key, without NUL bytes
+     * @param value - value to assign or construct from
+     * @return std::pair<iterator, bool> - the pair of key, and whether it was inserted
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(std::string_view key, M&& value)
+    {
+        value_type* node = find_node(key);
+
+        if(node == nullptr) return try_emplace(key, std::forward<M>(value));
+
+        node->second = std::forward<M>(value);
+
+        return { iterator(map_, node), false };
+    }
+
+    /**
+     * @brief Returns the value of key, default constructing it if the key is not in the map
+     *
+     * @param key - the key, without NUL bytes
+     * @return T&
+     */
+    T& operator[](std::string_view key) { return try_emplace(key).first->second; }
+
+    /**
+     * @brief Returns the value of key
+     *
+     * @param key - the key
+     * @return T& - throws std::out_of_range if the key is not in the map
+     */
+    T& at(std::string_view key)
+    {
+        value_type* node = find_node(key);
+
+        if(node == nullptr) throw std::out_of_range("key not found");
+
+        return node->second;
+    }
+
+    const T& at(std::string_view key) const { return const_cast<hashmap *>(this)->at(key); }
+
+    iterator find(std::string_view key) noexcept { return iterator(map_, find_node(key)); }
+    const_iterator find(std::string_view key) const noexcept { return const_iterator(map_, find_node(key)); }
+    bool contains(std::string_view key) const noexcept { return find_node(key) != nullptr; }
+    size_type count(std::string_view key) const noexcept { return contains(key) ? 1 : 0; }
+
+    /**
+     * @brief Removes key and destroys its value
+     *
+     * @param key - the key
+     * @return size_type - 1 if the key was removed, 0 if it was not in the map
+     */
+    size_type erase(std::string_view key) noexcept
+    {
+        value_type* node = find_node(key);
+
+        // The node's own key is NUL terminated, and the map is done with it before node_destroy() runs
+        if(node == nullptr || hashmap_delete(map_, node->first.data(), node_destroy) == ERROR) return 0;
+
+        return 1;
+    }
+
+    /**
+     * @brief Removes every pair and destroys the values
+     *
+     */
+    void clear() noexcept { hashmap_clear(map_, node_destroy); }
+
+    /**
+     * @brief Grows the map to at least capacity buckets
+     *
+     * @param capacity - number of buckets wanted
+     */
+    void reserve(size_type capacity)
+    {
+        if(hashmap_reserve(map_, capacity) == ERROR) raise(hashmap_errno());
+    }
+
+    size_type size() const noexcept { return hashmap_size(map_); }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    iterator begin() noexcept { return iterator(map_); }
+    iterator end() noexcept { return iterator(); }
+    const_iterator begin() const noexcept { return const_iterator(map_); }
+    const_iterator end() const noexcept { return const_iterator(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+private:
+    hashmap_t* map_ = nullptr;  // The C map, values are value_type nodes
+
+    /**
+     * @brief Returns the node of key
+     *
+     * @param key - the key
+     * @return value_type* - NULL if not found
+     */
+    value_type* find_node(std::string_view key) const noexcept
+    {
+        if(map_ == nullptr) return nullptr;
+
+        return static_cast<value_type*>(hashmap_get_n(map_, key.data(), key.size()));
+    }
+
+    /**
+     * @brief Allocates a node with the key bytes after the pair and constructs the value in place
+     *
+     * @param key - the key
+     * @param args - arguments for T's constructor
+     * @return value_type* - throws if allocation or T's constructor does
+     */
+    template <typename... Args>
+    static value_type* node_create(std::string_view key, Args&&... args)
+    {
+        void* raw = ::operator new(sizeof(value_type) + key.size() + 1, std::align_val_t(alignof(value_type)));
+        char* bytes = static_cast<char*>(raw) + sizeof(value_type);
+
+        std::memcpy(bytes, key.data(), key.size());
+        bytes[key.size()] = '\0';
+
+        try
+        {
+            return ::new(raw) value_type(std::piecewise_construct, std::forward_as_tuple(bytes, key.size()),
+                                         std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        catch(...)
+        {
+            ::operator delete(raw, std::align_val_t(alignof(value_type)));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Destroys a node made by node_create(), passed to the C library as its free function
+     *
+     * @param node - the node
+     */
+    static void node_destroy(void* node) noexcept
+    {
+        static_cast<value_type*>(node)->~value_type();
+        ::operator delete(node, std::align_val_t(alignof(value_type)));
+    }
+
+    /**
+     * @brief Throws the exception matching a library error
+     *
+     * @param err - the error
+     */
+    [[noreturn]] static void raise(hashmap_err_t err)
+    {
+        if(err == HASHMAP_ERR_ALLOC_FAILED) throw std::bad_alloc();
+
+        throw error(err);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file hashmap_compact.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the compact, insertion ordered hashmap
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_COMPACT_H
+#define _C_HASH_MAP_COMPACT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashmap_compact hashmap_compact_t;
+
+hashmap_compact_t* hashmap_compact_create(size_t capacity);
+void hashmap_compact_destroy(hashmap_compact_t* map, free_value_fn_t func);
+STATUS hashmap_compact_push(hashmap_compact_t* map, const char* key, void* value);
+void* hashmap_compact_get(const hashmap_compact_t* map, const char* key);
+STATUS hashmap_compact_delete(hashmap_compact_t* map, const char* key, free_value_fn_t func);
+size_t hashmap_compact_size(const hashmap_compact_t* map);
+STATUS hashmap_compact_next(const hashmap_compact_t* map, size_t* cursor, const char** key, void** value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
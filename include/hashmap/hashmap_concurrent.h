@@ -0,0 +1,39 @@
+/**
+ * @file hashmap_concurrent.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the hashmap that can be shared between threads
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_CONCURRENT_H
+#define _C_HASH_MAP_CONCURRENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashmap_concurrent hashmap_concurrent_t;
+typedef void* (*hashmap_compute_fn_t)(const char* key, void* value, void* ctx);
+
+hashmap_concurrent_t* hashmap_concurrent_create(size_t capacity);
+void hashmap_concurrent_destroy(hashmap_concurrent_t* map, free_value_fn_t func);
+STATUS hashmap_concurrent_push(hashmap_concurrent_t* map, const char* key, void* value);
+void* hashmap_concurrent_get(hashmap_concurrent_t* map, const char* key);
+STATUS hashmap_concurrent_delete(hashmap_concurrent_t* map, const char* key, free_value_fn_t func);
+STATUS hashmap_concurrent_cas_value(hashmap_concurrent_t* map, const char* key, void** expected, void* desired);
+STATUS hashmap_concurrent_fetch_add_u64(hashmap_concurrent_t* map, const char* key, uint64_t delta, uint64_t* previous);
+STATUS hashmap_concurrent_compute(hashmap_concurrent_t* map, const char* key, hashmap_compute_fn_t fn, void* ctx);
+size_t hashmap_concurrent_size(hashmap_concurrent_t* map);
+size_t hashmap_concurrent_capacity(hashmap_concurrent_t* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file hashmap_frozen.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the immutable, perfectly hashed hashmap made by hashmap_freeze()
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_FROZEN_H
+#define _C_HASH_MAP_FROZEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashmap_frozen hashmap_frozen_t;
+
+hashmap_frozen_t* hashmap_freeze(const hashmap_t* map);
+void hashmap_frozen_destroy(hashmap_frozen_t* map, free_value_fn_t func);
+void* hashmap_frozen_get(const hashmap_frozen_t* map, const char* key);
+size_t hashmap_frozen_size(const hashmap_frozen_t* map);
+STATUS hashmap_frozen_foreach(const hashmap_frozen_t* map, hashmap_foreach_fn_t fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file hashmap_intern.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the key intern pool shared between hashmaps
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_INTERN_H
+#define _C_HASH_MAP_INTERN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+hashmap_intern_t* hashmap_intern_create(void);
+void hashmap_intern_destroy(hashmap_intern_t* pool);
+size_t hashmap_intern_size(hashmap_intern_t* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file hashmap_sharded.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the hashmap split into independently locked shards
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_SHARDED_H
+#define _C_HASH_MAP_SHARDED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashmap_sharded hashmap_sharded_t;
+
+hashmap_sharded_t* hashmap_sharded_create(size_t shard_count, size_t shard_capacity);
+void hashmap_sharded_destroy(hashmap_sharded_t* map, free_value_fn_t func);
+STATUS hashmap_sharded_push(hashmap_sharded_t* map, const char* key, void* value);
+void* hashmap_sharded_get(hashmap_sharded_t* map, const char* key);
+STATUS hashmap_sharded_delete(hashmap_sharded_t* map, const char* key, free_value_fn_t func);
+size_t hashmap_sharded_size(hashmap_sharded_t* map);
+size_t hashmap_sharded_shard_count(const hashmap_sharded_t* map);
+STATUS hashmap_sharded_foreach(hashmap_sharded_t* map, hashmap_foreach_fn_t fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file hashmap_shm.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the shared memory hashmap, one map in a POSIX shared memory segment used by several processes
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_SHM_H
+#define _C_HASH_MAP_SHM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashmap_shm hashmap_shm_t;
+
+hashmap_shm_t* hashmap_shm_create(const char* name, size_t capacity, size_t bytes);
+hashmap_shm_t* hashmap_shm_open(const char* name);
+STATUS hashmap_shm_close(hashmap_shm_t* map);
+STATUS hashmap_shm_unlink(const char* name);
+STATUS hashmap_shm_push(hashmap_shm_t* map, const char* key, const void* value, size_t len);
+STATUS hashmap_shm_set(hashmap_shm_t* map, const char* key, const void* value, size_t len);
+const void* hashmap_shm_get(const hashmap_shm_t* map, const char* key, size_t* len);
+STATUS hashmap_shm_delete(hashmap_shm_t* map, const char* key);
+size_t hashmap_shm_size(const hashmap_shm_t* map);
+size_t hashmap_shm_free_bytes(const hashmap_shm_t* map);
+hashmap_shm_t* hashmap_shm_compact(hashmap_shm_t* map, const char* name, size_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
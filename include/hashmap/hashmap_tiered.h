@@ -0,0 +1,54 @@
+/**
+ * @file hashmap_tiered.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the tiered hashmap, which spills its coldest pairs to a file on disk
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_TIERED_H
+#define _C_HASH_MAP_TIERED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashmap_tiered hashmap_tiered_t;
+
+// Called with the value of a key looked up by hashmap_tiered_get_async(), NULL if the key is not in the map
+typedef void (*hashmap_tiered_fn_t)(const char* key, void* value, void* ctx);
+
+/**
+ * @brief Options for hashmap_tiered_create()
+ * 
+ */
+typedef struct HASHMAP_TIERED_CONFIG
+{
+    size_t hot_limit;           // Pairs kept in memory, the least recently used past this are written to disk
+    unsigned int queue_depth;   // Disk reads that can be in flight at once, 0 for 256
+    hashmap_encode_fn_t encode; // Turns a value into bytes for the disk
+    hashmap_decode_fn_t decode; // Turns bytes from the disk back into a value
+    free_value_fn_t free_value; // Optional, frees values that are deleted, written to disk or left at destroy
+}hashmap_tiered_config_t;
+
+hashmap_tiered_t* hashmap_tiered_create(const char* path, size_t capacity, const hashmap_tiered_config_t* config);
+void hashmap_tiered_destroy(hashmap_tiered_t* map);
+STATUS hashmap_tiered_push(hashmap_tiered_t* map, const char* key, void* value);
+void* hashmap_tiered_get(hashmap_tiered_t* map, const char* key);
+STATUS hashmap_tiered_get_async(hashmap_tiered_t* map, const char* key, hashmap_tiered_fn_t fn, void* ctx);
+size_t hashmap_tiered_poll(hashmap_tiered_t* map, size_t min_complete);
+STATUS hashmap_tiered_delete(hashmap_tiered_t* map, const char* key);
+size_t hashmap_tiered_size(const hashmap_tiered_t* map);
+size_t hashmap_tiered_cold_size(const hashmap_tiered_t* map);
+size_t hashmap_tiered_pending(const hashmap_tiered_t* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
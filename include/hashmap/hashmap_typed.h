@@ -0,0 +1,271 @@
+/**
+ * @file hashmap_typed.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Header-only generator for hashmaps specialized on their key and value types
+ * @details HASHMAP_DEFINE(name, key_type, value_type, hash_fn, eq_fn) expands to a name_t map type and static inline
+ * name_create(), name_destroy(), name_push(), name_get(), name_delete(), name_size() and name_foreach() functions.
+ * Keys and values are stored inline in an open addressed entry array, so there is no allocation per entry and
+ * hash_fn/eq_fn are called directly where the compiler can inline them. hash_fn takes a key_type and returns a
+ * uint64_t, eq_fn takes two key_type and returns non-zero when they are equal. Both can be functions or
+ * function-like macros, for example HASHMAP_TYPED_EQ for scalar keys.
+ * 
+ * Keys are stored as given: pointer keys such as strings are not copied and must outlive their entry.
+ * The generated functions report errors through their return values and never touch hashmap_errno().
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_TYPED_H
+#define _C_HASH_MAP_TYPED_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap.h"
+
+#define HASHMAP_TYPED_MIN_SLOTS 16  // Smallest entry array, must be a power of 2
+#define HASHMAP_TYPED_FULL 0x80     // Set in the control byte of an occupied slot, the low 7 bits hold a hash tag
+
+/**
+ * @brief Equality for keys that can be compared with ==
+ * 
+ */
+#define HASHMAP_TYPED_EQ(a, b) ((a) == (b))
+
+/**
+ * @brief Equality for NUL terminated string keys
+ * 
+ */
+#define HASHMAP_TYPED_STR_EQ(a, b) (strcmp((a), (b)) == 0)
+
+/**
+ * @brief Hash for integer keys (Murmur3 fmix64 finalizer)
+ * 
+ * @param key - the key
+ * @return uint64_t - the hash
+ */
+static inline uint64_t hashmap_typed_hash_u64(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+
+    return key;
+}
+
+/**
+ * @brief Hash for NUL terminated string keys (FNV-1a, finalized with fmix64 to spread the low bits)
+ * 
+ * @param key - the key
+ * @return uint64_t - the hash
+ */
+static inline uint64_t hashmap_typed_hash_str(const char* key)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    while(*key != '\0')
+    {
+        hash ^= (unsigned char)*key++;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hashmap_typed_hash_u64(hash);
+}
+
+/**
+ * @brief Generates a hashmap type and its functions for the given key and value types
+ * 
+ */
+#define HASHMAP_DEFINE(name, key_type, value_type, hash_fn, eq_fn)                                              \
+                                                                                                                \
+typedef struct name##_entry                                                                                     \
+{                                                                                                               \
+    key_type key;                                                                                               \
+    value_type value;                                                                                           \
+}name##_entry_t;                                                                                                \
+                                                                                                                \
+typedef struct name                                                                                             \
+{                                                                                                               \
+    size_t mask;                /* Number of slots - 1, the slot count is a power of 2 */                       \
+    size_t size;                /* Current number of keys in the map */                                         \
+    uint8_t* ctrl;              /* Control byte of each slot: 0 if empty, HASHMAP_TYPED_FULL | tag otherwise */ \
+    name##_entry_t* entries;    /* Key-value pairs, probed linearly */                                          \
+}name##_t;                                                                                                      \
+                                                                                                                \
+static inline uint8_t name##_tag(uint64_t hash)                                                                 \
+{                                                                                                               \
+    return (uint8_t)(HASHMAP_TYPED_FULL | (hash >> 57));                                                        \
+}                                                                                                               \
+                                                                                                                \
+static inline hashmap_err_t name##_alloc(name##_t* map, size_t slot_count)                                      \
+{                                                                                                               \
+    map->ctrl = (uint8_t *)calloc(slot_count, sizeof(uint8_t));                                                 \
+    map->entries = (name##_entry_t *)malloc(slot_count * sizeof(name##_entry_t));                               \
+                                                                                                                \
+    if(map->ctrl == NULL || map->entries == NULL)                                                               \
+    {                                                                                                           \
+        free(map->ctrl);                                                                                        \
+        free(map->entries);                                                                                     \
+        return HASHMAP_ERR_ALLOC_FAILED;                                                                        \
+    }                                                                                                           \
+                                                                                                                \
+    map->mask = slot_count - 1;                                                                                 \
+    return HASHMAP_ERR_NONE;                                                                                    \
+}                                                                                                               \
+                                                                                                                \
+static inline name##_t* name##_create(size_t capacity)                                                          \
+{                                                                                                               \
+    name##_t* map = (name##_t *)malloc(sizeof(name##_t));                                                       \
+    size_t slot_count = HASHMAP_TYPED_MIN_SLOTS;                                                                \
+                                                                                                                \
+    if(capacity > SIZE_MAX / sizeof(name##_entry_t) / 4)                                                        \
+    {                                                                                                           \
+        free(map);                                                                                              \
+        return NULL;                                                                                            \
+    }                                                                                                           \
+                                                                                                                \
+    /* Keep the load factor at or below 3/4 */                                                                  \
+    while(slot_count / 4 * 3 < capacity)                                                                        \
+    {                                                                                                           \
+        slot_count *= 2;                                                                                        \
+    }                                                                                                           \
+                                                                                                                \
+    if(map == NULL || name##_alloc(map, slot_count) != HASHMAP_ERR_NONE)                                        \
+    {                                                                                                           \
+        free(map);                                                                                              \
+        return NULL;                                                                                            \
+    }                                                                                                           \
+                                                                                                                \
+    map->size = 0;                                                                                              \
+    return map;                                                                                                 \
+}                                                                                                               \
+                                                                                                                \
+static inline void name##_destroy(name##_t* map)                                                                \
+{                                                                                                               \
+    if(map != NULL)                                                                                             \
+    {                                                                                                           \
+        free(map->ctrl);                                                                                        \
+        free(map->entries);                                                                                     \
+        free(map);                                                                                              \
+    }                                                                                                           \
+}                                                                                                               \
+                                                                                                                \
+static inline void name##_place(name##_t* map, uint64_t hash, const name##_entry_t* entry)                      \
+{                                                                                                               \
+    size_t slot_idx = (size_t)hash & map->mask;                                                                 \
+                                                                                                                \
+    while(map->ctrl[slot_idx] != 0)                                                                             \
+    {                                                                                                           \
+        slot_idx = (slot_idx + 1) & map->mask;                                                                  \
+    }                                                                                                           \
+                                                                                                                \
+    map->ctrl[slot_idx] = name##_tag(hash);                                                                     \
+    map->entries[slot_idx] = *entry;                                                                            \
+}                                                                                                               \
+                                                                                                                \
+static inline hashmap_err_t name##_grow(name##_t* map)                                                          \
+{                                                                                                               \
+    name##_t old = *map;                                                                                        \
+                                                                                                                \
+    if(name##_alloc(map, (old.mask + 1) * 2) != HASHMAP_ERR_NONE)                                               \
+    {                                                                                                           \
+        *map = old;                                                                                             \
+        return HASHMAP_ERR_ALLOC_FAILED;                                                                        \
+    }                                                                                                           \
+                                                                                                                \
+    for(size_t i = 0; i <= old.mask; i++)                                                                       \
+    {                                                                                                           \
+        if(old.ctrl[i] != 0) name##_place(map, hash_fn(old.entries[i].key), &old.entries[i]);                   \
+    }                                                                                                           \
+                                                                                                                \
+    free(old.ctrl);                                                                                             \
+    free(old.entries);                                                                                          \
+    return HASHMAP_ERR_NONE;                                                                                    \
+}                                                                                                               \
+                                                                                                                \
+static inline value_type* name##_get(const name##_t* map, key_type key)                                         \
+{                                                                                                               \
+    uint64_t hash = hash_fn(key);                                                                               \
+    uint8_t tag = name##_tag(hash);                                                                             \
+    size_t slot_idx = (size_t)hash & map->mask;                                                                 \
+                                                                                                                \
+    while(map->ctrl[slot_idx] != 0)                                                                             \
+    {                                                                                                           \
+        if(map->ctrl[slot_idx] == tag && eq_fn(map->entries[slot_idx].key, key))                                \
+        {                                                                                                       \
+            return &map->entries[slot_idx].value;                                                               \
+        }                                                                                                       \
+                                                                                                                \
+        slot_idx = (slot_idx + 1) & map->mask;                                                                  \
+    }                                                                                                           \
+                                                                                                                \
+    return NULL;                                                                                                \
+}                                                                                                               \
+                                                                                                                \
+static inline hashmap_err_t name##_push(name##_t* map, key_type key, value_type value)                          \
+{                                                                                                               \
+    name##_entry_t entry;                                                                                       \
+                                                                                                                \
+    if(name##_get(map, key) != NULL) return HASHMAP_ERR_DUPLICATE;                                              \
+    if((map->size + 1) > (map->mask + 1) / 4 * 3 && name##_grow(map) != HASHMAP_ERR_NONE)                       \
+    {                                                                                                           \
+        return HASHMAP_ERR_ALLOC_FAILED;                                                                        \
+    }                                                                                                           \
+                                                                                                                \
+    entry.key = key;                                                                                            \
+    entry.value = value;                                                                                        \
+    name##_place(map, hash_fn(key), &entry);                                                                    \
+    map->size++;                                                                                                \
+                                                                                                                \
+    return HASHMAP_ERR_NONE;                                                                                    \
+}                                                                                                               \
+                                                                                                                \
+static inline hashmap_err_t name##_delete(name##_t* map, key_type key)                                          \
+{                                                                                                               \
+    value_type* value = name##_get(map, key);                                                                   \
+    size_t hole = 0;                                                                                            \
+                                                                                                                \
+    if(value == NULL) return HASHMAP_ERR_NOT_FOUND;                                                             \
+                                                                                                                \
+    hole = (size_t)((name##_entry_t *)((char *)value - offsetof(name##_entry_t, value)) - map->entries);        \
+                                                                                                                \
+    /* Backward shift: pull back keys whose home slot is not between the hole and their slot */                 \
+    for(size_t slot_idx = (hole + 1) & map->mask; map->ctrl[slot_idx] != 0;                                     \
+        slot_idx = (slot_idx + 1) & map->mask)                                                                  \
+    {                                                                                                           \
+        size_t home = (size_t)hash_fn(map->entries[slot_idx].key) & map->mask;                                  \
+                                                                                                                \
+        if(((slot_idx - home) & map->mask) >= ((slot_idx - hole) & map->mask))                                  \
+        {                                                                                                       \
+            map->ctrl[hole] = map->ctrl[slot_idx];                                                              \
+            map->entries[hole] = map->entries[slot_idx];                                                        \
+            hole = slot_idx;                                                                                    \
+        }                                                                                                       \
+    }                                                                                                           \
+                                                                                                                \
+    map->ctrl[hole] = 0;                                                                                        \
+    map->size--;                                                                                                \
+                                                                                                                \
+    return HASHMAP_ERR_NONE;                                                                                    \
+}                                                                                                               \
+                                                                                                                \
+static inline size_t name##_size(const name##_t* map)                                                           \
+{                                                                                                               \
+    return map->size;                                                                                           \
+}                                                                                                               \
+                                                                                                                \
+static inline void name##_foreach(name##_t* map, void (*fn)(const key_type*, value_type*, void*), void* ctx)    \
+{                                                                                                               \
+    for(size_t i = 0; i <= map->mask; i++)                                                                      \
+    {                                                                                                           \
+        if(map->ctrl[i] != 0) fn(&map->entries[i].key, &map->entries[i].value, ctx);                            \
+    }                                                                                                           \
+}
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file hashmap_u64.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the hashmap keyed by 64 bit integers
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_U64_H
+#define _C_HASH_MAP_U64_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "hashmap.h"
+
+typedef struct hashmap_u64 hashmap_u64_t;
+
+hashmap_u64_t* hashmap_u64_create(size_t capacity);
+void hashmap_u64_destroy(hashmap_u64_t* map, free_value_fn_t func);
+STATUS hashmap_u64_push(hashmap_u64_t* map, uint64_t key, void* value);
+void* hashmap_u64_get(const hashmap_u64_t* map, uint64_t key);
+STATUS hashmap_u64_delete(hashmap_u64_t* map, uint64_t key, free_value_fn_t func);
+size_t hashmap_u64_size(const hashmap_u64_t* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
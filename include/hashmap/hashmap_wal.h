@@ -0,0 +1,61 @@
+/**
+ * @file hashmap_wal.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the durable hashmap, a hashmap_t backed by a write-ahead log
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_WAL_H
+#define _C_HASH_MAP_WAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashmap_wal hashmap_wal_t;
+
+/**
+ * @brief When the log is made durable
+ * 
+ */
+typedef enum HASHMAP_WAL_SYNC_TYPE
+{
+    HASHMAP_WAL_SYNC_ALWAYS,    // Every push and delete is on disk when it returns. Concurrent writers share fsync() calls.
+    HASHMAP_WAL_SYNC_INTERVAL,  // The log is synced every sync_interval_ms, a crash loses at most that much
+    HASHMAP_WAL_SYNC_NONE       // The log is written as its buffer fills and synced only by hashmap_wal_sync()
+}hashmap_wal_sync_t;
+
+/**
+ * @brief Options for hashmap_wal_open()
+ * 
+ */
+typedef struct HASHMAP_WAL_CONFIG
+{
+    hashmap_wal_sync_t sync;        // Durability policy
+    unsigned int sync_interval_ms;  // Time between background syncs with HASHMAP_WAL_SYNC_INTERVAL, 0 for 10ms
+    size_t compact_bytes;           // Log size that starts a background compaction, 0 to only compact on request
+    hashmap_encode_fn_t encode;     // Turns a value into bytes for the log
+    hashmap_decode_fn_t decode;     // Turns bytes from the log back into a value
+    free_value_fn_t free_value;     // Optional, frees values that are deleted, replaced on recovery or left at close
+}hashmap_wal_config_t;
+
+hashmap_wal_t* hashmap_wal_open(const char* dir, size_t capacity, const hashmap_wal_config_t* config);
+STATUS hashmap_wal_close(hashmap_wal_t* wal);
+STATUS hashmap_wal_push(hashmap_wal_t* wal, const char* key, void* value);
+void* hashmap_wal_get(hashmap_wal_t* wal, const char* key);
+STATUS hashmap_wal_delete(hashmap_wal_t* wal, const char* key);
+size_t hashmap_wal_size(hashmap_wal_t* wal);
+STATUS hashmap_wal_sync(hashmap_wal_t* wal);
+STATUS hashmap_wal_compact(hashmap_wal_t* wal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file hashset.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief API for the string set, a hashmap without values
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_SET_H
+#define _C_HASH_SET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hashmap.h"
+
+typedef struct hashset hashset_t;
+typedef void (*hashset_foreach_fn_t)(const char* key, void* ctx);
+
+hashset_t* hashset_create(size_t capacity);
+void hashset_destroy(hashset_t* set);
+STATUS hashset_add(hashset_t* set, const char* key);
+int hashset_contains(const hashset_t* set, const char* key);
+STATUS hashset_remove(hashset_t* set, const char* key);
+size_t hashset_size(const hashset_t* set);
+STATUS hashset_foreach(const hashset_t* set, hashset_foreach_fn_t fn, void* ctx);
+hashset_t* hashset_union(const hashset_t* a, const hashset_t* b);
+hashset_t* hashset_intersection(const hashset_t* a, const hashset_t* b);
+hashset_t* hashset_difference(const hashset_t* a, const hashset_t* b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
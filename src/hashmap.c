@@ -9,295 +9,3006 @@
  * 
  */
 
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "hashmap.h"
+#include "hashmap_alloc.h"
+#include "hashmap_internal.h"
 #include "murmur3.h"
+#include "siphash.h"
 
 #define MAX_HASHMAP_CAPACITY 4294967296 // 2^32. In 32 bit arch, hashing algo only outputs 32 bit hashes. In 64 bit arch, we only use the first 32 bits of the 128 bit output.
 
+#define SEGMENT_SHIFT 6                         // Buckets per copy-on-write segment is 2^SEGMENT_SHIFT
+#define SEGMENT_SIZE ((size_t)1 << SEGMENT_SHIFT)
+#define SEGMENT_MASK (SEGMENT_SIZE - 1)
+
+#define CHAIN_LIMIT 32  // Chains longer than this, and well above the average, trigger the flooding defense
+#define TREEIFY_THRESHOLD 8     // A bucket holding more nodes than this becomes a sorted array
+#define UNTREEIFY_THRESHOLD 6   // A sorted bucket shrinking below this goes back to a linked list
+#define DIRTY_RATIO 8           // Past capacity / DIRTY_RATIO touched buckets, hashmap_clear() scans every bucket instead
+#define BUCKET_SLOTS 2          // Entries stored in the bucket itself before nodes are chained on
+#define CACHE_LINE 64           // Assumed cache line size, every bucket fills exactly one
+#define BLOOM_WORDS 8           // 64 bit words in a Bloom filter block, one cache line
+#define BLOOM_KEYS_PER_BLOCK 32 // Keys a Bloom filter block is sized for, about 16 bits per key
+#define REBUILD_LOCKS 4096      // Spinlocks striped over the new buckets while a parallel rebuild moves entries
+
 #if defined(_WIN64) || defined(__x86_64__) || defined(__ppc64__) // 64 bit architecture
-    #define hash_func(key, len, seed, hash) MurmurHash3_x64_128(key, len, seed, hash)
+    #define HASHMAP_64_BIT 1
 #else // 32 bit architecture
-    #define hash_func(key, len, seed, hash) MurmurHash3_x86_32(key, len, seed, hash)
+    #define HASHMAP_64_BIT 0
+#endif
+
+// USDT probes are a nop each until a tracer such as bpftrace attaches to them
+#if !defined(HASHMAP_NO_USDT) && defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        #include <sys/sdt.h>
+        #define HASHMAP_USDT(name, map, key, arg) DTRACE_PROBE3(hashmap, name, map, key, arg)
+    #endif
+#endif
+
+#ifndef HASHMAP_USDT
+    #define HASHMAP_USDT(name, map, key, arg)
+#endif
+
+// Latency samples are only taken in builds with HASHMAP_TRACE
+#ifdef HASHMAP_TRACE
+    #define TRACE_BEGIN(start) uint64_t start = hashmap_trace_now()
+    #define TRACE_END(op, start, map, key, len) trace_op(op, start, map, key, len)
+    #define TRACE_HASH(hash, map, key) uint64_t hash = (map != NULL && key != NULL) ? hash_key(map, key, strlen(key), NULL) : 0
+    #define TRACE_END_REMOVED(op, start, map, hash) trace_removed(op, start, map, hash)
+#else
+    #define TRACE_BEGIN(start)
+    #define TRACE_END(op, start, map, key, len)
+    #define TRACE_HASH(hash, map, key)
+    #define TRACE_END_REMOVED(op, start, map, hash)
 #endif
 
+#define TRACE_NUL_TERMINATED SIZE_MAX   // Key length passed to trace_op() for keys ending at their NUL byte
+
 //---------------------------------------------------------------------------------------------------------
 
+typedef struct entry entry_t;
+typedef struct values values_t;
 typedef struct node node_t;
 typedef struct bucket bucket_t;
+typedef struct tree tree_t;
+typedef struct slab slab_t;
+typedef struct segment segment_t;
+typedef struct table table_t;
+
+// Key-value pair, either inline in a bucket or in a node
+struct entry
+{
+    char* key;          // Key of this entry, NULL for an empty inline slot
+    void* value;        // Value of this entry
+    uint64_t hash;      // Hash of the key, compared before the key itself
+};
+
+// Values of one key in a map created with HASHMAP_FLAG_MULTI, the entry's value points to it
+struct values
+{
+    size_t count;       // Number of values
+    size_t space;       // Number of values items has room for
+    void* items[];      // The values in the order they were pushed
+};
+
+// Entry chained off a bucket once its inline slots are full
+struct node
+{
+    entry_t entry;      // The key-value pair. First member, so an entry_t* of a node converts back to it.
+    node_t* next;       // Pointer to next node in this linked list in the event of a collision
+};
+
+// Nodes of an overfull bucket kept sorted by (hash, key) so lookups are a binary search
+struct tree
+{
+    size_t count;       // Number of nodes in the array
+    size_t space;       // Number of nodes the array has room for
+    node_t* nodes[];    // Nodes in (hash, key) order
+};
+
+// One cache line per index of the map. The first entries live inline so most lookups touch no other line,
+// the rest overflow to a linked list, or a sorted array once that grows past TREEIFY_THRESHOLD.
+struct bucket
+{
+    _Alignas(CACHE_LINE) entry_t slots[BUCKET_SLOTS];  // Inline entries, filled in any order
+    node_t* head;  // Pointer to the head of the overflow list for this bucket, NULL while tree is set
+    tree_t* tree;  // Sorted overflow nodes of this bucket, NULL while it is a linked list
+};
+
+_Static_assert(sizeof(bucket_t) == CACHE_LINE, "a bucket must fill exactly one cache line");
+
+// The contiguous buckets array made by hashmap_create_ex(), carved up into the first segments of a table
+struct slab
+{
+    hashmap_mem_t mem;      // How the buckets array was allocated
+    segment_t* segments;    // Segment descriptors pointing into the buckets array
+    atomic_size_t live;     // Number of descriptors still referenced by a table
+};
+
+// A run of SEGMENT_SIZE buckets that can be shared between a map and its snapshots
+struct segment
+{
+    atomic_size_t refs;     // Number of tables referencing this segment
+    bucket_t* buckets;      // First bucket of the segment
+    slab_t* slab;           // Slab holding the buckets, NULL if the segment was copied and owns them
+    hashmap_config_t config;    // Creation options of the map, they decide how the keys are released
+};
+
+// Directory of segments. Shared by a map and its snapshots until the map writes to it.
+struct table
+{
+    atomic_size_t refs;     // Number of maps referencing this table
+    size_t segment_count;   // Number of segments in the table
+    bucket_t** buckets;     // First bucket of each segment, indexed by bucket_idx >> SEGMENT_SHIFT
+    segment_t** segments;   // Descriptor of each segment
+};
+
+// The hashmap structure. Obfuscated from the user
+struct hashmap
+{
+    size_t capacity;            // Maximum capacity of the map
+    size_t size;                // Current size of the map
+    bucket_t** buckets;         // Segments of the buckets array, cached from table
+    table_t* table;             // Bucket table, possibly shared with snapshots
+    hashmap_config_t config;    // Creation options, reused when the table is rebuilt
+    uint64_t seed;              // Seed for the hashes
+    uint64_t sip_key[2];        // Key for SipHash-1-3 when keyed is set
+    int keyed;                  // Hash with SipHash-1-3 instead of Murmur3
+    size_t defense_size;        // Size of the map when the flooding defense last ran
+    int read_only;              // Set for snapshots made by hashmap_snapshot()
+    uint32_t* dirty;            // Buckets pushed to while empty since the last clear, hashmap_clear() only visits these
+    size_t dirty_count;         // Number of entries in dirty
+    size_t dirty_space;         // Number of entries dirty has room for
+    int dirty_overflow;         // Set when dirty is incomplete and hashmap_clear() has to scan every bucket
+    uint64_t* bloom;            // Blocked Bloom filter of the keys with HASHMAP_FLAG_BLOOM, NULL without one
+    size_t bloom_blocks;        // Number of BLOOM_WORDS word blocks in bloom
+    size_t bloom_deleted;       // Keys deleted since bloom was built, their bits are still set
+    hashmap_index_t* index;     // Ordered index of the keys with HASHMAP_FLAG_ORDERED, NULL without one
+};
+
+// Passed through the ordered index by the scans
+typedef struct scan_ctx
+{
+    const hashmap_t* map;       // Map being scanned
+    hashmap_foreach_fn_t fn;    // Called with each key and value
+    void* ctx;                  // Passed through to fn
+}scan_ctx_t;
+
+// Passed to the workers moving entries into a rebuilt table
+typedef struct rebuild_ctx
+{
+    hashmap_t* map;             // Map being rebuilt, its capacity already set to the new one
+    const table_t* old_table;   // Table the entries come from
+    table_t* table;             // Table the entries move to
+    atomic_flag* locks;         // Locks striped over the new buckets, NULL when one thread moves every entry
+    atomic_int failed;          // Set once a node could not be allocated
+}rebuild_ctx_t;
+
+// Passed to the workers of hashmap_destroy_parallel() and hashmap_clear_parallel()
+typedef struct sweep_ctx
+{
+    hashmap_t* map;             // Map being emptied
+    const uint32_t* dirty;      // Buckets to visit, NULL for every bucket
+    free_value_fn_t fn;         // Frees the values, may be NULL
+    int free_nodes;             // Also release the entries and nodes of the buckets
+}sweep_ctx_t;
+
+// Passed to the workers of hashmap_stats_parallel()
+typedef struct stats_ctx
+{
+    const hashmap_t* map;       // Map being measured
+    hashmap_stats_t* partial;   // Bucket counts of each worker
+}stats_ctx_t;
+
+// Map handed to hashmap_destroy_deferred()
+typedef struct deferred_destroy
+{
+    hashmap_t* map;             // Map to destroy
+    free_value_fn_t fn;         // Frees its values, may be NULL
+}deferred_destroy_t;
+
+static _Thread_local hashmap_err_t errno = HASHMAP_ERR_NONE;  // Last error from the hashmap library on this thread initialized to HASHMAP_ERR_NONE
+static const hashmap_parallel_t parallel_defaults = { 0, NULL, NULL };  // Thread options used when the caller passes none
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hashes a key with the map's hash function and seed
+ * @details The second half of Murmur3's 128 bit output feeds the Bloom filter. The 64 bit hash functions derive
+ * a second hash by mixing the first.
+ * 
+ * @param map - pointer to the map
+ * @param key - key to hash
+ * @param len - length of the key
+ * @param filter_hash - optional, set to a second hash for the Bloom filter
+ * @return uint64_t - the hash
+ */
+static inline uint64_t hash_key(const hashmap_t* map, const char* key, size_t len, uint64_t* filter_hash)
+{
+    uint64_t result = 0;
+
+    if(map->keyed)
+    {
+        result = SipHash13(key, len, map->sip_key);
+        if(filter_hash != NULL) *filter_hash = MurmurHash3_fmix64(result ^ map->seed);
+        return result;
+    }
+
+#if HASHMAP_64_BIT
+    uint64_t hash[2] = {0};
+    MurmurHash3_x64_128_seed64(key, (int)len, map->seed, hash);
+    result = hash[0];
+    if(filter_hash != NULL) *filter_hash = hash[1];
+#else
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(key, (int)len, (uint32_t)(map->seed ^ (map->seed >> 32)), &hash);
+    result = hash;
+    if(filter_hash != NULL) *filter_hash = MurmurHash3_fmix64(result ^ map->seed);
+#endif
+
+    return result;
+}
+
+/**
+ * @brief Sets the seed of the map and derives the SipHash key from it
+ * 
+ * @param map - pointer to the map
+ * @param seed - the new seed
+ */
+static void seed_map(hashmap_t* map, uint64_t seed)
+{
+    map->seed = seed;
+    map->sip_key[0] = seed;
+    map->sip_key[1] = MurmurHash3_fmix64(seed ^ 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * @brief Returns the bucket at bucket_idx for reading
+ * 
+ * @param map - pointer to the map
+ * @param bucket_idx - index of the bucket
+ * @return bucket_t*
+ */
+static inline bucket_t* bucket_at(const hashmap_t* map, size_t bucket_idx)
+{
+    return &map->buckets[bucket_idx >> SEGMENT_SHIFT][bucket_idx & SEGMENT_MASK];
+}
+
+/**
+ * @brief Orders a pair of bucket indexes for qsort()
+ * 
+ * @param a - first index
+ * @param b - second index
+ * @return int 
+ */
+static int dirty_compare(const void* a, const void* b)
+{
+    uint32_t left = *(const uint32_t *)a;
+    uint32_t right = *(const uint32_t *)b;
+
+    return (left > right) - (left < right);
+}
+
+/**
+ * @brief Sorts the dirty list and drops repeated buckets
+ * @details A bucket is recorded again each time it goes from empty to non-empty, so churn on one key repeats it
+ * 
+ * @param map - pointer to the map
+ */
+static void dirty_unique(hashmap_t* map)
+{
+    size_t count = 0;
+
+    if(map->dirty_overflow || map->dirty_count < 2) return;
+
+    qsort(map->dirty, map->dirty_count, sizeof(uint32_t), dirty_compare);
+
+    for(size_t i = 0; i < map->dirty_count; i++)
+    {
+        if(count == 0 || map->dirty[count - 1] != map->dirty[i]) map->dirty[count++] = map->dirty[i];
+    }
+
+    map->dirty_count = count;
+}
+
+/**
+ * @brief Records that bucket_idx is about to receive its first node so hashmap_clear() can find it
+ * @details A full list is first rid of repeated buckets. Once more than capacity / DIRTY_RATIO buckets are
+ * recorded, or the list can't grow, the list is abandoned and the next clear scans every bucket.
+ * 
+ * @param map - pointer to the map
+ * @param bucket_idx - index of the bucket
+ */
+static void mark_dirty(hashmap_t* map, size_t bucket_idx)
+{
+    if(map->dirty_overflow) return;
+
+    if(map->dirty_count == map->dirty_space)
+    {
+        size_t space = (map->dirty_space == 0) ? 16 : map->dirty_space * 2;
+        uint32_t* dirty = NULL;
+
+        dirty_unique(map);
+
+        // Only grow if deduplicating freed less than half the list, so sorting runs at most once per dirty_space / 2 pushes
+        if(map->dirty_count > 0 && map->dirty_count <= map->dirty_space / 2) space = map->dirty_space;
+
+        if(map->dirty_count >= map->capacity / DIRTY_RATIO) dirty = NULL;
+        else dirty = (space == map->dirty_space) ? map->dirty : (uint32_t *)realloc(map->dirty, space * sizeof(uint32_t));
+
+        if(dirty == NULL)
+        {
+            map->dirty_overflow = 1;
+            return;
+        }
+
+        map->dirty = dirty;
+        map->dirty_space = space;
+    }
+
+    map->dirty[map->dirty_count++] = (uint32_t)bucket_idx;
+}
+
+/**
+ * @brief Returns the key to store for a new entry: a copy, the pool's copy or the caller's own pointer
+ * 
+ * @param config - creation options of the map
+ * @param key - the caller's key
+ * @return char* - NULL if it could not be allocated
+ */
+static inline char* key_acquire(const hashmap_config_t* config, const char* key)
+{
+    if(config->intern != NULL) return hashmap_intern_acquire(config->intern, key);
+    if(config->flags & HASHMAP_FLAG_BORROW_KEYS) return (char *)key;
+
+    return strdup(key);
+}
+
+/**
+ * @brief Releases a key returned by key_acquire()
+ * 
+ * @param config - creation options of the map
+ * @param key - the stored key, may be NULL
+ */
+static inline void key_release(const hashmap_config_t* config, char* key)
+{
+    if(key == NULL || (config->flags & HASHMAP_FLAG_BORROW_KEYS)) return;
+
+    if(config->intern != NULL) hashmap_intern_release(config->intern, key);
+    else free(key);
+}
+
+/**
+ * @brief Returns the values of an entry as one array, whether the map holds one or many values per key
+ * 
+ * @param config - creation options of the map
+ * @param entry - the entry
+ * @param count - set to the number of values
+ * @return void* const* - the values
+ */
+static inline void* const* entry_values(const hashmap_config_t* config, const entry_t* entry, size_t* count)
+{
+    const values_t* values = (const values_t *)entry->value;
+
+    if(!(config->flags & HASHMAP_FLAG_MULTI))
+    {
+        *count = 1;
+        return &entry->value;
+    }
+
+    *count = values->count;
+    return values->items;
+}
+
+/**
+ * @brief Allocates a value block for a map created with HASHMAP_FLAG_MULTI
+ * 
+ * @param items - first values of the block
+ * @param count - number of values, at least 1
+ * @return values_t* - NULL if it could not be allocated
+ */
+static values_t* values_create(void* const* items, size_t count)
+{
+    values_t* values = (values_t *)malloc(sizeof(values_t) + count * sizeof(void *));
+
+    if(values == NULL) return NULL;
+
+    values->count = count;
+    values->space = count;
+    memcpy(values->items, items, count * sizeof(void *));
+
+    return values;
+}
+
+/**
+ * @brief Releases what an entry owns besides its value: the key and, with HASHMAP_FLAG_MULTI, the value block
+ * 
+ * @param config - creation options of the map
+ * @param entry - the entry
+ */
+static inline void entry_release(const hashmap_config_t* config, entry_t* entry)
+{
+    key_release(config, entry->key);
+    if(config->flags & HASHMAP_FLAG_MULTI) free(entry->value);
+}
+
+/**
+ * @brief Orders nodes by hash, then by key
+ * 
+ * @param hash - hash of the key
+ * @param key - the key
+ * @param node - node to compare against
+ * @return int - <0, 0 or >0 like strcmp()
+ */
+static inline int node_compare(uint64_t hash, const char* key, const node_t* node)
+{
+    if(hash != node->entry.hash) return (hash < node->entry.hash) ? -1 : 1;
+
+    return strcmp(key, node->entry.key);
+}
+
+/**
+ * @brief Returns the first position in a sorted bucket not ordered before (hash, key)
+ * 
+ * @param tree - sorted nodes of the bucket
+ * @param key - the key
+ * @param hash - hash of the key
+ * @return size_t 
+ */
+static inline size_t tree_lower_bound(const tree_t* tree, const char* key, uint64_t hash)
+{
+    size_t low = 0;
+    size_t high = tree->count;
+
+    while(low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        if(node_compare(hash, key, tree->nodes[mid]) > 0) low = mid + 1;
+        else high = mid;
+    }
+
+    return low;
+}
+
+/**
+ * @brief Returns whether a bucket holds no entries
+ * 
+ * @param bucket - the bucket
+ * @return int - 1 if empty, 0 otherwise
+ */
+static inline int bucket_empty(const bucket_t* bucket)
+{
+    for(size_t slot = 0; slot < BUCKET_SLOTS; slot++)
+    {
+        if(bucket->slots[slot].key != NULL) return 0;
+    }
+
+    return bucket->head == NULL && bucket->tree == NULL;
+}
+
+/**
+ * @brief Walks the entries of a bucket: the inline slots, then the overflow whether it is a linked list or sorted
+ * @details Start with entry NULL and pos 0, then pass back the previous entry until NULL is returned
+ * 
+ * @param bucket - the bucket
+ * @param entry - previously returned entry, NULL for the first one
+ * @param pos - position in the bucket, kept by the caller
+ * @return entry_t* - next entry, NULL at the end
+ */
+static inline entry_t* bucket_next(const bucket_t* bucket, const entry_t* entry, size_t* pos)
+{
+    const node_t* next = NULL;
+
+    while(*pos < BUCKET_SLOTS)
+    {
+        const entry_t* slot = &bucket->slots[(*pos)++];
+
+        if(slot->key != NULL) return (entry_t *)slot;
+    }
+
+    if(bucket->tree != NULL)
+    {
+        size_t tree_pos = (*pos)++ - BUCKET_SLOTS;
+
+        return (tree_pos < bucket->tree->count) ? &bucket->tree->nodes[tree_pos]->entry : NULL;
+    }
+
+    // Past the slots, entry is the previous node of the list
+    if(*pos == BUCKET_SLOTS)
+    {
+        (*pos)++;
+        next = bucket->head;
+    }
+    else
+    {
+        next = ((const node_t *)entry)->next;
+    }
+
+    return (next != NULL) ? (entry_t *)&next->entry : NULL;
+}
+
+/**
+ * @brief Returns the number of nodes overflowing a bucket's inline slots
+ * 
+ * @param bucket - the bucket
+ * @return size_t 
+ */
+static inline size_t overflow_count(const bucket_t* bucket)
+{
+    size_t count = 0;
+
+    if(bucket->tree != NULL) return bucket->tree->count;
+
+    for(const node_t* current = bucket->head; current != NULL; current = current->next)
+    {
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Returns the number of entries in a bucket
+ * 
+ * @param bucket - the bucket
+ * @return size_t 
+ */
+static inline size_t bucket_count(const bucket_t* bucket)
+{
+    size_t count = overflow_count(bucket);
+
+    for(size_t slot = 0; slot < BUCKET_SLOTS; slot++)
+    {
+        if(bucket->slots[slot].key != NULL) count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Finds the entry holding key in a bucket
+ * 
+ * @param bucket - the bucket
+ * @param key - key to search for
+ * @param hash - hash of the key
+ * @return entry_t* - NULL if not found
+ */
+static inline entry_t* bucket_find(const bucket_t* bucket, const char* key, uint64_t hash)
+{
+    // The inline slots share the bucket's cache line, so they are checked first
+    for(size_t slot = 0; slot < BUCKET_SLOTS; slot++)
+    {
+        const entry_t* entry = &bucket->slots[slot];
+
+        if(entry->key != NULL && entry->hash == hash && strcmp(entry->key, key) == 0) return (entry_t *)entry;
+    }
+
+    if(bucket->tree != NULL)
+    {
+        size_t pos = tree_lower_bound(bucket->tree, key, hash);
+
+        if(pos < bucket->tree->count && node_compare(hash, key, bucket->tree->nodes[pos]) == 0) return &bucket->tree->nodes[pos]->entry;
+
+        return NULL;
+    }
+
+    // Loop until end of list is reached or node with same key is found
+    for(node_t* current = bucket->head; current != NULL; current = current->next)
+    {
+        if(current->entry.hash == hash && strcmp(current->entry.key, key) == 0) return &current->entry;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Compares a key given by its length with a stored key, ordered like strcmp()
+ * @details key must not hold a NUL byte, so strncmp() stops at the end of the stored key and stored[len] is only
+ * read once the first len bytes matched
+ * 
+ * @param key - the key, not NUL terminated
+ * @param len - length of the key
+ * @param stored - NUL terminated key of an entry
+ * @return int - <0, 0 or >0 like strcmp()
+ */
+static inline int key_compare_n(const char* key, size_t len, const char* stored)
+{
+    int result = strncmp(key, stored, len);
+
+    if(result != 0) return result;
+
+    return (stored[len] == '\0') ? 0 : -1;
+}
+
+/**
+ * @brief Finds the entry holding a key given by its length in a bucket
+ * 
+ * @param bucket - the bucket
+ * @param key - key to search for, without NUL bytes
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @param pos - set to the position bucket_next() continues from after the entry
+ * @return entry_t* - NULL if not found
+ */
+static entry_t* bucket_find_n(const bucket_t* bucket, const char* key, size_t len, uint64_t hash, size_t* pos)
+{
+    for(size_t slot = 0; slot < BUCKET_SLOTS; slot++)
+    {
+        const entry_t* entry = &bucket->slots[slot];
+
+        if(entry->key != NULL && entry->hash == hash && key_compare_n(key, len, entry->key) == 0)
+        {
+            *pos = slot + 1;
+            return (entry_t *)entry;
+        }
+    }
+
+    if(bucket->tree != NULL)
+    {
+        size_t low = 0;
+        size_t high = bucket->tree->count;
+
+        while(low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            const entry_t* entry = &bucket->tree->nodes[mid]->entry;
+            int order = (hash != entry->hash) ? ((hash < entry->hash) ? -1 : 1) : key_compare_n(key, len, entry->key);
+
+            if(order == 0)
+            {
+                *pos = BUCKET_SLOTS + mid + 1;
+                return (entry_t *)entry;
+            }
+
+            if(order > 0) low = mid + 1;
+            else high = mid;
+        }
+
+        return NULL;
+    }
+
+    for(node_t* current = bucket->head; current != NULL; current = current->next)
+    {
+        if(current->entry.hash == hash && key_compare_n(key, len, current->entry.key) == 0)
+        {
+            *pos = BUCKET_SLOTS + 1;
+            return &current->entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Unlinks every overflow node of a bucket and returns them as one linked list. The inline slots are kept.
+ * 
+ * @param bucket - the bucket
+ * @return node_t* - head of the list
+ */
+static node_t* bucket_detach(bucket_t* bucket)
+{
+    node_t* head = bucket->head;
+
+    if(bucket->tree != NULL)
+    {
+        head = NULL;
+
+        for(size_t pos = bucket->tree->count; pos > 0; pos--)
+        {
+            bucket->tree->nodes[pos - 1]->next = head;
+            head = bucket->tree->nodes[pos - 1];
+        }
+
+        free(bucket->tree);
+        bucket->tree = NULL;
+    }
+
+    bucket->head = NULL;
+
+    return head;
+}
+
+/**
+ * @brief Converts a linked list overflow to a sorted one. Stays a linked list if the array can't be allocated.
+ * 
+ * @param bucket - the bucket
+ * @param count - number of overflow nodes in the bucket
+ */
+static void bucket_treeify(bucket_t* bucket, size_t count)
+{
+    tree_t* tree = (tree_t *)malloc(sizeof(tree_t) + 2 * count * sizeof(node_t *));
+
+    if(tree == NULL) return;
+
+    tree->count = 0;
+    tree->space = 2 * count;
+
+    // Insertion sort, the list is only just over TREEIFY_THRESHOLD long
+    for(node_t* current = bucket->head; current != NULL; current = current->next)
+    {
+        size_t pos = tree_lower_bound(tree, current->entry.key, current->entry.hash);
+
+        memmove(&tree->nodes[pos + 1], &tree->nodes[pos], (tree->count - pos) * sizeof(node_t *));
+        tree->nodes[pos] = current;
+        tree->count++;
+    }
+
+    bucket->head = NULL;
+    bucket->tree = tree;
+}
+
+/**
+ * @brief Adds an overflow node whose key is not in the bucket yet. Never fails: a sorted bucket that can't grow
+ * goes back to being a linked list.
+ * 
+ * @param bucket - the bucket
+ * @param node - node to add, with its hash set
+ */
+static void bucket_insert(bucket_t* bucket, node_t* node)
+{
+    tree_t* tree = bucket->tree;
+
+    if(tree != NULL && tree->count == tree->space)
+    {
+        tree = (tree_t *)realloc(tree, sizeof(tree_t) + 2 * tree->space * sizeof(node_t *));
+
+        if(tree == NULL)
+        {
+            bucket->head = bucket_detach(bucket);
+        }
+        else
+        {
+            tree->space *= 2;
+            bucket->tree = tree;
+        }
+    }
+
+    if(bucket->tree != NULL)
+    {
+        size_t pos = tree_lower_bound(bucket->tree, node->entry.key, node->entry.hash);
+
+        memmove(&bucket->tree->nodes[pos + 1], &bucket->tree->nodes[pos], (bucket->tree->count - pos) * sizeof(node_t *));
+        bucket->tree->nodes[pos] = node;
+        bucket->tree->count++;
+        return;
+    }
+
+    // Insert into bucket at head of linked list
+    node->next = bucket->head;
+    bucket->head = node;
+
+    size_t count = overflow_count(bucket);
+    if(count > TREEIFY_THRESHOLD) bucket_treeify(bucket, count);
+}
+
+/**
+ * @brief Adds a key that is not in the bucket yet, inline if a slot is free and in a new overflow node otherwise
+ * 
+ * @param bucket - the bucket
+ * @param key - the key, owned by the bucket on success
+ * @param value - value for the key
+ * @param hash - hash of the key
+ * @return STATUS - ERROR if a node was needed and could not be allocated
+ */
+static STATUS bucket_add(bucket_t* bucket, char* key, void* value, uint64_t hash)
+{
+    node_t* node = NULL;
+
+    for(size_t slot = 0; slot < BUCKET_SLOTS; slot++)
+    {
+        entry_t* entry = &bucket->slots[slot];
+
+        if(entry->key == NULL)
+        {
+            entry->key = key;
+            entry->value = value;
+            entry->hash = hash;
+            return SUCCESS;
+        }
+    }
+
+    node = (node_t *)malloc(sizeof(node_t));
+    if(node == NULL) return ERROR;
+
+    node->entry.key = key;
+    node->entry.value = value;
+    node->entry.hash = hash;
+    bucket_insert(bucket, node);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Removes key from a bucket, freeing its node. The stored key is handed back for the caller to release.
+ * @details An emptied inline slot is left as a hole for the next bucket_add() rather than refilled from the overflow
+ * 
+ * @param bucket - the bucket
+ * @param key - key to remove
+ * @param hash - hash of the key
+ * @param removed - set to the removed entry
+ * @return STATUS - ERROR if not found
+ */
+static STATUS bucket_remove(bucket_t* bucket, const char* key, uint64_t hash, entry_t* removed)
+{
+    node_t* current = bucket->head;
+    node_t* prev = NULL;
+
+    for(size_t slot = 0; slot < BUCKET_SLOTS; slot++)
+    {
+        entry_t* entry = &bucket->slots[slot];
+
+        if(entry->key != NULL && entry->hash == hash && strcmp(entry->key, key) == 0)
+        {
+            *removed = *entry;
+            entry->key = NULL;
+            return SUCCESS;
+        }
+    }
+
+    if(bucket->tree != NULL)
+    {
+        tree_t* tree = bucket->tree;
+        size_t pos = tree_lower_bound(tree, key, hash);
+
+        if(pos == tree->count || node_compare(hash, key, tree->nodes[pos]) != 0) return ERROR;
+
+        current = tree->nodes[pos];
+        memmove(&tree->nodes[pos], &tree->nodes[pos + 1], (tree->count - pos - 1) * sizeof(node_t *));
+        tree->count--;
+
+        if(tree->count < UNTREEIFY_THRESHOLD) bucket->head = bucket_detach(bucket);
+    }
+    else
+    {
+        // Find the node to be deleted
+        while((current != NULL) && (current->entry.hash != hash || strcmp(current->entry.key, key) != 0))
+        {
+            prev = current;
+            current = current->next;
+        }
+
+        if(current == NULL) return ERROR;
+
+        // Check if this node is the head of the list
+        if(prev == NULL)
+        {
+            // Make next node the new head of the list
+            bucket->head = current->next;
+        }
+        else
+        {
+            // Else, make next of prev to next of current
+            prev->next = current->next;
+        }
+    }
+
+    *removed = current->entry;
+    free(current);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Empties a run of buckets, freeing the overflow nodes and optionally releasing the entries. Values are not touched.
+ * 
+ * @param buckets - first bucket
+ * @param count - number of buckets
+ * @param config - creation options the entries were made with, NULL when they were handed over to another table
+ */
+static void buckets_empty(bucket_t* buckets, size_t count, const hashmap_config_t* config)
+{
+    for(size_t bucket_idx = 0; bucket_idx < count; bucket_idx++)
+    {
+        node_t* current = bucket_detach(&buckets[bucket_idx]);
+
+        for(size_t slot = 0; slot < BUCKET_SLOTS; slot++)
+        {
+            if(config != NULL && buckets[bucket_idx].slots[slot].key != NULL) entry_release(config, &buckets[bucket_idx].slots[slot]);
+            buckets[bucket_idx].slots[slot].key = NULL;
+        }
+
+        while(current != NULL)
+        {
+            node_t* next = current->next;
+
+            if(config != NULL) entry_release(config, &current->entry);
+            free(current);
+            current = next;
+        }
+    }
+}
+
+/**
+ * @brief Drops one reference to a segment, freeing its nodes and memory with the last one
+ * 
+ * @param segment - segment to release
+ */
+static void segment_release(segment_t* segment)
+{
+    slab_t* slab = segment->slab;
+
+    if(atomic_fetch_sub(&segment->refs, 1) != 1) return;
+
+    buckets_empty(segment->buckets, SEGMENT_SIZE, &segment->config);
+
+    if(slab == NULL)
+    {
+        free(segment);
+    }
+    else if(atomic_fetch_sub(&slab->live, 1) == 1)
+    {
+        // The descriptors live in the slab, segment is among them
+        hashmap_mem_free(&slab->mem);
+        free(slab->segments);
+        free(slab);
+    }
+}
+
+/**
+ * @brief Allocates a table with every segment backed by one slab
+ * 
+ * @param capacity - number of buckets
+ * @param config - creation options of the map, for the slab and its keys
+ * @param err - set to the reason on failure
+ * @return table_t* - NULL if error
+ */
+static table_t* table_create(size_t capacity, const hashmap_config_t* config, hashmap_err_t* err)
+{
+    size_t segment_count = (capacity + SEGMENT_MASK) >> SEGMENT_SHIFT;
+    table_t* table = (table_t *)malloc(sizeof(table_t));
+    slab_t* slab = (slab_t *)malloc(sizeof(slab_t));
+
+    *err = HASHMAP_ERR_ALLOC_FAILED;
+
+    if(table == NULL || slab == NULL)
+    {
+        free(table);
+        free(slab);
+        return NULL;
+    }
+
+    table->buckets = (bucket_t **)malloc(segment_count * sizeof(bucket_t *));
+    table->segments = (segment_t **)malloc(segment_count * sizeof(segment_t *));
+    slab->segments = (segment_t *)malloc(segment_count * sizeof(segment_t));
+
+    if(table->buckets != NULL && table->segments != NULL && slab->segments != NULL)
+    {
+        *err = hashmap_mem_alloc(&slab->mem, segment_count * SEGMENT_SIZE, sizeof(bucket_t), config);
+    }
+
+    if(*err != HASHMAP_ERR_NONE)
+    {
+        free(slab->segments);
+        free(table->segments);
+        free(table->buckets);
+        free(slab);
+        free(table);
+        return NULL;
+    }
+
+    atomic_init(&table->refs, 1);
+    atomic_init(&slab->live, segment_count);
+    table->segment_count = segment_count;
+
+    for(size_t segment_idx = 0; segment_idx < segment_count; segment_idx++)
+    {
+        segment_t* segment = &slab->segments[segment_idx];
+
+        atomic_init(&segment->refs, 1);
+        segment->buckets = (bucket_t *)slab->mem.ptr + segment_idx * SEGMENT_SIZE;
+        segment->slab = slab;
+        segment->config = *config;
+
+        table->segments[segment_idx] = segment;
+        table->buckets[segment_idx] = segment->buckets;
+    }
+
+    return table;
+}
+
+/**
+ * @brief Drops one reference to a table, releasing its segments with the last one
+ * 
+ * @param table - table to release
+ */
+static void table_release(table_t* table)
+{
+    if(atomic_fetch_sub(&table->refs, 1) != 1) return;
+
+    for(size_t segment_idx = 0; segment_idx < table->segment_count; segment_idx++)
+    {
+        segment_release(table->segments[segment_idx]);
+    }
+
+    free(table->segments);
+    free(table->buckets);
+    free(table);
+}
+
+/**
+ * @brief Tells whether a snapshot still references the table or any of its segments
+ * @details Only the map's writer takes snapshots, so for it a result of 0 can't become stale
+ * 
+ * @param table - the map's table
+ * @return int - 1 if shared
+ */
+static int table_shared(const table_t* table)
+{
+    if(atomic_load(&table->refs) > 1) return 1;
+
+    for(size_t segment_idx = 0; segment_idx < table->segment_count; segment_idx++)
+    {
+        if(atomic_load(&table->segments[segment_idx]->refs) > 1) return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Gives the map a private copy of its table directory. The segments stay shared.
+ * 
+ * @param map - pointer to the map
+ * @return STATUS 
+ */
+static STATUS table_unshare(hashmap_t* map)
+{
+    table_t* shared = map->table;
+    table_t* table = (table_t *)malloc(sizeof(table_t));
+
+    if(table == NULL) return ERROR;
+
+    table->buckets = (bucket_t **)malloc(shared->segment_count * sizeof(bucket_t *));
+    table->segments = (segment_t **)malloc(shared->segment_count * sizeof(segment_t *));
+
+    if(table->buckets == NULL || table->segments == NULL)
+    {
+        free(table->segments);
+        free(table->buckets);
+        free(table);
+        return ERROR;
+    }
+
+    atomic_init(&table->refs, 1);
+    table->segment_count = shared->segment_count;
+    memcpy(table->buckets, shared->buckets, shared->segment_count * sizeof(bucket_t *));
+    memcpy(table->segments, shared->segments, shared->segment_count * sizeof(segment_t *));
+
+    for(size_t segment_idx = 0; segment_idx < table->segment_count; segment_idx++)
+    {
+        atomic_fetch_add(&table->segments[segment_idx]->refs, 1);
+    }
+
+    map->table = table;
+    map->buckets = table->buckets;
+    table_release(shared);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Gives the map a private deep copy of one segment so it can be modified
+ * 
+ * @param map - pointer to the map
+ * @param segment_idx - index of the segment
+ * @return STATUS 
+ */
+static STATUS segment_unshare(hashmap_t* map, size_t segment_idx)
+{
+    // The buckets follow the descriptor on their own cache line, and aligned_alloc() wants a multiple of it
+    const size_t header = (sizeof(segment_t) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    segment_t* shared = map->table->segments[segment_idx];
+    segment_t* segment = (segment_t *)aligned_alloc(CACHE_LINE, header + SEGMENT_SIZE * sizeof(bucket_t));
+
+    if(segment == NULL) return ERROR;
+
+    atomic_init(&segment->refs, 1);
+    segment->buckets = (bucket_t *)((char *)segment + header);
+    segment->slab = NULL;
+    segment->config = shared->config;
+
+    memset(segment->buckets, 0, SEGMENT_SIZE * sizeof(bucket_t));
+
+    for(size_t bucket_idx = 0; bucket_idx < SEGMENT_SIZE; bucket_idx++)
+    {
+        const bucket_t* source = &shared->buckets[bucket_idx];
+        size_t pos = 0;
+
+        // Copy every entry, inserting keeps a sorted bucket sorted
+        for(entry_t* current = bucket_next(source, NULL, &pos); current != NULL; current = bucket_next(source, current, &pos))
+        {
+            char* key = key_acquire(&segment->config, current->key);
+            void* value = current->value;
+
+            // Value blocks grow in place, so each copy of the segment needs its own
+            if(segment->config.flags & HASHMAP_FLAG_MULTI)
+            {
+                const values_t* values = (const values_t *)current->value;
+
+                value = values_create(values->items, values->count);
+            }
+
+            if(key == NULL || value == NULL || bucket_add(&segment->buckets[bucket_idx], key, value, current->hash) == ERROR)
+            {
+                key_release(&segment->config, key);
+                if(segment->config.flags & HASHMAP_FLAG_MULTI) free(value);
+                buckets_empty(segment->buckets, bucket_idx + 1, &segment->config);
+                free(segment);
+                return ERROR;
+            }
+        }
+    }
+
+    // The ordered index holds the map's stored keys, which are now the copies
+    for(size_t bucket_idx = 0; bucket_idx < SEGMENT_SIZE && map->index != NULL; bucket_idx++)
+    {
+        const bucket_t* bucket = &segment->buckets[bucket_idx];
+        size_t pos = 0;
+
+        for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+        {
+            hashmap_index_update(map->index, current->key);
+        }
+    }
+
+    map->table->segments[segment_idx] = segment;
+    map->table->buckets[segment_idx] = segment->buckets;
+    segment_release(shared);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the bucket at bucket_idx for writing, copying it away from any snapshot first
+ * 
+ * @param map - pointer to the map
+ * @param bucket_idx - index of the bucket
+ * @return bucket_t* - NULL if the copy could not be allocated
+ */
+static bucket_t* bucket_for_write(hashmap_t* map, size_t bucket_idx)
+{
+    size_t segment_idx = bucket_idx >> SEGMENT_SHIFT;
+
+    if(atomic_load(&map->table->refs) > 1 && table_unshare(map) == ERROR) return NULL;
+
+    if(atomic_load(&map->table->segments[segment_idx]->refs) > 1 && segment_unshare(map, segment_idx) == ERROR) return NULL;
+
+    return bucket_at(map, bucket_idx);
+}
+
+/**
+ * @brief Returns the Bloom filter block of a key
+ * 
+ * @param map - pointer to the map, with a filter
+ * @param filter_hash - second hash of the key
+ * @return uint64_t* - first word of the block
+ */
+static inline uint64_t* bloom_block(const hashmap_t* map, uint64_t filter_hash)
+{
+    // Multiply-shift maps the top 32 bits onto the blocks without a division
+    return &map->bloom[((filter_hash >> 32) * map->bloom_blocks >> 32) * BLOOM_WORDS];
+}
+
+/**
+ * @brief Returns the bit a key sets in word of its block, split block Bloom filter style
+ * 
+ * @param filter_hash - second hash of the key
+ * @param word - index of the word in the block
+ * @return uint64_t - mask with one bit set
+ */
+static inline uint64_t bloom_bit(uint64_t filter_hash, size_t word)
+{
+    static const uint32_t salts[BLOOM_WORDS] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+    return (uint64_t)1 << (((uint32_t)filter_hash * salts[word]) >> 26);
+}
+
+/**
+ * @brief Adds a key to the map's Bloom filter, if it has one
+ * 
+ * @param map - pointer to the map
+ * @param filter_hash - second hash of the key
+ */
+static inline void bloom_add(hashmap_t* map, uint64_t filter_hash)
+{
+    if(map->bloom == NULL) return;
+
+    uint64_t* block = bloom_block(map, filter_hash);
+
+    for(size_t word = 0; word < BLOOM_WORDS; word++)
+    {
+        block[word] |= bloom_bit(filter_hash, word);
+    }
+}
+
+/**
+ * @brief Returns whether a key may be in the map. Keys the filter rules out are certainly missing.
+ * 
+ * @param map - pointer to the map
+ * @param filter_hash - second hash of the key
+ * @return int - 0 if the key is certainly not in the map, 1 otherwise
+ */
+static inline int bloom_may_contain(const hashmap_t* map, uint64_t filter_hash)
+{
+    if(map->bloom == NULL) return 1;
+
+    const uint64_t* block = bloom_block(map, filter_hash);
+
+    for(size_t word = 0; word < BLOOM_WORDS; word++)
+    {
+        if(!(block[word] & bloom_bit(filter_hash, word))) return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Replaces the Bloom filter with a fresh one filled with every key of the map
+ * @details Deleted keys can't be taken out of a Bloom filter, so this also drops their bits. The filter is sized
+ * for twice the keys, and at least one per bucket, so it is rebuilt O(log n) times as the map grows. If the new
+ * filter can't be allocated the old one is kept: it still holds every key, only with more false positives.
+ * 
+ * @param map - pointer to the map
+ * @return STATUS - ERROR if the filter could not be allocated
+ */
+static STATUS bloom_rebuild(hashmap_t* map)
+{
+    size_t keys = (2 * map->size > map->capacity) ? 2 * map->size : map->capacity;
+    size_t blocks = keys / BLOOM_KEYS_PER_BLOCK + 1;
+    uint64_t* bloom = (uint64_t *)aligned_alloc(CACHE_LINE, blocks * BLOOM_WORDS * sizeof(uint64_t));
+
+    if(bloom == NULL) return ERROR;
+
+    memset(bloom, 0, blocks * BLOOM_WORDS * sizeof(uint64_t));
+    free(map->bloom);
+    map->bloom = bloom;
+    map->bloom_blocks = blocks;
+    map->bloom_deleted = 0;
+
+    for(size_t bucket_idx = 0; bucket_idx < map->capacity && map->size > 0; bucket_idx++)
+    {
+        const bucket_t* bucket = bucket_at(map, bucket_idx);
+        size_t pos = 0;
+
+        for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+        {
+            uint64_t filter_hash = 0;
+
+            hash_key(map, current->key, strlen(current->key), &filter_hash);
+            bloom_add(map, filter_hash);
+        }
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Moves the entries of a run of old buckets into the new table
+ * @details With locks, several workers move entries at once and each new bucket is locked while an entry is
+ * added. Without them, the bucket is also recorded in the dirty list.
+ * 
+ * @param arg - the rebuild_ctx_t
+ * @param begin - first old bucket
+ * @param end - one past the last old bucket
+ * @param worker - unused
+ */
+static void rebuild_range(void* arg, size_t begin, size_t end, size_t worker)
+{
+    rebuild_ctx_t* rebuild = (rebuild_ctx_t *)arg;
+    hashmap_t* map = rebuild->map;
+
+    (void)worker;
+
+    for(size_t old_idx = begin; old_idx < end && !atomic_load_explicit(&rebuild->failed, memory_order_relaxed); old_idx++)
+    {
+        const bucket_t* source = &rebuild->old_table->buckets[old_idx >> SEGMENT_SHIFT][old_idx & SEGMENT_MASK];
+        size_t pos = 0;
+
+        for(entry_t* current = bucket_next(source, NULL, &pos); current != NULL; current = bucket_next(source, current, &pos))
+        {
+            uint64_t hash = hash_key(map, current->key, strlen(current->key), NULL);
+            size_t new_idx = hash % map->capacity;
+            bucket_t* bucket = &rebuild->table->buckets[new_idx >> SEGMENT_SHIFT][new_idx & SEGMENT_MASK];
+            atomic_flag* lock = (rebuild->locks != NULL) ? &rebuild->locks[new_idx % REBUILD_LOCKS] : NULL;
+            STATUS status = ERROR;
+
+            if(lock != NULL) while(atomic_flag_test_and_set_explicit(lock, memory_order_acquire));
+            else if(bucket_empty(bucket)) mark_dirty(map, new_idx);
+
+            status = bucket_add(bucket, current->key, current->value, hash);
+
+            if(lock != NULL) atomic_flag_clear_explicit(lock, memory_order_release);
+
+            if(status == ERROR)
+            {
+                atomic_store(&rebuild->failed, 1);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Rehashes every key into a new table of capacity buckets using the map's current seed
+ * @details Segments shared with snapshots are copied first so the keys can then be handed over to the new table.
+ * Entries that land past the inline slots need new nodes, so the old table is only emptied once every entry
+ * found a place. On failure the map is left as it was.
+ * 
+ * @param map - pointer to the map
+ * @param capacity - bucket count of the new table
+ * @param parallel - options to move the entries on several threads, NULL to move them on the caller's
+ * @return STATUS 
+ */
+static STATUS table_rebuild(hashmap_t* map, size_t capacity, const hashmap_parallel_t* parallel)
+{
+    hashmap_err_t err = HASHMAP_ERR_NONE;
+    table_t* old_table = NULL;
+    table_t* table = NULL;
+    size_t old_capacity = map->capacity;
+    rebuild_ctx_t rebuild;
+
+    if(atomic_load(&map->table->refs) > 1 && table_unshare(map) == ERROR) return ERROR;
+
+    for(size_t segment_idx = 0; segment_idx < map->table->segment_count; segment_idx++)
+    {
+        if(atomic_load(&map->table->segments[segment_idx]->refs) > 1 && segment_unshare(map, segment_idx) == ERROR) return ERROR;
+    }
+
+    table = table_create(capacity, &map->config, &err);
+    if(table == NULL) return ERROR;
+
+    old_table = map->table;
+    rebuild.map = map;
+    rebuild.old_table = old_table;
+    rebuild.table = table;
+    rebuild.locks = (parallel != NULL) ? (atomic_flag *)malloc(REBUILD_LOCKS * sizeof(atomic_flag)) : NULL;
+    atomic_init(&rebuild.failed, 0);
+
+    // The touched buckets are recorded again as the entries move
+    map->capacity = capacity;
+    map->dirty_count = 0;
+    map->dirty_overflow = 0;
+
+    if(rebuild.locks != NULL)
+    {
+        for(size_t lock_idx = 0; lock_idx < REBUILD_LOCKS; lock_idx++) atomic_flag_clear(&rebuild.locks[lock_idx]);
+
+        // The workers don't share the dirty list, so the next clear scans every bucket
+        map->dirty_overflow = 1;
+
+        if(hashmap_pool_for(old_table->segment_count * SEGMENT_SIZE, parallel, rebuild_range, &rebuild) == ERROR)
+        {
+            atomic_store(&rebuild.failed, 1);
+        }
+
+        free(rebuild.locks);
+    }
+    else
+    {
+        rebuild_range(&rebuild, 0, old_table->segment_count * SEGMENT_SIZE, 0);
+    }
+
+    if(atomic_load(&rebuild.failed))
+    {
+        // The keys still belong to the old table. The dirty list no longer matches it, so scan on clear.
+        for(size_t new_segment = 0; new_segment < table->segment_count; new_segment++)
+        {
+            buckets_empty(table->buckets[new_segment], SEGMENT_SIZE, NULL);
+        }
+
+        table_release(table);
+        map->capacity = old_capacity;
+        map->dirty_overflow = 1;
+        return ERROR;
+    }
+
+    // The keys now belong to the new table
+    for(size_t segment_idx = 0; segment_idx < old_table->segment_count; segment_idx++)
+    {
+        buckets_empty(old_table->buckets[segment_idx], SEGMENT_SIZE, NULL);
+    }
+
+    map->table = table;
+    map->buckets = table->buckets;
+    table_release(old_table);
+
+    // A new seed moves every key to other filter bits too, so the old filter is useless if no new one fits
+    if(map->bloom != NULL && bloom_rebuild(map) == ERROR)
+    {
+        free(map->bloom);
+        map->bloom = NULL;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Defends against hash flooding after a push made an abnormally long chain
+ * @details Murmur3 has collisions that hold for every seed, so the first time the map switches to SipHash-1-3
+ * with a fresh random key. Later triggers pick a new random key. Either way every key is rehashed, and this
+ * runs at most once per doubling of the map so legitimate skew can't make pushes quadratic.
+ * 
+ * @param map - pointer to the map
+ */
+static void flooding_defense(hashmap_t* map)
+{
+    uint64_t seed = map->seed;
+    uint64_t sip_key[2] = { map->sip_key[0], map->sip_key[1] };
+    int keyed = map->keyed;
+
+    if(map->size < map->defense_size * 2) return;
+
+    map->defense_size = map->size;
+    map->keyed = 1;
+    map->seed = hashmap_random_u64();
+    map->sip_key[0] = hashmap_random_u64();
+    map->sip_key[1] = hashmap_random_u64();
+
+    if(table_rebuild(map, map->capacity, NULL) == ERROR)
+    {
+        map->seed = seed;
+        map->sip_key[0] = sip_key[0];
+        map->sip_key[1] = sip_key[1];
+        map->keyed = keyed;
+    }
+}
+
+/**
+ * @brief Appends a value to the value block of a key already in a map created with HASHMAP_FLAG_MULTI
+ * 
+ * @param map - pointer to the map
+ * @param bucket_idx - index of the key's bucket
+ * @param key - the key
+ * @param hash - hash of the key
+ * @param value - value to append
+ * @return STATUS - ERROR if the bucket or the block could not be allocated
+ */
+static STATUS values_append(hashmap_t* map, size_t bucket_idx, const char* key, uint64_t hash, void* value)
+{
+    bucket_t* bucket = bucket_for_write(map, bucket_idx);
+    entry_t* entry = NULL;
+    values_t* values = NULL;
+
+    if(bucket == NULL) return ERROR;
+
+    // The bucket may have just been copied, so grow the block of the writable one
+    entry = bucket_find(bucket, key, hash);
+    values = (values_t *)entry->value;
+
+    if(values->count == values->space)
+    {
+        size_t space = 2 * values->space;
+
+        values = (values_t *)realloc(values, sizeof(values_t) + space * sizeof(void *));
+        if(values == NULL) return ERROR;
+
+        values->space = space;
+        entry->value = values;
+    }
+
+    values->items[values->count++] = value;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Resets the map once its buckets were emptied by a clear
+ * 
+ * @param map - pointer to the map
+ * @param table - fresh table to swap in when the old one is shared with a snapshot, NULL otherwise
+ */
+static void clear_finish(hashmap_t* map, table_t* table)
+{
+    if(table != NULL)
+    {
+        table_release(map->table);
+        map->table = table;
+        map->buckets = table->buckets;
+    }
+
+    map->size = 0;
+    map->defense_size = 0;
+    map->dirty_count = 0;
+    map->dirty_overflow = 0;
+
+    if(map->bloom != NULL)
+    {
+        memset(map->bloom, 0, map->bloom_blocks * BLOOM_WORDS * sizeof(uint64_t));
+        map->bloom_deleted = 0;
+    }
+
+    if(map->index != NULL) hashmap_index_clear(map->index);
+}
+
+/**
+ * @brief Frees the values, and optionally the nodes, of a run of buckets for the parallel destroy and clear
+ * 
+ * @param arg - the sweep_ctx_t
+ * @param begin - first bucket, or first position in the dirty list
+ * @param end - one past the last one
+ * @param worker - unused
+ */
+static void sweep_range(void* arg, size_t begin, size_t end, size_t worker)
+{
+    const sweep_ctx_t* sweep = (const sweep_ctx_t *)arg;
+
+    (void)worker;
+
+    for(size_t i = begin; i < end; i++)
+    {
+        size_t bucket_idx = (sweep->dirty != NULL) ? sweep->dirty[i] : i;
+        bucket_t* bucket = bucket_at(sweep->map, bucket_idx);
+        size_t pos = 0;
+
+        if(sweep->fn != NULL)
+        {
+            for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+            {
+                size_t count = 0;
+                void* const* values = entry_values(&sweep->map->config, current, &count);
+
+                for(size_t value_idx = 0; value_idx < count; value_idx++) sweep->fn(values[value_idx]);
+            }
+        }
+
+        if(sweep->free_nodes) buckets_empty(bucket, 1, &sweep->map->config);
+    }
+}
+
+/**
+ * @brief Counts the used buckets and the longest chain of a run of buckets into the worker's partial stats
+ * 
+ * @param arg - the stats_ctx_t
+ * @param begin - first bucket
+ * @param end - one past the last bucket
+ * @param worker - index of the partial stats to fill
+ */
+static void stats_range(void* arg, size_t begin, size_t end, size_t worker)
+{
+    const stats_ctx_t* ctx = (const stats_ctx_t *)arg;
+    hashmap_stats_t* partial = &ctx->partial[worker];
+
+    for(size_t bucket_idx = begin; bucket_idx < end; bucket_idx++)
+    {
+        size_t chain_length = bucket_count(bucket_at(ctx->map, bucket_idx));
+
+        if(chain_length > 0) partial->used_buckets++;
+        if(chain_length > partial->max_chain) partial->max_chain = chain_length;
+    }
+}
+
+/**
+ * @brief Calls the user's function on every pair of a run of buckets for hashmap_foreach_parallel()
+ * 
+ * @param arg - the scan_ctx_t
+ * @param begin - first bucket
+ * @param end - one past the last bucket
+ * @param worker - unused
+ */
+static void foreach_range(void* arg, size_t begin, size_t end, size_t worker)
+{
+    const scan_ctx_t* scan = (const scan_ctx_t *)arg;
+
+    (void)worker;
+
+    for(size_t bucket_idx = begin; bucket_idx < end; bucket_idx++)
+    {
+        const bucket_t* bucket = bucket_at(scan->map, bucket_idx);
+        size_t pos = 0;
+
+        for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+        {
+            size_t count = 0;
+            void* const* values = entry_values(&scan->map->config, current, &count);
+
+            for(size_t value_idx = 0; value_idx < count; value_idx++) scan->fn(current->key, values[value_idx], scan->ctx);
+        }
+    }
+}
+
+/**
+ * @brief Destroys a map handed to hashmap_destroy_deferred(), on a pool thread
+ * 
+ * @param arg - the deferred_destroy_t, freed here
+ */
+static void deferred_destroy(void* arg)
+{
+    deferred_destroy_t* deferred = (deferred_destroy_t *)arg;
+
+    hashmap_destroy(deferred->map, deferred->fn);
+    free(deferred);
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the hashmap_t object and returns the handle
+ * 
+ * @param capacity - max number of unique indexes for the map 
+ * @return hashmap_t* - pointer to the hashmap_t object. NULL if error.
+ */
+hashmap_t* hashmap_create(size_t capacity)
+{
+    return hashmap_create_ex(capacity, NULL);
+}
+
+/**
+ * @brief Creates the hashmap_t object with creation options, optionally on cache lines of its own
+ * 
+ * @param capacity - max number of unique indexes for the map
+ * @param config - optional creation options. NULL behaves like hashmap_create().
+ * @param aligned - set to start the structure on a cache line and pad it to whole lines
+ * @return hashmap_t* - pointer to the hashmap_t object. NULL if error.
+ */
+static hashmap_t* map_create(size_t capacity, const hashmap_config_t* config, int aligned)
+{
+    errno = HASHMAP_ERR_NONE;
+    hashmap_t* map = NULL;
+
+    // Check for valid capacity
+    if(capacity > MAX_HASHMAP_CAPACITY || capacity == 0)
+    {
+        errno = HASHMAP_ERR_INVALID_CAPACITY;
+        return NULL;
+    }
+
+    // Interleaving and binding are mutually exclusive placements, as are borrowing and interning keys
+    if(config != NULL && (((config->flags & HASHMAP_FLAG_NUMA_BIND) && (config->flags & HASHMAP_FLAG_NUMA_INTERLEAVE)) ||
+                          ((config->flags & HASHMAP_FLAG_BORROW_KEYS) && config->intern != NULL)))
+    {
+        errno = HASHMAP_ERR_INVALID_CONFIG;
+        return NULL;
+    }
+
+    // aligned_alloc() wants a multiple of the alignment
+    if(aligned) map = (hashmap_t *)aligned_alloc(CACHE_LINE, (sizeof(hashmap_t) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+    else map = (hashmap_t *)malloc(sizeof(hashmap_t));
+
+    // Check memory allocation succeeded
+    if(map == NULL)
+    {
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return NULL;
+    }
+
+    map->capacity = capacity;
+    map->size = 0;
+    map->keyed = (config != NULL && (config->flags & HASHMAP_FLAG_SIPHASH)) ? 1 : 0;
+    map->defense_size = 0;
+    map->read_only = 0;
+    map->dirty = NULL;
+    map->dirty_count = 0;
+    map->dirty_space = 0;
+    map->dirty_overflow = 0;
+    map->bloom = NULL;
+    map->bloom_blocks = 0;
+    map->bloom_deleted = 0;
+    map->index = NULL;
+    map->config.flags = (config != NULL) ? config->flags : HASHMAP_FLAG_NONE;
+    map->config.numa_node = (config != NULL) ? config->numa_node : 0;
+    map->config.intern = (config != NULL) ? config->intern : NULL;
+
+    // Random seeds keep colliding keys from being precomputed
+    seed_map(map, hashmap_random_u64());
+    map->sip_key[1] = hashmap_random_u64();
+
+    // Check that the buckets array was allocated successfully
+    map->table = table_create(capacity, &map->config, &errno);
+
+    if(map->table == NULL)
+    {
+        free(map);
+        return NULL;
+    }
+
+    map->buckets = map->table->buckets;
+
+    if((map->config.flags & HASHMAP_FLAG_BLOOM) && bloom_rebuild(map) == ERROR)
+    {
+        table_release(map->table);
+        free(map);
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return NULL;
+    }
+
+    if(map->config.flags & HASHMAP_FLAG_ORDERED)
+    {
+        map->index = hashmap_index_create();
+
+        if(map->index == NULL)
+        {
+            table_release(map->table);
+            free(map->bloom);
+            free(map);
+            errno = HASHMAP_ERR_ALLOC_FAILED;
+            return NULL;
+        }
+    }
+
+    return map;
+}
+
+/**
+ * @brief Creates the hashmap_t object with creation options and returns the handle
+ * @details The options control how the buckets array is backed, huge pages and NUMA placement, and how keys are stored.
+ * 
+ * @param capacity - max number of unique indexes for the map
+ * @param config - optional creation options. NULL behaves like hashmap_create().
+ * @return hashmap_t* - pointer to the hashmap_t object. NULL if error.
+ */
+hashmap_t* hashmap_create_ex(size_t capacity, const hashmap_config_t* config)
+{
+    return map_create(capacity, config, 0);
+}
+
+/**
+ * @brief Creates a map like hashmap_create_ex() whose structure shares no cache line with other allocations
+ * @details Used for maps written by different threads side by side, like the shards of a hashmap_sharded_t.
+ * 
+ * @param capacity - max number of unique indexes for the map
+ * @param config - optional creation options
+ * @return hashmap_t* - pointer to the hashmap_t object, freed by hashmap_destroy(). NULL if error.
+ */
+hashmap_t* hashmap_create_aligned(size_t capacity, const hashmap_config_t* config)
+{
+    return map_create(capacity, config, 1);
+}
+
+/**
+ * @brief Safely deallocates map. User can optionally provide a function for freeing values.
+ * @details Snapshots never own their values, so fn is ignored when map is a snapshot.
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional pointer to function for freeing values. Can pass NULL to not have library handle freeing values.
+ */
+void hashmap_destroy(hashmap_t* map, free_value_fn_t fn)
+{
+    errno = HASHMAP_ERR_NONE;
+
+    if(map != NULL)
+    {
+        if(fn != NULL && !map->read_only)
+        {
+            // Index through the entries of all buckets
+            for(size_t bucket_idx = 0; bucket_idx < map->capacity; bucket_idx++)
+            {
+                const bucket_t* bucket = bucket_at(map, bucket_idx);
+                size_t pos = 0;
+
+                for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+                {
+                    size_t count = 0;
+                    void* const* values = entry_values(&map->config, current, &count);
+
+                    for(size_t value_idx = 0; value_idx < count; value_idx++) fn(values[value_idx]);
+                }
+            }
+        }
+
+        // Nodes still shared with a snapshot are freed when the snapshot is destroyed
+        table_release(map->table);
+        free(map->dirty);
+        free(map->bloom);
+        hashmap_index_destroy(map->index);
+        free(map);
+    }
+}
+
+#ifdef HASHMAP_TRACE
+/**
+ * @brief Records the latency of an operation with the probe and chain samples of the key's bucket
+ * @details The bucket is walked once the latency was taken, so the walk isn't part of it. A deleted key counts
+ * as a miss of the remaining chain.
+ * 
+ * @param op - the operation
+ * @param start - time the operation started
+ * @param map - the map, may be NULL
+ * @param key - the key, may be NULL
+ * @param len - length of the key, TRACE_NUL_TERMINATED if it ends at its NUL byte
+ */
+static void trace_op(hashmap_trace_op_t op, uint64_t start, const hashmap_t* map, const char* key, size_t len)
+{
+    uint64_t elapsed = hashmap_trace_now() - start;
+    const bucket_t* bucket = NULL;
+    uint64_t hash = 0;
+    size_t probes = 0;
+    size_t pos = 0;
+
+    if(map == NULL || key == NULL)
+    {
+        hashmap_trace_record(op, elapsed, 0, 0);
+        return;
+    }
+
+    if(len == TRACE_NUL_TERMINATED) len = strlen(key);
+
+    hash = hash_key(map, key, len, NULL);
+    bucket = bucket_at(map, hash % map->capacity);
+
+    if(bucket->tree != NULL)
+    {
+        // A sorted bucket is binary searched after its inline slots
+        for(size_t count = bucket->tree->count; count > 0; count >>= 1) probes++;
+        probes += BUCKET_SLOTS;
+    }
+    else
+    {
+        for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+        {
+            probes++;
+            if(current->hash == hash && key_compare_n(key, len, current->key) == 0) break;
+        }
+    }
+
+    hashmap_trace_record(op, elapsed, probes, bucket_count(bucket));
+}
+
+/**
+ * @brief Records the latency of an operation that removed a key, with the chain the key was removed from
+ * @details The removed key may have been freed with its value, so only its hash, taken beforehand, is used.
+ * Every key left in the chain counts as probed, like a miss.
+ * 
+ * @param op - the operation
+ * @param start - time the operation started
+ * @param map - the map, may be NULL
+ * @param hash - hash of the key
+ */
+static void trace_removed(hashmap_trace_op_t op, uint64_t start, const hashmap_t* map, uint64_t hash)
+{
+    uint64_t elapsed = hashmap_trace_now() - start;
+    size_t chain = (map != NULL) ? bucket_count(bucket_at(map, hash % map->capacity)) : 0;
+
+    hashmap_trace_record(op, elapsed, chain, chain);
+}
+#endif
+
+/**
+ * @brief Adds a new key-value pair to the map, for hashmap_push()
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS 
+ */
+static STATUS push_key(hashmap_t* map, const char* key, void* value)
+{
+    if(map == NULL || key == NULL || value == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t filter_hash = 0;
+    uint64_t hash = hash_key(map, key, strlen(key), &filter_hash);
+    size_t bucket_idx = hash % map->capacity;
+    size_t chain_length = 0;
+    bucket_t* bucket = NULL;
+    entry_t entry = { NULL, value, hash };
+    int multi = (map->config.flags & HASHMAP_FLAG_MULTI) != 0;
+
+    // Catch duplicate keys, the filter rules most new keys out without searching the bucket
+    if(bloom_may_contain(map, filter_hash) && bucket_find(bucket_at(map, bucket_idx), key, hash) != NULL)
+    {
+        if(!multi)
+        {
+            errno = HASHMAP_ERR_DUPLICATE;
+            return ERROR;
+        }
+
+        if(values_append(map, bucket_idx, key, hash, value) == ERROR)
+        {
+            errno = HASHMAP_ERR_ALLOC_FAILED;
+            return ERROR;
+        }
+
+        return SUCCESS;
+    }
+
+    bucket = bucket_for_write(map, bucket_idx);
+    entry.key = key_acquire(&map->config, key);
+    if(multi) entry.value = values_create(&value, 1);
+
+    // The index shares the stored key and can't fail once the key is in the bucket, so it goes in first
+    if(bucket == NULL || entry.key == NULL || entry.value == NULL ||
+       (map->index != NULL && hashmap_index_insert(map->index, entry.key) == ERROR))
+    {
+        entry_release(&map->config, &entry);
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
+    }
+
+    if(bucket_empty(bucket)) mark_dirty(map, bucket_idx);
+
+    if(bucket_add(bucket, entry.key, entry.value, hash) == ERROR)
+    {
+        if(map->index != NULL) hashmap_index_remove(map->index, entry.key);
+        entry_release(&map->config, &entry);
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
+    }
+
+    map->size++;
+
+    if(map->bloom != NULL)
+    {
+        bloom_add(map, filter_hash);
+        if(map->size > map->bloom_blocks * BLOOM_KEYS_PER_BLOCK) bloom_rebuild(map);
+    }
+
+    // Sorted buckets already bound the lookup cost, but a flood still deserves a new hash
+    chain_length = bucket_count(bucket);
+
+    if(chain_length > CHAIN_LIMIT && chain_length > 4 * (map->size / map->capacity + 1))
+    {
+        flooding_defense(map);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Add a new key-value pair to the map
+ * @details With HASHMAP_FLAG_MULTI, pushing a key that is already in the map appends value to its values
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS 
+ */
+STATUS hashmap_push(hashmap_t* map, const char* key, void* value)
+{
+    TRACE_BEGIN(start);
+    STATUS status = push_key(map, key, value);
+
+    TRACE_END(HASHMAP_TRACE_PUSH, start, map, key, TRACE_NUL_TERMINATED);
+    HASHMAP_USDT(push, map, key, status);
+
+    return status;
+}
+
+/**
+ * @brief Returns the value for the given key, for hashmap_get()
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for 
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+static void* get_key(const hashmap_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return NULL;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t filter_hash = 0;
+    uint64_t hash = hash_key(map, key, strlen(key), &filter_hash);
+    entry_t* current = NULL;
+
+    // Misses the filter rules out never touch the buckets
+    if(bloom_may_contain(map, filter_hash)) current = bucket_find(bucket_at(map, hash % map->capacity), key, hash);
+
+    if(current == NULL)
+    {
+        errno = HASHMAP_ERR_NOT_FOUND;
+        return NULL;
+    }
+
+    if(map->config.flags & HASHMAP_FLAG_MULTI) return ((values_t *)current->value)->items[0];
+
+    return current->value;
+}
+
+/**
+ * @brief Returns the value for a key given by its length, for hashmap_get_n()
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for, not NUL terminated
+ * @param len - length of the key
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+static void* get_key_n(const hashmap_t* map, const char* key, size_t len)
+{
+    if(map == NULL || key == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return NULL;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t filter_hash = 0;
+    uint64_t hash = 0;
+    entry_t* current = NULL;
+    size_t pos = 0;
+
+    // Stored keys end at their first NUL byte, so a key holding one can't be in the map
+    if(memchr(key, '\0', len) == NULL)
+    {
+        hash = hash_key(map, key, len, &filter_hash);
+        if(bloom_may_contain(map, filter_hash)) current = bucket_find_n(bucket_at(map, hash % map->capacity), key, len, hash, &pos);
+    }
+
+    if(current == NULL)
+    {
+        errno = HASHMAP_ERR_NOT_FOUND;
+        return NULL;
+    }
+
+    if(map->config.flags & HASHMAP_FLAG_MULTI) return ((values_t *)current->value)->items[0];
+
+    return current->value;
+}
+
+/**
+ * @brief Returns the value for the given key
+ * @details With HASHMAP_FLAG_MULTI this is the first value pushed that hasn't been deleted
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for 
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_get(const hashmap_t* map, const char* key)
+{
+    TRACE_BEGIN(start);
+    void* value = get_key(map, key);
+
+    TRACE_END(HASHMAP_TRACE_GET, start, map, key, TRACE_NUL_TERMINATED);
+    HASHMAP_USDT(get, map, key, value);
+
+    return value;
+}
+
+/**
+ * @brief Returns the value for a key given by its length, so callers need not copy it to add a NUL terminator
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for, not NUL terminated
+ * @param len - length of the key
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_get_n(const hashmap_t* map, const char* key, size_t len)
+{
+    TRACE_BEGIN(start);
+    void* value = get_key_n(map, key, len);
+
+    // A key holding a NUL byte was never looked up
+    TRACE_END(HASHMAP_TRACE_GET, start, map, (key != NULL && memchr(key, '\0', len) == NULL) ? key : NULL, len);
+    HASHMAP_USDT(get, map, key, value);
+
+    return value;
+}
+
+/**
+ * @brief Returns every value of the given key as one array
+ * @details With HASHMAP_FLAG_MULTI the values are in the order they were pushed. Otherwise a found key has one value.
+ * The array belongs to the map and is only valid until the map is next modified.
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @param values - set to the values, NULL if not found
+ * @param count - set to the number of values, 0 if not found
+ * @return STATUS 
+ */
+STATUS hashmap_get_all(const hashmap_t* map, const char* key, void* const** values, size_t* count)
+{
+    if(map == NULL || key == NULL || values == NULL || count == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t filter_hash = 0;
+    uint64_t hash = hash_key(map, key, strlen(key), &filter_hash);
+    entry_t* current = NULL;
+
+    *values = NULL;
+    *count = 0;
+
+    if(bloom_may_contain(map, filter_hash)) current = bucket_find(bucket_at(map, hash % map->capacity), key, hash);
+
+    if(current == NULL)
+    {
+        errno = HASHMAP_ERR_NOT_FOUND;
+        return ERROR;
+    }
+
+    *values = entry_values(&map->config, current, count);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Starts loading the bucket of key into the cache without waiting for it
+ * @details Issue this for upcoming keys a few operations ahead of looking them up, so the memory latency overlaps
+ * with other work. Hashing the key is the only cost. It's only a hint and has no effect on the map.
+ * 
+ * @param map - pointer to the map
+ * @param key - key that will be looked up soon
+ */
+void hashmap_prefetch(const hashmap_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t filter_hash = 0;
+    uint64_t hash = hash_key(map, key, strlen(key), &filter_hash);
+
+#if defined(__GNUC__) || defined(__clang__)
+    if(map->bloom != NULL) __builtin_prefetch(bloom_block(map, filter_hash), 0, 3);
+    __builtin_prefetch(bucket_at(map, hash % map->capacity), 0, 3);
+#else
+    (void)hash;
+    (void)filter_hash;
+#endif
+}
+
+/**
+ * @brief Deletes a key-value pair from the map, for hashmap_delete()
+ * 
+ * @param map - pointer to the map
+ * @param key - key to be deleted
+ * @param fn - optional function for freeing the value
+ * @return STATUS 
+ */
+static STATUS delete_key(hashmap_t* map, const char* key, free_value_fn_t fn)
+{
+    if(map == NULL || key == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t filter_hash = 0;
+    uint64_t hash = hash_key(map, key, strlen(key), &filter_hash);
+    size_t bucket_idx = hash % map->capacity;
+    bucket_t* bucket = NULL;
+    entry_t removed = {0};
+
+    // Only copy the bucket away from a snapshot if the key is really there
+    if(!bloom_may_contain(map, filter_hash) || bucket_find(bucket_at(map, bucket_idx), key, hash) == NULL)
+    {
+        errno = HASHMAP_ERR_NOT_FOUND;
+        return ERROR;
+    }
+
+    bucket = bucket_for_write(map, bucket_idx);
+
+    if(bucket == NULL)
+    {
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
+    }
+
+    // The bucket may have just been copied, so remove from the writable one
+    bucket_remove(bucket, key, hash, &removed);
+    if(map->index != NULL) hashmap_index_remove(map->index, key);
+
+    map->size--;
+
+    if(fn != NULL)
+    {
+        size_t count = 0;
+        void* const* values = entry_values(&map->config, &removed, &count);
+
+        for(size_t value_idx = 0; value_idx < count; value_idx++) fn(values[value_idx]);
+    }
+
+    entry_release(&map->config, &removed);
+
+    // Once deleted keys fill half of what the filter was sized for, rebuild it so misses are ruled out again. The
+    // filter has at least one key's room per bucket, so the walk over the buckets is paid for by as many deletes.
+    if(map->bloom != NULL && ++map->bloom_deleted > map->bloom_blocks * BLOOM_KEYS_PER_BLOCK / 2) bloom_rebuild(map);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Deletes a key-value pair from the map
+ * 
+ * @param map - pointer to the map
+ * @param key - key to be deleted
+ * @param fn - optional function for freeing the value. Can be left NULL if user plans to handle deallocation.
+ * @return STATUS 
+ */
+STATUS hashmap_delete(hashmap_t* map, const char* key, free_value_fn_t fn)
+{
+    // fn may free the key with its value, so it is only looked at beforehand
+    HASHMAP_USDT(delete, map, key, fn);
+    TRACE_HASH(hash, map, key);
+
+    TRACE_BEGIN(start);
+    STATUS status = delete_key(map, key, fn);
+
+    TRACE_END_REMOVED(HASHMAP_TRACE_DELETE, start, map, hash);
+
+    return status;
+}
+
+/**
+ * @brief Deletes one value of a key, and the key with its last value
+ * @details Meant for maps created with HASHMAP_FLAG_MULTI, where the other values keep their order. Values are
+ * compared by pointer. Without HASHMAP_FLAG_MULTI the key is deleted if value is its value.
+ * 
+ * @param map - pointer to the map
+ * @param key - key of the value
+ * @param value - value to be deleted
+ * @param fn - optional function for freeing the value. Can be left NULL if user plans to handle deallocation.
+ * @return STATUS 
+ */
+STATUS hashmap_delete_value(hashmap_t* map, const char* key, void* value, free_value_fn_t fn)
+{
+    if(map == NULL || key == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t filter_hash = 0;
+    uint64_t hash = hash_key(map, key, strlen(key), &filter_hash);
+    size_t bucket_idx = hash % map->capacity;
+    bucket_t* bucket = NULL;
+    entry_t* current = NULL;
+    values_t* block = NULL;
+    void* const* values = NULL;
+    size_t count = 0;
+    size_t value_idx = 0;
+
+    if(bloom_may_contain(map, filter_hash)) current = bucket_find(bucket_at(map, bucket_idx), key, hash);
+    if(current != NULL) values = entry_values(&map->config, current, &count);
+
+    while(value_idx < count && values[value_idx] != value) value_idx++;
+
+    if(value_idx == count)
+    {
+        errno = HASHMAP_ERR_NOT_FOUND;
+        return ERROR;
+    }
+
+    // The last value takes the key with it
+    if(count == 1) return delete_key(map, key, fn);
+
+    bucket = bucket_for_write(map, bucket_idx);
+
+    if(bucket == NULL)
+    {
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
+    }
+
+    // The bucket may have just been copied, so remove from the block of the writable one
+    block = (values_t *)bucket_find(bucket, key, hash)->value;
+    memmove(&block->items[value_idx], &block->items[value_idx + 1], (block->count - value_idx - 1) * sizeof(void *));
+    block->count--;
+
+    if(fn != NULL) fn(value);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Removes every key-value pair from the map, keeping its buckets for reuse
+ * @details Only buckets pushed to since the last clear are visited, so clearing a map that touched a few buckets
+ * costs O(touched) rather than O(capacity). If the map shares buckets with a snapshot, it gets a fresh bucket
+ * table instead and the snapshot keeps the old one.
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional function for freeing the values. Can be left NULL if user plans to handle deallocation.
+ * @return STATUS 
+ */
+STATUS hashmap_clear(hashmap_t* map, free_value_fn_t fn)
+{
+    if(map == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    dirty_unique(map);
+    size_t count = map->dirty_overflow ? map->capacity : map->dirty_count;
+    table_t* table = NULL;
+
+    // Allocate before touching anything so a failure leaves the map as it was
+    if(table_shared(map->table))
+    {
+        table = table_create(map->capacity, &map->config, &errno);
+        if(table == NULL) return ERROR;
+    }
+
+    for(size_t i = 0; i < count && map->size > 0; i++)
+    {
+        size_t bucket_idx = map->dirty_overflow ? i : map->dirty[i];
+        bucket_t* bucket = bucket_at(map, bucket_idx);
+        size_t pos = 0;
+
+        if(fn != NULL)
+        {
+            for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+            {
+                size_t value_count = 0;
+                void* const* values = entry_values(&map->config, current, &value_count);
+
+                for(size_t value_idx = 0; value_idx < value_count; value_idx++) fn(values[value_idx]);
+            }
+        }
+
+        // Nodes shared with a snapshot are left to it, the whole table is swapped below
+        if(table == NULL)
+        {
+            map->size -= bucket_count(bucket);
+            buckets_empty(bucket, 1, &map->config);
+        }
+    }
+
+    clear_finish(map, table);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Grows the map to at least capacity buckets ahead of pushing many keys
+ * @details Every key is rehashed into the new buckets. Asking for no more than the current capacity does nothing.
+ * 
+ * @param map - pointer to the map
+ * @param capacity - number of buckets wanted
+ * @return STATUS 
+ */
+STATUS hashmap_reserve(hashmap_t* map, size_t capacity)
+{
+    if(map == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return ERROR;
+    }
+
+    if(capacity > MAX_HASHMAP_CAPACITY || capacity == 0)
+    {
+        errno = HASHMAP_ERR_INVALID_CAPACITY;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+
+    if(capacity > map->capacity && table_rebuild(map, capacity, NULL) == ERROR)
+    {
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns a read-only snapshot of the map
+ * @details Creating the snapshot is O(1): it shares the map's bucket table. Later writes to the map copy
+ * only the segments of buckets they modify, so the snapshot keeps a consistent view that can be read
+ * without locks while the map keeps changing. Values are shared, not copied, and stay owned by the map.
+ * The snapshot must be taken by the thread that writes to the map and released with hashmap_destroy().
+ * 
+ * @param map - pointer to the map
+ * @return hashmap_t* - read-only view of the map. NULL if error.
+ */
+hashmap_t* hashmap_snapshot(hashmap_t* map)
+{
+    if(map == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return NULL;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    hashmap_t* snapshot = (hashmap_t *)malloc(sizeof(hashmap_t));
+
+    if(snapshot == NULL)
+    {
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return NULL;
+    }
+
+    *snapshot = *map;
+    snapshot->read_only = 1;
+    snapshot->dirty = NULL;
+    snapshot->dirty_count = 0;
+    snapshot->dirty_space = 0;
+    snapshot->bloom = NULL;
+    snapshot->bloom_blocks = 0;
+    snapshot->index = NULL;
+    atomic_fetch_add(&map->table->refs, 1);
+
+    return snapshot;
+}
+
+/**
+ * @brief Set the seed for this map
+ * @details Maps are seeded randomly when created, so this is only needed for reproducible hashing. Keys already
+ * in the map are rehashed with the new seed. With HASHMAP_FLAG_SIPHASH the SipHash key is derived from seed,
+ * otherwise the map goes back to Murmur3 even if the flooding defense had switched it to SipHash.
+ * 
+ * @param map - pointer to the map
+ * @param seed - the seed for the map
+ */
+void hashmap_set_seed(hashmap_t* map, uint64_t seed)
+{
+    if(map == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return;
+    }
+
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    uint64_t old_seed = map->seed;
+    uint64_t old_sip_key[2] = { map->sip_key[0], map->sip_key[1] };
+    int old_keyed = map->keyed;
+    size_t old_defense_size = map->defense_size;
+
+    // A caller picking the seed wants the hash it configured, and the defense to be ready to switch again
+    seed_map(map, seed);
+    map->keyed = (map->config.flags & HASHMAP_FLAG_SIPHASH) ? 1 : 0;
+    map->defense_size = 0;
+
+    if(map->size > 0 && table_rebuild(map, map->capacity, NULL) == ERROR)
+    {
+        map->seed = old_seed;
+        map->sip_key[0] = old_sip_key[0];
+        map->sip_key[1] = old_sip_key[1];
+        map->keyed = old_keyed;
+        map->defense_size = old_defense_size;
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+    }
+}
+
+/**
+ * @brief Fills stats with the size and bucket occupancy of the map
+ * 
+ * @param map - pointer to the map
+ * @param stats - filled with the statistics
+ * @return STATUS 
+ */
+STATUS hashmap_stats(const hashmap_t* map, hashmap_stats_t* stats)
+{
+    if(map == NULL || stats == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    stats->size = map->size;
+    stats->capacity = map->capacity;
+    stats->used_buckets = 0;
+    stats->max_chain = 0;
+
+    for(size_t bucket_idx = 0; bucket_idx < map->capacity; bucket_idx++)
+    {
+        size_t chain_length = bucket_count(bucket_at(map, bucket_idx));
+
+        if(chain_length > 0) stats->used_buckets++;
+        if(chain_length > stats->max_chain) stats->max_chain = chain_length;
+    }
+
+    return SUCCESS;
+}
 
-// Key-value pair in each bucket for collisions
-struct node
+/**
+ * @brief Returns the number of keys in the map, without walking the buckets like hashmap_stats()
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_size(const hashmap_t* map)
 {
-    char* key;          // Key of this node
-    void* value;        // Value of this node
-    node_t* next;  // Pointer to next node in this linked list in the event of a collision
-};
+    return (map != NULL) ? map->size : 0;
+}
 
-// Linked list for an index of the map
-struct bucket
+/**
+ * @brief Calls fn on every key-value pair of the map
+ * @details The order is unspecified. fn must not push to or delete from the map.
+ * 
+ * @param map - pointer to the map
+ * @param fn - function called with each key, its value and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS 
+ */
+STATUS hashmap_foreach(const hashmap_t* map, hashmap_foreach_fn_t fn, void* ctx)
 {
-    node_t* head;  // Pointer to the head of the linked list for this bucket
-};
+    if(map == NULL || fn == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
 
-// The hashmap structure. Obfuscated from the user
-struct hashmap
-{
-    size_t capacity;    // Maximum capacity of the map
-    size_t size;        // Current size of the map
-    bucket_t* buckets;  // Array of buckets for the map
-    uint32_t seed;      // Seed for the hashes
-};
+    errno = HASHMAP_ERR_NONE;
 
-static hashmap_err_t errno = HASHMAP_ERR_NONE;  // Last error from the hashmap library initialized to HASHMAP_ERR_NONE
+    for(size_t bucket_idx = 0; bucket_idx < map->capacity; bucket_idx++)
+    {
+        const bucket_t* bucket = bucket_at(map, bucket_idx);
+        size_t pos = 0;
 
-//---------------------------------------------------------------------------------------------------------
+        for(entry_t* current = bucket_next(bucket, NULL, &pos); current != NULL; current = bucket_next(bucket, current, &pos))
+        {
+            size_t count = 0;
+            void* const* values = entry_values(&map->config, current, &count);
+
+            for(size_t value_idx = 0; value_idx < count; value_idx++) fn(current->key, values[value_idx], ctx);
+        }
+    }
+
+    return SUCCESS;
+}
 
 /**
- * @brief Creates the hashmap_t object and returns the handle
+ * @brief Moves iter to the next key-value pair of the map
+ * @details Start with a zeroed hashmap_iter_t. The order is the one of hashmap_foreach(), and with
+ * HASHMAP_FLAG_MULTI every value of a key is returned in turn. The map must not be pushed to or deleted from
+ * while iterating.
  * 
- * @param capacity - max number of unique indexes for the map 
- * @return hashmap_t* - pointer to the hashmap_t object. NULL if error.
+ * @param map - pointer to the map
+ * @param iter - position in the map, updated
+ * @param key - optional, set to the key
+ * @param value - optional, set to the value
+ * @return STATUS - ERROR with HASHMAP_ERR_NOT_FOUND once every pair was returned
  */
-hashmap_t* hashmap_create(size_t capacity)
+STATUS hashmap_iter_next(const hashmap_t* map, hashmap_iter_t* iter, const char** key, void** value)
 {
+    if(map == NULL || iter == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
     errno = HASHMAP_ERR_NONE;
-    hashmap_t* map = NULL;
+    const entry_t* current = (const entry_t *)iter->entry;
+    void* const* values = NULL;
+    size_t count = 0;
 
-    // Check for valid capacity
-    if(capacity <= MAX_HASHMAP_CAPACITY && capacity > 0)
-    {
-        map = (hashmap_t *)malloc(sizeof(hashmap_t));
+    // The rest of the values of the key returned last
+    if(current != NULL) values = entry_values(&map->config, current, &count);
 
-        // Check memory allocation succeeded
-        if(map != NULL)
-        {
-            map->capacity = capacity;
-            map->size = 0;
-            map->buckets = (bucket_t *)calloc(capacity, sizeof(bucket_t));
-            map->seed = 0;
+    while(iter->value_idx >= count && iter->bucket < map->capacity)
+    {
+        current = bucket_next(bucket_at(map, iter->bucket), current, &iter->pos);
 
-            // Check that the buckets array was allocated successfully
-            if(map->buckets == NULL)
-            {
-                free(map);
-                map = NULL;
-                errno = HASHMAP_ERR_ALLOC_FAILED;
-            }
-        }
-        else
+        if(current == NULL)
         {
-            errno = HASHMAP_ERR_ALLOC_FAILED;
+            iter->bucket++;
+            iter->pos = 0;
+            continue;
         }
+
+        values = entry_values(&map->config, current, &count);
+        iter->value_idx = 0;
     }
-    else
+
+    iter->entry = current;
+
+    if(iter->value_idx >= count)
     {
-        errno = HASHMAP_ERR_INVALID_CAPACITY;
+        errno = HASHMAP_ERR_NOT_FOUND;
+        return ERROR;
     }
 
-    return map;
+    if(key != NULL) *key = current->key;
+    if(value != NULL) *value = values[iter->value_idx];
+    iter->value_idx++;
+
+    return SUCCESS;
 }
 
 /**
- * @brief Safely deallocates map. User can optionally provide a function for freeing values.
+ * @brief Moves iter to a key, as if hashmap_iter_next() had just returned its first value
  * 
  * @param map - pointer to the map
- * @param fn - optional pointer to function for freeing values. Can pass NULL to not have library handle freeing values.
+ * @param key - key to move to, not NUL terminated
+ * @param len - length of the key
+ * @param iter - set to the position of the key
+ * @return STATUS - ERROR with HASHMAP_ERR_NOT_FOUND if the key is not in the map
  */
-void hashmap_destroy(hashmap_t* map, free_value_fn_t fn)
+STATUS hashmap_iter_seek(const hashmap_t* map, const char* key, size_t len, hashmap_iter_t* iter)
 {
+    if(map == NULL || key == NULL || iter == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
     errno = HASHMAP_ERR_NONE;
+    uint64_t hash = 0;
+    entry_t* current = NULL;
+    size_t pos = 0;
 
-    if(map != NULL)
+    if(memchr(key, '\0', len) == NULL)
     {
-        if(map->buckets != NULL)
-        {
-            // Index through the linked list of all buckets
-            for(size_t bucket_idx = 0; bucket_idx < map->capacity; bucket_idx++)
-            {
-                node_t* current = map->buckets[bucket_idx].head;
+        hash = hash_key(map, key, len, NULL);
+        current = bucket_find_n(bucket_at(map, hash % map->capacity), key, len, hash, &pos);
+    }
 
-                while(current != NULL)
-                {
-                    node_t* next = current->next;
+    if(current == NULL)
+    {
+        errno = HASHMAP_ERR_NOT_FOUND;
+        return ERROR;
+    }
 
-                    free(current->key);
-                    if(fn != NULL) fn(current->value);
-                    free(current);
-                    current = next;
-                }
-            }
+    iter->bucket = hash % map->capacity;
+    iter->pos = pos;
+    iter->entry = current;
+    iter->value_idx = 1;
 
-            free(map->buckets);
-        }
+    return SUCCESS;
+}
 
-        free(map);
-    }
+/**
+ * @brief Calls the user's function on every value of a key found by a scan
+ * 
+ * @param key - key from the ordered index
+ * @param arg - the scan_ctx_t of the scan
+ */
+static void scan_visit(const char* key, void* arg)
+{
+    const scan_ctx_t* scan = (const scan_ctx_t *)arg;
+    uint64_t hash = hash_key(scan->map, key, strlen(key), NULL);
+    const entry_t* entry = bucket_find(bucket_at(scan->map, hash % scan->map->capacity), key, hash);
+    size_t count = 0;
+    void* const* values = NULL;
+
+    if(entry == NULL) return;
+
+    values = entry_values(&scan->map->config, entry, &count);
+
+    for(size_t value_idx = 0; value_idx < count; value_idx++) scan->fn(entry->key, values[value_idx], scan->ctx);
 }
 
 /**
- * @brief Add a new key-value pair to the map
+ * @brief Calls fn on every key-value pair whose key starts with prefix, in strcmp() order of the keys
+ * @details Needs a map created with HASHMAP_FLAG_ORDERED. Costs O(strlen(prefix)) plus O(1) per pair visited,
+ * however many keys the map holds. Snapshots have no index. fn must not add to or delete from the map.
  * 
  * @param map - pointer to the map
- * @param key - key for the pair
- * @param value - value for the pair
- * @return STATUS 
+ * @param prefix - prefix of the keys, "" for every key
+ * @param fn - function called with each key, its value and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS - ERROR with HASHMAP_ERR_INVALID_CONFIG if the map has no ordered index
  */
-STATUS hashmap_push(hashmap_t* map, const char* key, void* value)
+STATUS hashmap_prefix_scan(const hashmap_t* map, const char* prefix, hashmap_foreach_fn_t fn, void* ctx)
 {
-    if(map == NULL || key == NULL || value == NULL)
+    if(map == NULL || prefix == NULL || fn == NULL)
     {
         errno = HASHMAP_ERR_NULL_ARG;
         return ERROR;
     }
 
+    if(map->index == NULL)
+    {
+        errno = HASHMAP_ERR_INVALID_CONFIG;
+        return ERROR;
+    }
+
     errno = HASHMAP_ERR_NONE;
-    uint32_t hash[4] = {0};
-    size_t bucket_idx = 0;
-    node_t* node = NULL;
-    node = (node_t *)malloc(sizeof(node_t));
+    scan_ctx_t scan = { map, fn, ctx };
 
-    if(node == NULL)
+    if(hashmap_index_prefix(map->index, prefix, scan_visit, &scan) == ERROR)
     {
         errno = HASHMAP_ERR_ALLOC_FAILED;
         return ERROR;
     }
 
-    // Catch duplicate keys
-    if(hashmap_get(map, key) != NULL)
+    return SUCCESS;
+}
+
+/**
+ * @brief Calls fn on every key-value pair with low <= key < high, in strcmp() order of the keys
+ * @details Needs a map created with HASHMAP_FLAG_ORDERED. Costs O(strlen(low)) plus O(1) per pair visited.
+ * Snapshots have no index. fn must not add to or delete from the map.
+ * 
+ * @param map - pointer to the map
+ * @param low - inclusive lower bound, NULL for none
+ * @param high - exclusive upper bound, NULL for none
+ * @param fn - function called with each key, its value and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS - ERROR with HASHMAP_ERR_INVALID_CONFIG if the map has no ordered index
+ */
+STATUS hashmap_range_scan(const hashmap_t* map, const char* low, const char* high, hashmap_foreach_fn_t fn, void* ctx)
+{
+    if(map == NULL || fn == NULL)
     {
-        errno = HASHMAP_ERR_DUPLICATE;
+        errno = HASHMAP_ERR_NULL_ARG;
         return ERROR;
     }
 
-    hash_func((void *)key, strlen(key), map->seed, hash);
-    bucket_idx = hash[0] % map->capacity;
+    if(map->index == NULL)
+    {
+        errno = HASHMAP_ERR_INVALID_CONFIG;
+        return ERROR;
+    }
 
-    node->key = strdup(key);
+    errno = HASHMAP_ERR_NONE;
+    scan_ctx_t scan = { map, fn, ctx };
 
-    // Although unlikely, strdup() could return NULL
-    if(node->key == NULL)
+    if(hashmap_index_range(map->index, low, high, scan_visit, &scan) == ERROR)
     {
-        free(node);
         errno = HASHMAP_ERR_ALLOC_FAILED;
         return ERROR;
     }
 
-    node->value = value;
+    return SUCCESS;
+}
 
-    // Insert into bucket at head of linked list
-    node->next = map->buckets[bucket_idx].head;
-    map->buckets[bucket_idx].head = node;
-    map->size++;
+/**
+ * @brief Deallocates map like hashmap_destroy(), splitting the buckets over several threads
+ * @details fn is called from several threads at once and must be safe for that. If the work cannot be handed
+ * out, the map is destroyed on the calling thread instead.
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional function for freeing values
+ * @param parallel - thread options, NULL for the defaults
+ */
+void hashmap_destroy_parallel(hashmap_t* map, free_value_fn_t fn, const hashmap_parallel_t* parallel)
+{
+    errno = HASHMAP_ERR_NONE;
 
-    return SUCCESS;
+    if(map == NULL) return;
+
+    // Nodes still shared with a snapshot are freed when the snapshot is destroyed
+    sweep_ctx_t sweep = { map, NULL, map->read_only ? NULL : fn, !map->read_only && !table_shared(map->table) };
+
+    if((sweep.fn != NULL || sweep.free_nodes) && hashmap_pool_for(map->capacity, parallel, sweep_range, &sweep) == ERROR)
+    {
+        hashmap_destroy(map, fn);
+        return;
+    }
+
+    hashmap_destroy(map, NULL);
 }
 
 /**
- * @brief Returns the value for the given key
+ * @brief Hands map to a background thread to be destroyed, so the caller does not wait for the buckets to be freed
+ * @details The map must not be used once passed here, and fn is called from the background thread. If the
+ * work cannot be handed off, the map is destroyed on the calling thread instead.
  * 
  * @param map - pointer to the map
- * @param key - key to search for 
- * @return void* - NULL if not found, pointer to value otherwise
+ * @param fn - optional function for freeing values
  */
-void* hashmap_get(const hashmap_t* map, const char* key)
+void hashmap_destroy_deferred(hashmap_t* map, free_value_fn_t fn)
 {
-    if(map == NULL || key == NULL)
+    errno = HASHMAP_ERR_NONE;
+
+    if(map == NULL) return;
+
+    deferred_destroy_t* deferred = (deferred_destroy_t *)malloc(sizeof(deferred_destroy_t));
+
+    if(deferred != NULL)
+    {
+        deferred->map = map;
+        deferred->fn = fn;
+
+        if(hashmap_pool_defer(deferred_destroy, deferred) == SUCCESS) return;
+
+        free(deferred);
+    }
+
+    hashmap_destroy(map, fn);
+}
+
+/**
+ * @brief Waits for every map passed to hashmap_destroy_deferred() to be destroyed
+ * 
+ */
+void hashmap_deferred_wait(void)
+{
+    hashmap_pool_wait();
+}
+
+/**
+ * @brief Removes every key-value pair from the map like hashmap_clear(), splitting the buckets over several threads
+ * @details fn is called from several threads at once and must be safe for that
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional function for freeing the values
+ * @param parallel - thread options, NULL for the defaults
+ * @return STATUS 
+ */
+STATUS hashmap_clear_parallel(hashmap_t* map, free_value_fn_t fn, const hashmap_parallel_t* parallel)
+{
+    if(map == NULL)
     {
         errno = HASHMAP_ERR_NULL_ARG;
-        return NULL;
+        return ERROR;
+    }
+
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return ERROR;
     }
 
     errno = HASHMAP_ERR_NONE;
-    uint32_t hash[4] = {0};
-    hash_func((void *)key, strlen(key), map->seed, hash);
-    size_t bucket_idx = hash[0] % map->capacity;
-    node_t* current = map->buckets[bucket_idx].head;
 
-    // Loop until end of list is reached or node with same key is found
-    while((current != NULL) && (strcmp(current->key, key) != 0))
+    // Each bucket must go to exactly one worker
+    dirty_unique(map);
+
+    size_t count = map->dirty_overflow ? map->capacity : map->dirty_count;
+    table_t* table = NULL;
+    sweep_ctx_t sweep = { map, map->dirty_overflow ? NULL : map->dirty, fn, !table_shared(map->table) };
+
+    // Allocate before touching anything so a failure leaves the map as it was
+    if(!sweep.free_nodes)
     {
-        current = current->next;
+        table = table_create(map->capacity, &map->config, &errno);
+        if(table == NULL) return ERROR;
     }
 
-    if(current == NULL)
+    if(map->size > 0 && (fn != NULL || sweep.free_nodes) && hashmap_pool_for(count, parallel, sweep_range, &sweep) == ERROR)
     {
-        errno = HASHMAP_ERR_NOT_FOUND;
-        return NULL;
+        if(table != NULL) table_release(table);
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
     }
 
-    return current->value;
+    clear_finish(map, table);
+
+    return SUCCESS;
 }
 
 /**
- * @brief Deletes a key-value pair from the map
+ * @brief Grows the map like hashmap_reserve(), rehashing the keys on several threads
  * 
  * @param map - pointer to the map
- * @param key - key to be deleted
- * @param fn - optional function for freeing the value. Can be left NULL if user plans to handle deallocation.
+ * @param capacity - number of buckets wanted
+ * @param parallel - thread options, NULL for the defaults
  * @return STATUS 
  */
-STATUS hashmap_delete(hashmap_t* map, const char* key, free_value_fn_t fn)
+STATUS hashmap_reserve_parallel(hashmap_t* map, size_t capacity, const hashmap_parallel_t* parallel)
 {
-    if(map == NULL || key == NULL)
+    if(map == NULL)
     {
         errno = HASHMAP_ERR_NULL_ARG;
         return ERROR;
     }
 
-    errno = HASHMAP_ERR_NONE;
-    uint32_t hash[4] = {0};
-    hash_func((void *)key, strlen(key), map->seed, hash);
-    size_t bucket_idx = hash[0] % map->capacity;
-    node_t* current = map->buckets[bucket_idx].head;
-    node_t* prev = NULL;
+    if(map->read_only)
+    {
+        errno = HASHMAP_ERR_READ_ONLY;
+        return ERROR;
+    }
 
-    // Find the node to be deleted
-    while((current != NULL) && (strcmp(current->key, key) != 0))
+    if(capacity > MAX_HASHMAP_CAPACITY || capacity == 0)
     {
-        prev = current;
-        current = current->next;
+        errno = HASHMAP_ERR_INVALID_CAPACITY;
+        return ERROR;
     }
 
-    if(current == NULL)
+    errno = HASHMAP_ERR_NONE;
+
+    if(capacity > map->capacity && table_rebuild(map, capacity, (parallel != NULL) ? parallel : &parallel_defaults) == ERROR)
     {
-        errno = HASHMAP_ERR_NOT_FOUND;
+        errno = HASHMAP_ERR_ALLOC_FAILED;
         return ERROR;
     }
 
-    // Check if this node is the head of the list
-    if(prev == NULL)
+    return SUCCESS;
+}
+
+/**
+ * @brief Fills stats like hashmap_stats(), walking the buckets on several threads
+ * 
+ * @param map - pointer to the map
+ * @param stats - filled with the statistics
+ * @param parallel - thread options, NULL for the defaults
+ * @return STATUS 
+ */
+STATUS hashmap_stats_parallel(const hashmap_t* map, hashmap_stats_t* stats, const hashmap_parallel_t* parallel)
+{
+    if(map == NULL || stats == NULL)
     {
-        // Make next node the new head of the list
-        map->buckets[bucket_idx].head = current->next;
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
     }
-    else
+
+    errno = HASHMAP_ERR_NONE;
+    size_t workers = hashmap_pool_workers(parallel);
+    stats_ctx_t ctx = { map, (hashmap_stats_t *)calloc(workers, sizeof(hashmap_stats_t)) };
+
+    if(ctx.partial == NULL || hashmap_pool_for(map->capacity, parallel, stats_range, &ctx) == ERROR)
     {
-        // Else, make next of prev to next of current
-        prev->next = current->next;
+        free(ctx.partial);
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
     }
 
-    map->size--;
+    stats->size = map->size;
+    stats->capacity = map->capacity;
+    stats->used_buckets = 0;
+    stats->max_chain = 0;
 
-    // Free current
-    free(current->key);
-    if(fn != NULL) fn(current->value);
-    free(current);
+    for(size_t worker = 0; worker < workers; worker++)
+    {
+        stats->used_buckets += ctx.partial[worker].used_buckets;
+        if(ctx.partial[worker].max_chain > stats->max_chain) stats->max_chain = ctx.partial[worker].max_chain;
+    }
+
+    free(ctx.partial);
 
     return SUCCESS;
 }
 
 /**
- * @brief Set the seed for this map
+ * @brief Calls fn on every key-value pair of the map like hashmap_foreach(), splitting the buckets over several threads
+ * @details The order is unspecified. fn is called from several threads at once and must be safe for that. It
+ * must not push to or delete from the map.
  * 
  * @param map - pointer to the map
- * @param seed - the seed for the map
+ * @param fn - function called with each key, its value and ctx
+ * @param ctx - passed through to fn
+ * @param parallel - thread options, NULL for the defaults
+ * @return STATUS 
  */
-void hashmap_set_seed(hashmap_t* map, size_t seed)
+STATUS hashmap_foreach_parallel(const hashmap_t* map, hashmap_foreach_fn_t fn, void* ctx, const hashmap_parallel_t* parallel)
 {
-    map->seed = seed;
+    if(map == NULL || fn == NULL)
+    {
+        errno = HASHMAP_ERR_NULL_ARG;
+        return ERROR;
+    }
+
+    errno = HASHMAP_ERR_NONE;
+    scan_ctx_t scan = { map, fn, ctx };
+
+    if(hashmap_pool_for(map->capacity, parallel, foreach_range, &scan) == ERROR)
+    {
+        errno = HASHMAP_ERR_ALLOC_FAILED;
+        return ERROR;
+    }
+
+    return SUCCESS;
 }
 
 /**
@@ -311,21 +3022,47 @@ hashmap_err_t hashmap_errno(void)
 }
 
 /**
- * @brief Returns the current errno in string format
+ * @brief Sets errno from the other translation units of the library
  * 
- * @return const char* - error number in string format
+ * @param err - the new errno
  */
-const char* hashmap_strerror(void)
+void hashmap_set_errno(hashmap_err_t err)
+{
+    errno = err;
+}
+
+/**
+ * @brief Returns an error code in string format
+ * 
+ * @param err - the error code, for example one kept from hashmap_errno() or carried by an exception
+ * @return const char* - error code in string format
+ */
+const char* hashmap_err_str(hashmap_err_t err)
 {
-    switch(errno)
+    switch(err)
     {
         case HASHMAP_ERR_NONE:          return (char *)"NO ERROR";
+        case HASHMAP_ERR_INVALID_CAPACITY: return (char *)"INVALID CAPACITY";
         case HASHMAP_ERR_NULL_ARG:      return (char *)"NULL ARGUMENT";
         case HASHMAP_ERR_ALLOC_FAILED:  return (char *)"MEMORY ALLOCATION FAILURE";
         case HASHMAP_ERR_NOT_FOUND:     return (char *)"KEY NOT FOUND";
         case HASHMAP_ERR_DUPLICATE:     return (char *)"DUPLICATE KEY";
+        case HASHMAP_ERR_INVALID_CONFIG: return (char *)"INVALID CONFIGURATION";
+        case HASHMAP_ERR_READ_ONLY:     return (char *)"MAP IS READ-ONLY";
+        case HASHMAP_ERR_CONFLICT:      return (char *)"VALUE DID NOT MATCH";
+        case HASHMAP_ERR_IO:            return (char *)"FILE I/O FAILURE";
         default:                        return (char *)"UNKNOWN ERROR";
     }
 }
 
+/**
+ * @brief Returns the current errno in string format
+ * 
+ * @return const char* - error number in string format
+ */
+const char* hashmap_strerror(void)
+{
+    return hashmap_err_str(errno);
+}
+
 //---------------------------------------------------------------------------------------------------------
@@ -0,0 +1,234 @@
+/**
+ * @file hashmap_alloc.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Allocates the zeroed tables behind a hashmap, optionally on huge pages and/or a chosen NUMA policy
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hashmap_alloc.h"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #define HASHMAP_HAVE_MMAP 1
+#else
+    #define HASHMAP_HAVE_MMAP 0
+#endif
+
+#define HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024) // 2MB, the x86_64/aarch64 PMD page size
+#define MAX_NUMA_NODES 1024                      // Size of the node mask handed to mbind()
+#define CACHE_LINE 64                            // Alignment of tables that don't go through mmap()
+
+// Values from linux/mempolicy.h, repeated here to avoid depending on the kernel headers
+#define HASHMAP_MPOL_BIND       2
+#define HASHMAP_MPOL_INTERLEAVE 3
+
+#define HASHMAP_MMAP_FLAGS (HASHMAP_FLAG_HUGEPAGE | HASHMAP_FLAG_HUGETLB | HASHMAP_FLAG_NUMA_INTERLEAVE | HASHMAP_FLAG_NUMA_BIND)
+
+//---------------------------------------------------------------------------------------------------------
+
+#if HASHMAP_HAVE_MMAP
+
+/**
+ * @brief Fills mask with the online NUMA nodes listed in sysfs (e.g. "0-3,6")
+ * 
+ * @param mask - node mask to fill, MAX_NUMA_NODES bits wide
+ * @return STATUS - ERROR if the node list could not be read
+ */
+static STATUS read_online_nodes(unsigned long* mask)
+{
+    FILE* file = fopen("/sys/devices/system/node/online", "r");
+    const size_t bits = 8 * sizeof(unsigned long);
+    unsigned int first = 0;
+    unsigned int last = 0;
+    int found = 0;
+
+    if(file == NULL) return ERROR;
+
+    while(fscanf(file, "%u", &first) == 1)
+    {
+        last = first;
+
+        if(fgetc(file) == '-')
+        {
+            if(fscanf(file, "%u", &last) != 1) break;
+            fgetc(file);
+        }
+
+        for(unsigned int node = first; node <= last && node < MAX_NUMA_NODES; node++)
+        {
+            mask[node / bits] |= 1UL << (node % bits);
+            found = 1;
+        }
+    }
+
+    fclose(file);
+    return found ? SUCCESS : ERROR;
+}
+
+/**
+ * @brief Applies the NUMA policy requested in config to [addr, addr + length)
+ * @details Interleaving is best effort since it only affects performance. Binding to an explicit node
+ * fails if the kernel rejects the node.
+ * 
+ * @param addr - page aligned start of the range
+ * @param length - length of the range in bytes
+ * @param config - creation options
+ * @return STATUS 
+ */
+static STATUS apply_numa_policy(void* addr, size_t length, const hashmap_config_t* config)
+{
+    unsigned long mask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = {0};
+    const size_t bits = 8 * sizeof(unsigned long);
+
+    if(config->flags & HASHMAP_FLAG_NUMA_BIND)
+    {
+        if(config->numa_node < 0 || config->numa_node >= MAX_NUMA_NODES) return ERROR;
+
+        mask[config->numa_node / bits] |= 1UL << (config->numa_node % bits);
+        return (syscall(SYS_mbind, addr, length, HASHMAP_MPOL_BIND, mask, MAX_NUMA_NODES + 1, 0) == 0) ? SUCCESS : ERROR;
+    }
+
+    if((config->flags & HASHMAP_FLAG_NUMA_INTERLEAVE) && read_online_nodes(mask) == SUCCESS)
+    {
+        syscall(SYS_mbind, addr, length, HASHMAP_MPOL_INTERLEAVE, mask, MAX_NUMA_NODES + 1, 0);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Maps an anonymous region of at least size bytes aligned to a huge page boundary
+ * @details Tries explicit huge pages first when asked to, then falls back to regular pages. The region is
+ * over-allocated by one huge page and trimmed so transparent huge pages can back it from the first byte.
+ * 
+ * @param mem - allocation record to fill
+ * @param size - number of bytes needed
+ * @param config - creation options
+ * @return hashmap_err_t - HASHMAP_ERR_INVALID_CONFIG if the NUMA policy was rejected
+ */
+static hashmap_err_t mem_map(hashmap_mem_t* mem, size_t size, const hashmap_config_t* config)
+{
+    size_t length = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    void* base = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if(config->flags & HASHMAP_FLAG_HUGETLB)
+    {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if(base != MAP_FAILED)
+        {
+            mem->ptr = base;
+            mem->base = base;
+            mem->length = length;
+        }
+    }
+#endif
+
+    if(base == MAP_FAILED)
+    {
+        uintptr_t aligned = 0;
+        size_t head = 0;
+
+        base = mmap(NULL, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(base == MAP_FAILED) return HASHMAP_ERR_ALLOC_FAILED;
+
+        // Trim the unaligned head and the unused tail of the mapping
+        aligned = ((uintptr_t)base + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+        head = aligned - (uintptr_t)base;
+        if(head > 0) munmap(base, head);
+        munmap((char *)aligned + length, HUGE_PAGE_SIZE - head);
+
+        mem->ptr = (void *)aligned;
+        mem->base = (void *)aligned;
+        mem->length = length;
+
+#ifdef MADV_HUGEPAGE
+        if(config->flags & (HASHMAP_FLAG_HUGEPAGE | HASHMAP_FLAG_HUGETLB)) madvise(mem->base, length, MADV_HUGEPAGE);
+#endif
+    }
+
+    // Policy has to be set before the first touch; anonymous mappings are populated lazily
+    if(apply_numa_policy(mem->base, mem->length, config) == ERROR)
+    {
+        munmap(mem->base, mem->length);
+        mem->base = NULL;
+        return HASHMAP_ERR_INVALID_CONFIG;
+    }
+
+    return HASHMAP_ERR_NONE;
+}
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a zeroed table of count elements of size bytes each
+ * 
+ * @param mem - allocation record to fill, passed to hashmap_mem_free() later
+ * @param count - number of elements
+ * @param size - size of each element
+ * @param config - optional creation options. NULL allocates cache line aligned memory from the heap.
+ * @return hashmap_err_t - HASHMAP_ERR_NONE, HASHMAP_ERR_ALLOC_FAILED or HASHMAP_ERR_INVALID_CONFIG
+ */
+hashmap_err_t hashmap_mem_alloc(hashmap_mem_t* mem, size_t count, size_t size, const hashmap_config_t* config)
+{
+    mem->ptr = NULL;
+    mem->size = count * size;
+    mem->base = NULL;
+    mem->length = 0;
+
+    if(size != 0 && count > SIZE_MAX / size) return HASHMAP_ERR_ALLOC_FAILED;
+
+#if HASHMAP_HAVE_MMAP
+    if(config != NULL && (config->flags & HASHMAP_MMAP_FLAGS))
+    {
+        return mem_map(mem, mem->size, config);
+    }
+#else
+    if(config != NULL && (config->flags & HASHMAP_FLAG_NUMA_BIND)) return HASHMAP_ERR_INVALID_CONFIG;
+#endif
+
+    // Cache line aligned so no element of a line-sized table straddles two lines. aligned_alloc() wants a
+    // multiple of the alignment.
+    mem->ptr = aligned_alloc(CACHE_LINE, (mem->size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+    if(mem->ptr != NULL) memset(mem->ptr, 0, mem->size);
+
+    return (mem->ptr != NULL) ? HASHMAP_ERR_NONE : HASHMAP_ERR_ALLOC_FAILED;
+}
+
+/**
+ * @brief Releases a table allocated by hashmap_mem_alloc()
+ * 
+ * @param mem - allocation record
+ */
+void hashmap_mem_free(hashmap_mem_t* mem)
+{
+#if HASHMAP_HAVE_MMAP
+    if(mem->base != NULL)
+    {
+        munmap(mem->base, mem->length);
+    }
+    else
+#endif
+    {
+        free(mem->ptr);
+    }
+
+    mem->ptr = NULL;
+    mem->base = NULL;
+}
+
+//---------------------------------------------------------------------------------------------------------
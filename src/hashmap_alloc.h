@@ -0,0 +1,34 @@
+/**
+ * @file hashmap_alloc.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Internal allocator for large hashmap tables (huge pages, NUMA placement)
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_ALLOC_H
+#define _C_HASH_MAP_ALLOC_H
+
+#include <stddef.h>
+
+#include "hashmap.h"
+
+/**
+ * @brief Describes how a table was allocated so it can be released the same way
+ * 
+ */
+typedef struct HASHMAP_MEM
+{
+    void* ptr;      // Start of the zeroed table
+    size_t size;    // Size requested by the caller in bytes
+    void* base;     // Start of the mapping when mmap() was used, NULL when calloc() was used
+    size_t length;  // Length of the mapping when mmap() was used
+}hashmap_mem_t;
+
+hashmap_err_t hashmap_mem_alloc(hashmap_mem_t* mem, size_t count, size_t size, const hashmap_config_t* config);
+void hashmap_mem_free(hashmap_mem_t* mem);
+
+#endif
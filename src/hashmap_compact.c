@@ -0,0 +1,563 @@
+/**
+ * @file hashmap_compact.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Compact hashmap laid out like CPython's dict: a sparse index of 8, 16 or 32 bit slot numbers pointing
+ * into a dense, append-only array of entries. Key bytes are packed into a chunked arena instead of being
+ * allocated one by one, and iteration is a linear scan in insertion order.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap_compact.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#define INDEX_EMPTY 0           // Index slot never used
+#define INDEX_DUMMY 1           // Index slot whose entry was deleted, probing continues past it
+#define INDEX_OFFSET 2          // Index slots hold entry number + INDEX_OFFSET
+#define MIN_INDEX_SLOTS 8       // Smallest index, must be a power of 2
+#define ARENA_CHUNK_SIZE 65536  // Default size of a chunk of key bytes
+#define MAX_COMPACT_ENTRIES ((size_t)UINT32_MAX - INDEX_OFFSET) // Largest entry number a 32 bit slot can hold
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct entry entry_t;
+typedef struct arena_chunk arena_chunk_t;
+
+// Key-value pair in the dense entry array. A NULL key marks a deleted entry.
+struct entry
+{
+    const char* key;    // Key of this entry, stored in the arena
+    void* value;        // Value of this entry
+    uint32_t hash;      // Hash of the key, kept so the index can be rebuilt without rehashing
+    uint32_t key_len;   // Length of the key
+};
+
+// Block of key bytes. Keys never move while their chunk is alive.
+struct arena_chunk
+{
+    arena_chunk_t* next;    // Previously filled chunk
+    size_t used;            // Bytes handed out
+    size_t space;           // Bytes available in data
+    char data[];            // Key bytes, each key NUL terminated
+};
+
+// The compact hashmap structure. Obfuscated from the user
+struct hashmap_compact
+{
+    size_t size;            // Number of live keys
+    size_t used;            // Number of entries appended, live or deleted
+    size_t entry_space;     // Number of entries allocated, 2/3 of the index slots
+    size_t mask;            // Number of index slots - 1, the slot count is a power of 2
+    size_t width;           // Bytes per index slot: 1, 2 or 4
+    void* index;            // Sparse index of entry numbers
+    entry_t* entries;       // Dense entries in insertion order
+    arena_chunk_t* arena;   // Chunk that new keys are stored in
+    size_t arena_bytes;     // Bytes handed out over all chunks
+    size_t garbage;         // Bytes of deleted keys still in the arena
+    uint64_t seed;          // Seed for the hashes
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hashes a key with the map's seed
+ * 
+ * @param map - pointer to the map
+ * @param key - key to hash
+ * @param len - length of the key
+ * @return uint32_t - the hash
+ */
+static inline uint32_t hash_key(const hashmap_compact_t* map, const char* key, size_t len)
+{
+    uint64_t hash[2] = {0};
+
+    MurmurHash3_x64_128_seed64(key, (int)len, map->seed, hash);
+
+    return (uint32_t)hash[0];
+}
+
+/**
+ * @brief Reads an index slot
+ * 
+ * @param map - pointer to the map
+ * @param slot_idx - slot to read
+ * @return size_t - INDEX_EMPTY, INDEX_DUMMY or entry number + INDEX_OFFSET
+ */
+static inline size_t index_get(const hashmap_compact_t* map, size_t slot_idx)
+{
+    switch(map->width)
+    {
+        case 1:  return ((const uint8_t *)map->index)[slot_idx];
+        case 2:  return ((const uint16_t *)map->index)[slot_idx];
+        default: return ((const uint32_t *)map->index)[slot_idx];
+    }
+}
+
+/**
+ * @brief Writes an index slot
+ * 
+ * @param map - pointer to the map
+ * @param slot_idx - slot to write
+ * @param value - INDEX_EMPTY, INDEX_DUMMY or entry number + INDEX_OFFSET
+ */
+static inline void index_set(hashmap_compact_t* map, size_t slot_idx, size_t value)
+{
+    switch(map->width)
+    {
+        case 1:  ((uint8_t *)map->index)[slot_idx] = (uint8_t)value; break;
+        case 2:  ((uint16_t *)map->index)[slot_idx] = (uint16_t)value; break;
+        default: ((uint32_t *)map->index)[slot_idx] = (uint32_t)value; break;
+    }
+}
+
+/**
+ * @brief Probes the index for key
+ * @details The probe sequence mixes in the upper hash bits like CPython so keys sharing low bits split up quickly
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @param free_slot - if not NULL, set to the first empty or dummy slot seen, where key would be inserted
+ * @return size_t - slot holding key, or SIZE_MAX if not found
+ */
+static size_t index_find(const hashmap_compact_t* map, const char* key, size_t len, uint32_t hash, size_t* free_slot)
+{
+    size_t slot_idx = hash & map->mask;
+    size_t perturb = hash;
+    int have_free = 0;
+
+    for(;;)
+    {
+        size_t slot = index_get(map, slot_idx);
+
+        if(slot == INDEX_EMPTY)
+        {
+            if(free_slot != NULL && !have_free) *free_slot = slot_idx;
+            return SIZE_MAX;
+        }
+
+        if(slot == INDEX_DUMMY)
+        {
+            if(free_slot != NULL && !have_free) *free_slot = slot_idx;
+            have_free = 1;
+        }
+        else
+        {
+            const entry_t* entry = &map->entries[slot - INDEX_OFFSET];
+
+            if(entry->hash == hash && entry->key_len == len && memcmp(entry->key, key, len) == 0) return slot_idx;
+        }
+
+        perturb >>= 5;
+        slot_idx = (slot_idx * 5 + perturb + 1) & map->mask;
+    }
+}
+
+/**
+ * @brief Copies a key into the arena
+ * 
+ * @param map - pointer to the map
+ * @param key - key to store
+ * @param len - length of the key
+ * @return const char* - the stored key, NULL if error
+ */
+static const char* arena_store(hashmap_compact_t* map, const char* key, size_t len)
+{
+    arena_chunk_t* chunk = map->arena;
+    char* stored = NULL;
+
+    if(chunk == NULL || chunk->space - chunk->used < len + 1)
+    {
+        size_t space = (len + 1 > ARENA_CHUNK_SIZE) ? len + 1 : ARENA_CHUNK_SIZE;
+
+        chunk = (arena_chunk_t *)malloc(sizeof(arena_chunk_t) + space);
+        if(chunk == NULL) return NULL;
+
+        chunk->next = map->arena;
+        chunk->used = 0;
+        chunk->space = space;
+        map->arena = chunk;
+    }
+
+    stored = chunk->data + chunk->used;
+    memcpy(stored, key, len + 1);
+    chunk->used += len + 1;
+    map->arena_bytes += len + 1;
+
+    return stored;
+}
+
+/**
+ * @brief Frees every chunk of an arena
+ * 
+ * @param chunk - newest chunk
+ */
+static void arena_free(arena_chunk_t* chunk)
+{
+    while(chunk != NULL)
+    {
+        arena_chunk_t* next = chunk->next;
+
+        free(chunk);
+        chunk = next;
+    }
+}
+
+/**
+ * @brief Moves the live keys into one new chunk once deleted keys take up most of the arena
+ * @details Called right after the entries are compacted, so every entry is live. Failing to compact only costs memory.
+ * 
+ * @param map - pointer to the map
+ */
+static void arena_compact(hashmap_compact_t* map)
+{
+    size_t live_bytes = map->arena_bytes - map->garbage;
+    arena_chunk_t* chunk = NULL;
+
+    if(map->garbage <= live_bytes) return;
+
+    chunk = (arena_chunk_t *)malloc(sizeof(arena_chunk_t) + live_bytes + 1);
+    if(chunk == NULL) return;
+
+    chunk->next = NULL;
+    chunk->used = 0;
+    chunk->space = live_bytes + 1;
+
+    for(size_t entry_idx = 0; entry_idx < map->used; entry_idx++)
+    {
+        entry_t* entry = &map->entries[entry_idx];
+        char* stored = chunk->data + chunk->used;
+
+        memcpy(stored, entry->key, entry->key_len + 1);
+        chunk->used += entry->key_len + 1;
+        entry->key = stored;
+    }
+
+    arena_free(map->arena);
+    map->arena = chunk;
+    map->arena_bytes = chunk->used;
+    map->garbage = 0;
+}
+
+/**
+ * @brief Rebuilds the index and entries for at least min_entries entries, dropping deleted entries
+ * @details The index slot width is the smallest that can hold every entry number
+ * 
+ * @param map - pointer to the map
+ * @param min_entries - number of entries the map must have room for
+ * @return STATUS
+ */
+static STATUS resize(hashmap_compact_t* map, size_t min_entries)
+{
+    size_t slot_count = MIN_INDEX_SLOTS;
+    size_t entry_space = 0;
+    size_t width = 4;
+    size_t live = 0;
+    void* index = NULL;
+    entry_t* entries = NULL;
+
+    if(min_entries > MAX_COMPACT_ENTRIES) return ERROR;
+
+    while(slot_count / 3 * 2 < min_entries)
+    {
+        slot_count *= 2;
+    }
+
+    entry_space = slot_count / 3 * 2;
+    if(entry_space > MAX_COMPACT_ENTRIES) entry_space = MAX_COMPACT_ENTRIES;
+
+    if(entry_space + INDEX_OFFSET <= UINT8_MAX) width = 1;
+    else if(entry_space + INDEX_OFFSET <= UINT16_MAX) width = 2;
+
+    // Both arrays are allocated before anything changes, so a failure leaves the map as it was
+    index = calloc(slot_count, width);
+    entries = (entry_t *)malloc(entry_space * sizeof(entry_t));
+
+    if(index == NULL || entries == NULL)
+    {
+        free(entries);
+        free(index);
+        return ERROR;
+    }
+
+    // Only live entries are copied, so shrinking the array never drops one
+    for(size_t entry_idx = 0; entry_idx < map->used; entry_idx++)
+    {
+        if(map->entries[entry_idx].key != NULL) entries[live++] = map->entries[entry_idx];
+    }
+
+    free(map->entries);
+    free(map->index);
+    map->index = index;
+    map->entries = entries;
+    map->used = live;
+    map->entry_space = entry_space;
+    map->mask = slot_count - 1;
+    map->width = width;
+
+    for(size_t entry_idx = 0; entry_idx < map->used; entry_idx++)
+    {
+        size_t slot_idx = map->entries[entry_idx].hash & map->mask;
+        size_t perturb = map->entries[entry_idx].hash;
+
+        while(index_get(map, slot_idx) != INDEX_EMPTY)
+        {
+            perturb >>= 5;
+            slot_idx = (slot_idx * 5 + perturb + 1) & map->mask;
+        }
+
+        index_set(map, slot_idx, entry_idx + INDEX_OFFSET);
+    }
+
+    arena_compact(map);
+
+    return SUCCESS;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the hashmap_compact_t object and returns the handle
+ * @details The map grows as needed, capacity only sizes the initial index and entries
+ * 
+ * @param capacity - number of keys expected
+ * @return hashmap_compact_t* - pointer to the hashmap_compact_t object. NULL if error.
+ */
+hashmap_compact_t* hashmap_compact_create(size_t capacity)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_compact_t* map = NULL;
+
+    if(capacity == 0 || capacity > MAX_COMPACT_ENTRIES)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CAPACITY);
+        return NULL;
+    }
+
+    map = (hashmap_compact_t *)calloc(1, sizeof(hashmap_compact_t));
+
+    if(map == NULL || resize(map, capacity) == ERROR)
+    {
+        free(map);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    map->seed = hashmap_random_u64();
+
+    return map;
+}
+
+/**
+ * @brief Safely deallocates map. User can optionally provide a function for freeing values.
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional pointer to function for freeing values. Can pass NULL to not have library handle freeing values.
+ */
+void hashmap_compact_destroy(hashmap_compact_t* map, free_value_fn_t fn)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(map != NULL)
+    {
+        for(size_t entry_idx = 0; fn != NULL && entry_idx < map->used; entry_idx++)
+        {
+            if(map->entries[entry_idx].key != NULL) fn(map->entries[entry_idx].value);
+        }
+
+        arena_free(map->arena);
+        free(map->entries);
+        free(map->index);
+        free(map);
+    }
+}
+
+/**
+ * @brief Add a new key-value pair to the map
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS
+ */
+STATUS hashmap_compact_push(hashmap_compact_t* map, const char* key, void* value)
+{
+    if(map == NULL || key == NULL || value == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t len = strlen(key);
+    uint32_t hash = hash_key(map, key, len);
+    size_t free_slot = 0;
+    entry_t* entry = NULL;
+
+    if(len > UINT32_MAX)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    // Catch duplicate keys
+    if(index_find(map, key, len, hash, NULL) != SIZE_MAX)
+    {
+        hashmap_set_errno(HASHMAP_ERR_DUPLICATE);
+        return ERROR;
+    }
+
+    // Out of entries: compact away deleted ones and grow if the live ones still fill more than half
+    if(map->used == map->entry_space && resize(map, (map->size + 1) * 2) == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    index_find(map, key, len, hash, &free_slot);
+    entry = &map->entries[map->used];
+    entry->key = arena_store(map, key, len);
+
+    if(entry->key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    entry->value = value;
+    entry->hash = hash;
+    entry->key_len = (uint32_t)len;
+    index_set(map, free_slot, map->used + INDEX_OFFSET);
+    map->used++;
+    map->size++;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the value for the given key
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_compact_get(const hashmap_compact_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    size_t len = strlen(key);
+    size_t slot_idx = index_find(map, key, len, hash_key(map, key, len), NULL);
+
+    if(slot_idx == SIZE_MAX)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return NULL;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    return map->entries[index_get(map, slot_idx) - INDEX_OFFSET].value;
+}
+
+/**
+ * @brief Deletes a key-value pair from the map
+ * @details The entry is marked deleted in place so insertion order is kept. Deleted entries and their key bytes
+ * are reclaimed the next time the map runs out of entries.
+ * 
+ * @param map - pointer to the map
+ * @param key - key to be deleted
+ * @param fn - optional function for freeing the value. Can be left NULL if user plans to handle deallocation.
+ * @return STATUS
+ */
+STATUS hashmap_compact_delete(hashmap_compact_t* map, const char* key, free_value_fn_t fn)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t len = strlen(key);
+    size_t slot_idx = index_find(map, key, len, hash_key(map, key, len), NULL);
+    entry_t* entry = NULL;
+
+    if(slot_idx == SIZE_MAX)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return ERROR;
+    }
+
+    entry = &map->entries[index_get(map, slot_idx) - INDEX_OFFSET];
+    index_set(map, slot_idx, INDEX_DUMMY);
+
+    if(fn != NULL) fn(entry->value);
+
+    map->garbage += entry->key_len + 1;
+    entry->key = NULL;
+    entry->value = NULL;
+    map->size--;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the number of keys in the map
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_compact_size(const hashmap_compact_t* map)
+{
+    return (map != NULL) ? map->size : 0;
+}
+
+/**
+ * @brief Iterates over the map in insertion order
+ * @details Set *cursor to 0 to start. Each call returns the next key-value pair and advances *cursor.
+ * Pushing or deleting keys while iterating is allowed but may skip or repeat keys.
+ * 
+ * @param map - pointer to the map
+ * @param cursor - position in the iteration
+ * @param key - set to the next key, can be NULL
+ * @param value - set to the next value, can be NULL
+ * @return STATUS - ERROR with errno HASHMAP_ERR_NOT_FOUND once every key has been returned
+ */
+STATUS hashmap_compact_next(const hashmap_compact_t* map, size_t* cursor, const char** key, void** value)
+{
+    if(map == NULL || cursor == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    while(*cursor < map->used)
+    {
+        const entry_t* entry = &map->entries[(*cursor)++];
+
+        if(entry->key != NULL)
+        {
+            if(key != NULL) *key = entry->key;
+            if(value != NULL) *value = entry->value;
+            return SUCCESS;
+        }
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+    return ERROR;
+}
+
+//---------------------------------------------------------------------------------------------------------
@@ -0,0 +1,1008 @@
+/**
+ * @file hashmap_concurrent.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Hashmap that can be shared between threads, growing without stopping them
+ * @details Writers lock a single bin, readers take no locks at all. When the map outgrows its bins a table of
+ * twice the size is attached to the current one and every thread that writes to the map moves a range of bins
+ * across before doing its own work, so the rehash is spread over many operations and threads instead of being
+ * done by one writer while the others wait. A moved bin is left holding a forwarding marker that sends
+ * readers and writers on to the new table. Memory that readers may still be looking at is only freed once
+ * they are done with it, through epoch based reclamation.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap_concurrent.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#define MIN_BINS 16             // Smallest table, must be a power of 2
+#define TRANSFER_STRIDE 64      // Bins moved to the next table by each thread that helps
+#define COUNTER_CELLS 16        // Separate size counters so writers on different threads don't share a cache line
+#define CACHE_LINE 64           // Assumed cache line size
+#define SPIN_LIMIT 64           // Failed attempts at a bin lock before yielding the CPU
+
+#define FORWARD (&forward_marker)  // Head of a bin whose nodes were moved to the next table
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct cnode cnode_t;
+typedef struct bin bin_t;
+typedef struct ctable ctable_t;
+typedef struct counter_cell counter_cell_t;
+
+// Key-value pair. The key is stored inline so a node is a single allocation.
+struct cnode
+{
+    _Atomic(cnode_t *) next;    // Next node in the bin, read by readers without a lock
+    _Atomic(void *) value;      // Value of this node, read by readers without a lock
+    uint64_t hash;              // Hash of the key
+    size_t key_len;             // Length of the key
+    char key[];                 // Key of this node
+};
+
+// Chain of nodes guarded by a spin lock that only writers take
+struct bin
+{
+    _Atomic(cnode_t *) head;    // First node, FORWARD once the bin was moved to the next table
+    atomic_flag lock;           // Held by the writer modifying this bin
+};
+
+// Array of bins. Once it fills up, next is attached and the bins are moved over one by one.
+struct ctable
+{
+    size_t capacity;            // Number of bins, a power of 2
+    size_t mask;                // capacity - 1
+    _Atomic(ctable_t *) next;   // Table the bins are being moved to, NULL while not growing
+    atomic_size_t claim;        // First bin not yet claimed by a helper
+    atomic_size_t moved;        // Number of bins moved to next
+    atomic_size_t helpers;      // Number of threads moving bins right now
+    bin_t bins[];               // The bins
+};
+
+// Part of the size of the map
+struct counter_cell
+{
+    _Alignas(CACHE_LINE) atomic_long count;  // Keys added minus keys removed through this cell
+};
+
+// The concurrent hashmap structure. Obfuscated from the user
+struct hashmap_concurrent
+{
+    counter_cell_t cells[COUNTER_CELLS];    // Size of the map, summed over the cells
+    _Atomic(ctable_t *) table;              // Current table, readers and writers start here
+    uint64_t seed;                          // Seed for the hashes
+};
+
+static cnode_t forward_marker;                          // Never a real node, only compared against
+static atomic_size_t next_cell = 0;                     // Hands out counter cells to threads round robin
+static _Thread_local size_t cell_idx = COUNTER_CELLS;   // Counter cell of the calling thread
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hashes a key with the map's seed
+ * 
+ * @param map - pointer to the map
+ * @param key - key to hash
+ * @param len - length of the key
+ * @return uint64_t - the hash
+ */
+static inline uint64_t hash_key(const hashmap_concurrent_t* map, const char* key, size_t len)
+{
+    uint64_t hash[2] = {0};
+
+    MurmurHash3_x64_128_seed64(key, (int)len, map->seed, hash);
+
+    return hash[0];
+}
+
+/**
+ * @brief Adds delta to the calling thread's counter cell
+ * 
+ * @param map - pointer to the map
+ * @param delta - change in size
+ */
+static inline void count_add(hashmap_concurrent_t* map, long delta)
+{
+    if(cell_idx == COUNTER_CELLS) cell_idx = atomic_fetch_add(&next_cell, 1) % COUNTER_CELLS;
+
+    atomic_fetch_add_explicit(&map->cells[cell_idx].count, delta, memory_order_relaxed);
+}
+
+/**
+ * @brief Sums the counter cells
+ * 
+ * @param map - pointer to the map
+ * @return size_t - number of keys in the map, approximate while writers are running
+ */
+static size_t count_sum(hashmap_concurrent_t* map)
+{
+    long sum = 0;
+
+    for(size_t cell = 0; cell < COUNTER_CELLS; cell++)
+    {
+        sum += atomic_load_explicit(&map->cells[cell].count, memory_order_relaxed);
+    }
+
+    return (sum > 0) ? (size_t)sum : 0;
+}
+
+/**
+ * @brief Takes the lock of a bin
+ * 
+ * @param bin - bin to lock
+ */
+static inline void bin_lock(bin_t* bin)
+{
+    unsigned spins = 0;
+
+    while(atomic_flag_test_and_set_explicit(&bin->lock, memory_order_acquire))
+    {
+        if(++spins == SPIN_LIMIT)
+        {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+/**
+ * @brief Releases the lock of a bin
+ * 
+ * @param bin - bin to unlock
+ */
+static inline void bin_unlock(bin_t* bin)
+{
+    atomic_flag_clear_explicit(&bin->lock, memory_order_release);
+}
+
+/**
+ * @brief Allocates a node holding a copy of key
+ * 
+ * @param key - key of the node
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @param value - value of the node
+ * @return cnode_t* - NULL if error
+ */
+static cnode_t* node_create(const char* key, size_t len, uint64_t hash, void* value)
+{
+    cnode_t* node = (cnode_t *)malloc(sizeof(cnode_t) + len + 1);
+
+    if(node == NULL) return NULL;
+
+    atomic_init(&node->next, NULL);
+    atomic_init(&node->value, value);
+    node->hash = hash;
+    node->key_len = len;
+    memcpy(node->key, key, len + 1);
+
+    return node;
+}
+
+/**
+ * @brief Compares a node's key against key
+ * 
+ * @param node - node to compare
+ * @param key - the key
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @return int - non-zero if node holds key
+ */
+static inline int node_matches(const cnode_t* node, const char* key, size_t len, uint64_t hash)
+{
+    return node->hash == hash && node->key_len == len && memcmp(node->key, key, len) == 0;
+}
+
+/**
+ * @brief Walks a chain for key without locking
+ * 
+ * @param node - first node of the chain
+ * @param key - key to search for
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @return cnode_t* - NULL if not found
+ */
+static cnode_t* chain_find(cnode_t* node, const char* key, size_t len, uint64_t hash)
+{
+    while(node != NULL)
+    {
+        if(node_matches(node, key, len, hash)) return node;
+
+        node = atomic_load(&node->next);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Allocates a table of empty bins
+ * 
+ * @param capacity - number of bins, a power of 2
+ * @return ctable_t* - NULL if error
+ */
+static ctable_t* table_create(size_t capacity)
+{
+    ctable_t* table = NULL;
+
+    if(capacity > (SIZE_MAX - sizeof(ctable_t)) / sizeof(bin_t)) return NULL;
+
+    table = (ctable_t *)calloc(1, sizeof(ctable_t) + capacity * sizeof(bin_t));
+    if(table == NULL) return NULL;
+
+    table->capacity = capacity;
+    table->mask = capacity - 1;
+    atomic_init(&table->next, NULL);
+    atomic_init(&table->claim, 0);
+    atomic_init(&table->moved, 0);
+    atomic_init(&table->helpers, 0);
+
+    for(size_t bin_idx = 0; bin_idx < capacity; bin_idx++)
+    {
+        atomic_init(&table->bins[bin_idx].head, NULL);
+        atomic_flag_clear(&table->bins[bin_idx].lock);
+    }
+
+    return table;
+}
+
+/**
+ * @brief Moves one bin of table to the next table
+ * @details A key in bin i lands in bin i or i + capacity of the next table. The nodes at the end of the chain
+ * that all land in the same bin are reused as they are. The ones in front of them are copied, because readers
+ * walking the old chain must keep finding every key, and retired. Until the forwarding marker is stored the
+ * old bin stays fully usable.
+ * 
+ * @param table - table being grown
+ * @param next - table being grown into
+ * @param bin_idx - bin to move
+ * @return STATUS - ERROR if a copy could not be allocated, the bin is then left where it was
+ */
+static STATUS transfer_bin(ctable_t* table, ctable_t* next, size_t bin_idx)
+{
+    bin_t* bin = &table->bins[bin_idx];
+    cnode_t* head = NULL;
+    cnode_t* last_run = NULL;
+    cnode_t* lists[2] = {NULL, NULL};
+    size_t run_side = 0;
+
+    bin_lock(bin);
+    head = atomic_load(&bin->head);
+
+    if(head == FORWARD)
+    {
+        bin_unlock(bin);
+        return SUCCESS;
+    }
+
+    // Find the tail of the chain that goes to a single side
+    last_run = head;
+    run_side = (head != NULL && (head->hash & table->capacity)) ? 1 : 0;
+
+    for(cnode_t* node = head; node != NULL; node = atomic_load(&node->next))
+    {
+        size_t side = (node->hash & table->capacity) ? 1 : 0;
+
+        if(side != run_side)
+        {
+            run_side = side;
+            last_run = node;
+        }
+    }
+
+    lists[run_side] = last_run;
+
+    for(cnode_t* node = head; node != last_run; node = atomic_load(&node->next))
+    {
+        size_t side = (node->hash & table->capacity) ? 1 : 0;
+        cnode_t* copy = node_create(node->key, node->key_len, node->hash, atomic_load(&node->value));
+
+        if(copy == NULL)
+        {
+            // Only the copies in front of last_run were allocated here
+            for(side = 0; side < 2; side++)
+            {
+                while(lists[side] != NULL && lists[side] != last_run)
+                {
+                    cnode_t* copy_next = atomic_load(&lists[side]->next);
+
+                    free(lists[side]);
+                    lists[side] = copy_next;
+                }
+            }
+
+            bin_unlock(bin);
+            return ERROR;
+        }
+
+        atomic_init(&copy->next, lists[side]);
+        lists[side] = copy;
+    }
+
+    // Nothing else writes to these bins of next before the forwarding marker is seen
+    atomic_store(&next->bins[bin_idx].head, lists[0]);
+    atomic_store(&next->bins[bin_idx + table->capacity].head, lists[1]);
+    atomic_store(&bin->head, FORWARD);
+    bin_unlock(bin);
+
+    for(cnode_t* node = head; node != last_run;)
+    {
+        cnode_t* node_next = atomic_load(&node->next);
+
+        hashmap_ebr_retire(node);
+        node = node_next;
+    }
+
+    atomic_fetch_add(&table->moved, 1);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Moves one range of bins of table to its next table, installing next once every bin has moved
+ * @details Once every range has been claimed, a lone helper sweeps the whole table for bins that a helper
+ * could not move because an allocation failed.
+ * 
+ * @param map - pointer to the map
+ * @param table - table being grown
+ */
+static void transfer_help(hashmap_concurrent_t* map, ctable_t* table)
+{
+    ctable_t* next = atomic_load(&table->next);
+    size_t start = table->capacity;
+    ctable_t* expected = table;
+
+    if(next == NULL) return;
+
+    atomic_fetch_add(&table->helpers, 1);
+
+    if(atomic_load(&table->claim) < table->capacity) start = atomic_fetch_add(&table->claim, TRANSFER_STRIDE);
+
+    if(start < table->capacity)
+    {
+        size_t end = (start + TRANSFER_STRIDE < table->capacity) ? start + TRANSFER_STRIDE : table->capacity;
+
+        for(size_t bin_idx = start; bin_idx < end; bin_idx++)
+        {
+            transfer_bin(table, next, bin_idx);
+        }
+    }
+    else if(atomic_load(&table->moved) < table->capacity && atomic_load(&table->helpers) == 1)
+    {
+        for(size_t bin_idx = 0; bin_idx < table->capacity; bin_idx++)
+        {
+            transfer_bin(table, next, bin_idx);
+        }
+    }
+
+    atomic_fetch_sub(&table->helpers, 1);
+
+    // Every bin forwards now, so the old table is only reachable by threads that already hold it
+    if(atomic_load(&table->moved) == table->capacity && atomic_compare_exchange_strong(&map->table, &expected, next))
+    {
+        hashmap_ebr_retire(table);
+    }
+}
+
+/**
+ * @brief Starts growing table to twice its size if it is still the current table, then helps
+ * 
+ * @param map - pointer to the map
+ * @param table - table that filled up
+ */
+static void resize_start(hashmap_concurrent_t* map, ctable_t* table)
+{
+    ctable_t* next = NULL;
+    ctable_t* expected = NULL;
+
+    if(atomic_load(&map->table) != table || atomic_load(&table->next) != NULL) return;
+
+    next = table_create(table->capacity * 2);
+    if(next == NULL) return;
+
+    // Another thread may have attached its own table first
+    if(!atomic_compare_exchange_strong(&table->next, &expected, next)) free(next);
+
+    transfer_help(map, table);
+}
+
+/**
+ * @brief Frees every node in a chain
+ * 
+ * @param node - first node
+ * @param fn - optional function for freeing the values
+ */
+static void chain_free(cnode_t* node, free_value_fn_t fn)
+{
+    while(node != NULL)
+    {
+        cnode_t* next = atomic_load(&node->next);
+
+        if(fn != NULL) fn(atomic_load(&node->value));
+        free(node);
+        node = next;
+    }
+}
+
+/**
+ * @brief Locks the bin that holds or would hold hash, following forwarding markers to the newest table
+ * @details Must be called inside a critical section. If the map is growing, the calling thread first moves a
+ * range of bins.
+ * 
+ * @param map - pointer to the map
+ * @param hash - hash of the key
+ * @return bin_t* - the locked bin
+ */
+static bin_t* bin_lock_for(hashmap_concurrent_t* map, uint64_t hash)
+{
+    ctable_t* table = atomic_load(&map->table);
+
+    transfer_help(map, table);
+
+    for(;;)
+    {
+        bin_t* bin = &table->bins[hash & table->mask];
+
+        if(atomic_load(&bin->head) == FORWARD)
+        {
+            table = atomic_load(&table->next);
+            continue;
+        }
+
+        bin_lock(bin);
+
+        if(atomic_load(&bin->head) != FORWARD) return bin;
+
+        // Moved while waiting for the lock
+        bin_unlock(bin);
+    }
+}
+
+/**
+ * @brief Finds key in a locked bin
+ * 
+ * @param bin - locked bin
+ * @param key - key to search for
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @param previous - set to the node before the one found, NULL if it is the head
+ * @return cnode_t* - NULL if not found
+ */
+static cnode_t* bin_find(bin_t* bin, const char* key, size_t len, uint64_t hash, cnode_t** previous)
+{
+    cnode_t* current = atomic_load(&bin->head);
+
+    *previous = NULL;
+
+    while(current != NULL && !node_matches(current, key, len, hash))
+    {
+        *previous = current;
+        current = atomic_load(&current->next);
+    }
+
+    return current;
+}
+
+/**
+ * @brief Links node in at the head of a locked bin and counts it, growing the map if it filled up
+ * 
+ * @param map - pointer to the map
+ * @param bin - locked bin, unlocked on return
+ * @param node - node to link in
+ */
+static void bin_insert(hashmap_concurrent_t* map, bin_t* bin, cnode_t* node)
+{
+    cnode_t* head = atomic_load(&bin->head);
+    ctable_t* table = NULL;
+
+    atomic_store(&node->next, head);
+    atomic_store(&bin->head, node);
+    bin_unlock(bin);
+    count_add(map, 1);
+
+    // Summing the cells is only worth it once bins start to collide
+    if(head != NULL)
+    {
+        table = atomic_load(&map->table);
+        if(count_sum(map) >= table->capacity - table->capacity / 4) resize_start(map, table);
+    }
+}
+
+/**
+ * @brief Unlinks a node from a locked bin and retires it
+ * @details Readers already on current can still follow its next pointer
+ * 
+ * @param map - pointer to the map
+ * @param bin - locked bin, unlocked on return
+ * @param previous - node before current, NULL if current is the head
+ * @param current - node to unlink
+ */
+static void bin_remove(hashmap_concurrent_t* map, bin_t* bin, cnode_t* previous, cnode_t* current)
+{
+    if(previous == NULL) atomic_store(&bin->head, atomic_load(&current->next));
+    else atomic_store(&previous->next, atomic_load(&current->next));
+
+    bin_unlock(bin);
+    count_add(map, -1);
+    hashmap_ebr_retire(current);
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the hashmap_concurrent_t object and returns the handle
+ * @details The map grows as needed, capacity only sizes the initial table
+ * 
+ * @param capacity - number of keys expected
+ * @return hashmap_concurrent_t* - pointer to the hashmap_concurrent_t object. NULL if error.
+ */
+hashmap_concurrent_t* hashmap_concurrent_create(size_t capacity)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_concurrent_t* map = NULL;
+    size_t bin_count = MIN_BINS;
+
+    if(capacity == 0 || capacity > SIZE_MAX / 8)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CAPACITY);
+        return NULL;
+    }
+
+    // Keep the load factor at or below 3/4
+    while(bin_count / 4 * 3 < capacity)
+    {
+        bin_count *= 2;
+    }
+
+    map = (hashmap_concurrent_t *)aligned_alloc(CACHE_LINE, sizeof(hashmap_concurrent_t));
+
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    for(size_t cell = 0; cell < COUNTER_CELLS; cell++)
+    {
+        atomic_init(&map->cells[cell].count, 0);
+    }
+
+    atomic_init(&map->table, table_create(bin_count));
+    map->seed = hashmap_random_u64();
+
+    if(atomic_load(&map->table) == NULL)
+    {
+        free(map);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    return map;
+}
+
+/**
+ * @brief Safely deallocates map. User can optionally provide a function for freeing values.
+ * @details No other thread may be using the map. Nodes retired by earlier deletes are freed by the threads
+ * that retired them.
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional pointer to function for freeing values. Can pass NULL to not have library handle freeing values.
+ */
+void hashmap_concurrent_destroy(hashmap_concurrent_t* map, free_value_fn_t fn)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(map != NULL)
+    {
+        ctable_t* table = atomic_load(&map->table);
+
+        // A growth still in progress leaves nodes in both tables, but each node in only one of them
+        while(table != NULL)
+        {
+            ctable_t* next = atomic_load(&table->next);
+
+            for(size_t bin_idx = 0; bin_idx < table->capacity; bin_idx++)
+            {
+                cnode_t* head = atomic_load(&table->bins[bin_idx].head);
+
+                if(head != FORWARD) chain_free(head, fn);
+            }
+
+            free(table);
+            table = next;
+        }
+
+        free(map);
+    }
+}
+
+/**
+ * @brief Add a new key-value pair to the map
+ * @details Takes the lock of one bin. If the map is growing, the calling thread first moves a range of bins.
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS
+ */
+STATUS hashmap_concurrent_push(hashmap_concurrent_t* map, const char* key, void* value)
+{
+    if(map == NULL || key == NULL || value == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(map, key, len);
+    cnode_t* node = node_create(key, len, hash, value);
+    cnode_t* previous = NULL;
+    bin_t* bin = NULL;
+
+    if(node == NULL || hashmap_ebr_enter() == ERROR)
+    {
+        free(node);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    bin = bin_lock_for(map, hash);
+
+    // Catch duplicate keys
+    if(bin_find(bin, key, len, hash, &previous) != NULL)
+    {
+        bin_unlock(bin);
+        hashmap_ebr_exit();
+        free(node);
+        hashmap_set_errno(HASHMAP_ERR_DUPLICATE);
+        return ERROR;
+    }
+
+    bin_insert(map, bin, node);
+    hashmap_ebr_exit();
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the value for the given key
+ * @details Never takes a lock and never waits for writers or a growing table
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_concurrent_get(hashmap_concurrent_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(map, key, len);
+    ctable_t* table = NULL;
+    cnode_t* node = NULL;
+    void* value = NULL;
+
+    if(hashmap_ebr_enter() == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    table = atomic_load(&map->table);
+
+    for(;;)
+    {
+        cnode_t* head = atomic_load(&table->bins[hash & table->mask].head);
+
+        if(head != FORWARD)
+        {
+            node = chain_find(head, key, len, hash);
+            break;
+        }
+
+        table = atomic_load(&table->next);
+    }
+
+    if(node != NULL) value = atomic_load(&node->value);
+
+    hashmap_ebr_exit();
+    hashmap_set_errno((node == NULL) ? HASHMAP_ERR_NOT_FOUND : HASHMAP_ERR_NONE);
+
+    return value;
+}
+
+/**
+ * @brief Deletes a key-value pair from the map
+ * @details The node is freed once no reader can still be walking over it. fn is called right away, so the
+ * value must not be freed while other threads may still be using it.
+ * 
+ * @param map - pointer to the map
+ * @param key - key to be deleted
+ * @param fn - optional function for freeing the value. Can be left NULL if user plans to handle deallocation.
+ * @return STATUS
+ */
+STATUS hashmap_concurrent_delete(hashmap_concurrent_t* map, const char* key, free_value_fn_t fn)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(map, key, len);
+    cnode_t* previous = NULL;
+    cnode_t* current = NULL;
+    bin_t* bin = NULL;
+    void* value = NULL;
+
+    if(hashmap_ebr_enter() == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    bin = bin_lock_for(map, hash);
+    current = bin_find(bin, key, len, hash, &previous);
+
+    if(current == NULL)
+    {
+        bin_unlock(bin);
+        hashmap_ebr_exit();
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return ERROR;
+    }
+
+    value = atomic_load(&current->value);
+    bin_remove(map, bin, previous, current);
+    hashmap_ebr_exit();
+
+    if(fn != NULL) fn(value);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Replaces the value of key with desired if it is still *expected
+ * @details Runs under the lock of the key's bin, so it is atomic with respect to every other write to the key.
+ * On a mismatch *expected is set to the current value, ready for a retry.
+ * 
+ * @param map - pointer to the map
+ * @param key - key whose value to replace
+ * @param expected - value the key must hold, set to the current value on a mismatch
+ * @param desired - new value
+ * @return STATUS - ERROR with HASHMAP_ERR_CONFLICT if the value was not *expected
+ */
+STATUS hashmap_concurrent_cas_value(hashmap_concurrent_t* map, const char* key, void** expected, void* desired)
+{
+    if(map == NULL || key == NULL || expected == NULL || desired == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(map, key, len);
+    cnode_t* previous = NULL;
+    cnode_t* current = NULL;
+    bin_t* bin = NULL;
+    STATUS status = SUCCESS;
+
+    if(hashmap_ebr_enter() == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    bin = bin_lock_for(map, hash);
+    current = bin_find(bin, key, len, hash, &previous);
+
+    if(current == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        status = ERROR;
+    }
+    else if(!atomic_compare_exchange_strong(&current->value, expected, desired))
+    {
+        hashmap_set_errno(HASHMAP_ERR_CONFLICT);
+        status = ERROR;
+    }
+
+    bin_unlock(bin);
+    hashmap_ebr_exit();
+
+    return status;
+}
+
+/**
+ * @brief Adds delta to the counter of key, creating the key at 0 if needed
+ * @details The value of a counter key is a malloc()ed _Atomic uint64_t, so hashmap_concurrent_get() returns a
+ * pointer to it even when the count is 0. Readers load it with atomic_load(), and it is released by passing free
+ * to hashmap_concurrent_delete() or hashmap_concurrent_destroy(). key must not hold any other kind of value.
+ * 
+ * @param map - pointer to the map
+ * @param key - key of the counter
+ * @param delta - amount to add, wrapping around on overflow
+ * @param previous - optional, set to the value before the add
+ * @return STATUS
+ */
+STATUS hashmap_concurrent_fetch_add_u64(hashmap_concurrent_t* map, const char* key, uint64_t delta, uint64_t* previous)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(map, key, len);
+    cnode_t* node_previous = NULL;
+    cnode_t* current = NULL;
+    cnode_t* node = NULL;
+    bin_t* bin = NULL;
+    _Atomic uint64_t* counter = NULL;
+    uint64_t old_value = 0;
+
+    if(hashmap_ebr_enter() == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    bin = bin_lock_for(map, hash);
+    current = bin_find(bin, key, len, hash, &node_previous);
+
+    if(current != NULL)
+    {
+        // The lock keeps a delete from freeing the counter under us
+        old_value = atomic_fetch_add((_Atomic uint64_t *)atomic_load(&current->value), delta);
+        bin_unlock(bin);
+    }
+    else
+    {
+        // Allocating under the lock keeps the common case, an existing counter, free of allocations
+        counter = (_Atomic uint64_t *)malloc(sizeof(*counter));
+        if(counter != NULL) node = node_create(key, len, hash, (void *)counter);
+
+        if(node == NULL)
+        {
+            bin_unlock(bin);
+            hashmap_ebr_exit();
+            free((void *)counter);
+            hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+            return ERROR;
+        }
+
+        atomic_init(counter, delta);
+        bin_insert(map, bin, node);
+    }
+
+    hashmap_ebr_exit();
+
+    if(previous != NULL) *previous = old_value;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Replaces the value of key with the result of fn, atomically with respect to every other write to key
+ * @details fn is called with the key, its current value (NULL if the key is not in the map) and ctx, under the
+ * lock of the key's bin. A non NULL result becomes the value, inserting the key if needed. A NULL result removes
+ * the key. fn must be short and must not use the map. The old value is not freed.
+ * 
+ * @param map - pointer to the map
+ * @param key - key to compute
+ * @param fn - computes the new value from the current one
+ * @param ctx - passed through to fn
+ * @return STATUS - ERROR with HASHMAP_ERR_ALLOC_FAILED if the key is new and its node can't be allocated, in which
+ * case fn is not called
+ */
+STATUS hashmap_concurrent_compute(hashmap_concurrent_t* map, const char* key, hashmap_compute_fn_t fn, void* ctx)
+{
+    if(map == NULL || key == NULL || fn == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(map, key, len);
+    cnode_t* previous = NULL;
+    cnode_t* current = NULL;
+    cnode_t* node = NULL;
+    bin_t* bin = NULL;
+    void* value = NULL;
+
+    if(hashmap_ebr_enter() == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    bin = bin_lock_for(map, hash);
+    current = bin_find(bin, key, len, hash, &previous);
+
+    // A new key gets its node first, so a value made by fn always has somewhere to go
+    if(current == NULL && (node = node_create(key, len, hash, NULL)) == NULL)
+    {
+        bin_unlock(bin);
+        hashmap_ebr_exit();
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    value = fn(key, (current != NULL) ? atomic_load(&current->value) : NULL, ctx);
+
+    if(current != NULL && value != NULL)
+    {
+        atomic_store(&current->value, value);
+        bin_unlock(bin);
+    }
+    else if(current != NULL)
+    {
+        bin_remove(map, bin, previous, current);
+    }
+    else if(value != NULL)
+    {
+        atomic_store(&node->value, value);
+        bin_insert(map, bin, node);
+    }
+    else
+    {
+        bin_unlock(bin);
+        free(node);
+    }
+
+    hashmap_ebr_exit();
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the number of keys in the map
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL. Approximate while other threads are writing.
+ */
+size_t hashmap_concurrent_size(hashmap_concurrent_t* map)
+{
+    return (map != NULL) ? count_sum(map) : 0;
+}
+
+/**
+ * @brief Returns the number of bins of the map's current table
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_concurrent_capacity(hashmap_concurrent_t* map)
+{
+    size_t capacity = 0;
+
+    // The table may be retired by a finishing resize while it is read
+    if(map != NULL && hashmap_ebr_enter() == SUCCESS)
+    {
+        capacity = atomic_load(&map->table)->capacity;
+        hashmap_ebr_exit();
+    }
+
+    return capacity;
+}
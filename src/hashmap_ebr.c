@@ -0,0 +1,270 @@
+/**
+ * @file hashmap_ebr.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Epoch based reclamation for memory that lock-free readers may still be looking at
+ * @details Every thread gets a record the first time it enters a critical section. Memory unlinked inside a
+ * critical section is retired with the global epoch at that time and freed once the epoch has moved on twice,
+ * since by then every thread has left the critical sections that could have seen it. The epoch only moves on
+ * when every thread inside a critical section has observed the current one.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "hashmap_internal.h"
+
+#define EBR_ACTIVE 1        // Set in a record's state while its thread is in a critical section
+#define EBR_SCAN_RATE 64    // Retires between attempts to advance the epoch
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct ebr_item ebr_item_t;
+typedef struct ebr_record ebr_record_t;
+
+// Retired allocation waiting for the epoch to move on
+struct ebr_item
+{
+    void* ptr;          // Allocation to free()
+    uint64_t epoch;     // Global epoch when it was retired
+};
+
+// Per-thread state. Records are never freed, a record whose thread exited is reused by the next new thread.
+struct ebr_record
+{
+    atomic_uint_fast64_t state;     // Epoch << 1 | EBR_ACTIVE while in a critical section, 0 otherwise
+    atomic_int in_use;              // Set while a thread owns the record
+    ebr_record_t* next;             // Next record in the global list
+    size_t nesting;                 // Depth of nested critical sections
+    ebr_item_t* limbo;              // Retired allocations of this thread
+    size_t limbo_count;             // Number of entries in limbo
+    size_t limbo_space;             // Number of entries limbo has room for
+    size_t retires;                 // Retires since the last scan
+};
+
+static atomic_uint_fast64_t global_epoch = 1;               // Current epoch
+static _Atomic(ebr_record_t *) records = NULL;              // Every record ever made
+static pthread_mutex_t orphan_lock = PTHREAD_MUTEX_INITIALIZER; // Protects the orphans
+static ebr_record_t orphans;                                // Limbo of exited threads
+static pthread_key_t thread_key;                            // Runs ebr_thread_exit() for each thread
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;  // Creates thread_key once
+static _Thread_local ebr_record_t* local = NULL;            // Record of the calling thread
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Frees the items of a limbo list retired at least two epochs before epoch
+ * 
+ * @param record - record owning the limbo list
+ * @param epoch - current global epoch
+ */
+static void limbo_reclaim(ebr_record_t* record, uint64_t epoch)
+{
+    size_t kept = 0;
+
+    for(size_t item_idx = 0; item_idx < record->limbo_count; item_idx++)
+    {
+        if(record->limbo[item_idx].epoch + 2 <= epoch) free(record->limbo[item_idx].ptr);
+        else record->limbo[kept++] = record->limbo[item_idx];
+    }
+
+    record->limbo_count = kept;
+}
+
+/**
+ * @brief Appends an item to a limbo list
+ * 
+ * @param record - record owning the limbo list
+ * @param ptr - allocation to free later
+ * @param epoch - epoch it was retired in
+ * @return STATUS - ERROR if the list could not grow
+ */
+static STATUS limbo_push(ebr_record_t* record, void* ptr, uint64_t epoch)
+{
+    if(record->limbo_count == record->limbo_space)
+    {
+        size_t space = (record->limbo_space == 0) ? EBR_SCAN_RATE : record->limbo_space * 2;
+        ebr_item_t* limbo = (ebr_item_t *)realloc(record->limbo, space * sizeof(ebr_item_t));
+
+        if(limbo == NULL) return ERROR;
+
+        record->limbo = limbo;
+        record->limbo_space = space;
+    }
+
+    record->limbo[record->limbo_count].ptr = ptr;
+    record->limbo[record->limbo_count].epoch = epoch;
+    record->limbo_count++;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Moves the epoch on if every thread in a critical section has seen the current one
+ * 
+ * @return uint64_t - the global epoch after the attempt
+ */
+static uint64_t epoch_try_advance(void)
+{
+    uint64_t epoch = atomic_load(&global_epoch);
+
+    for(ebr_record_t* record = atomic_load(&records); record != NULL; record = record->next)
+    {
+        uint64_t state = atomic_load(&record->state);
+
+        if((state & EBR_ACTIVE) && (state >> 1) != epoch) return epoch;
+    }
+
+    atomic_compare_exchange_strong(&global_epoch, &epoch, epoch + 1);
+
+    return atomic_load(&global_epoch);
+}
+
+/**
+ * @brief Hands the limbo list of an exiting thread to the orphans and releases its record
+ * 
+ * @param arg - record of the thread
+ */
+static void ebr_thread_exit(void* arg)
+{
+    ebr_record_t* record = (ebr_record_t *)arg;
+
+    pthread_mutex_lock(&orphan_lock);
+
+    for(size_t item_idx = 0; item_idx < record->limbo_count; item_idx++)
+    {
+        // Without room to defer it, waiting out two epochs here is the only safe way to free it
+        if(limbo_push(&orphans, record->limbo[item_idx].ptr, record->limbo[item_idx].epoch) == ERROR)
+        {
+            while(epoch_try_advance() < record->limbo[item_idx].epoch + 2);
+            free(record->limbo[item_idx].ptr);
+        }
+    }
+
+    pthread_mutex_unlock(&orphan_lock);
+
+    free(record->limbo);
+    record->limbo = NULL;
+    record->limbo_count = 0;
+    record->limbo_space = 0;
+    atomic_store(&record->in_use, 0);
+}
+
+/**
+ * @brief Creates the key whose destructor releases a thread's record
+ * 
+ */
+static void ebr_make_key(void)
+{
+    pthread_key_create(&thread_key, ebr_thread_exit);
+}
+
+/**
+ * @brief Returns the calling thread's record, claiming or creating one on first use
+ * 
+ * @return ebr_record_t* - NULL if no record could be allocated
+ */
+static ebr_record_t* ebr_record(void)
+{
+    ebr_record_t* record = NULL;
+
+    if(local != NULL) return local;
+
+    pthread_once(&thread_key_once, ebr_make_key);
+
+    // Reuse the record of a thread that exited
+    for(record = atomic_load(&records); record != NULL; record = record->next)
+    {
+        int free_record = 0;
+
+        if(atomic_compare_exchange_strong(&record->in_use, &free_record, 1)) break;
+    }
+
+    if(record == NULL)
+    {
+        record = (ebr_record_t *)calloc(1, sizeof(ebr_record_t));
+        if(record == NULL) return NULL;
+
+        atomic_init(&record->state, 0);
+        atomic_init(&record->in_use, 1);
+        record->next = atomic_load(&records);
+
+        while(!atomic_compare_exchange_weak(&records, &record->next, record));
+    }
+
+    pthread_setspecific(thread_key, record);
+    local = record;
+
+    return record;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Enters a critical section. Memory reachable from shared structures stays allocated until it exits.
+ * @details Critical sections nest. Without a record the thread can't be tracked, so ERROR is returned and
+ * the caller must not touch shared memory.
+ * 
+ * @return STATUS
+ */
+STATUS hashmap_ebr_enter(void)
+{
+    ebr_record_t* record = ebr_record();
+
+    if(record == NULL) return ERROR;
+
+    if(record->nesting++ == 0)
+    {
+        atomic_store(&record->state, (atomic_load(&global_epoch) << 1) | EBR_ACTIVE);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Leaves a critical section entered with hashmap_ebr_enter()
+ * 
+ */
+void hashmap_ebr_exit(void)
+{
+    if(--local->nesting == 0) atomic_store(&local->state, 0);
+}
+
+/**
+ * @brief Frees ptr with free() once no critical section can still see it
+ * @details Must be called inside a critical section, after ptr was unlinked from every shared structure.
+ * If the limbo list can't grow even after reclaiming, ptr is leaked rather than freed early.
+ * 
+ * @param ptr - allocation to free
+ */
+void hashmap_ebr_retire(void* ptr)
+{
+    ebr_record_t* record = local;
+    uint64_t epoch = atomic_load(&global_epoch);
+
+    // Make room by reclaiming what is already safe. Failing that, leaking ptr is the only safe choice left
+    // as this thread's own critical section keeps the epoch from moving on far enough to free it.
+    if(limbo_push(record, ptr, epoch) == ERROR)
+    {
+        limbo_reclaim(record, epoch_try_advance());
+        limbo_push(record, ptr, epoch);
+        return;
+    }
+
+    if(++record->retires < EBR_SCAN_RATE) return;
+
+    record->retires = 0;
+    epoch = epoch_try_advance();
+    limbo_reclaim(record, epoch);
+
+    if(pthread_mutex_trylock(&orphan_lock) == 0)
+    {
+        limbo_reclaim(&orphans, epoch);
+        pthread_mutex_unlock(&orphan_lock);
+    }
+}
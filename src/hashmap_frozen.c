@@ -0,0 +1,435 @@
+/**
+ * @file hashmap_frozen.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Immutable hashmap built over a minimal perfect hash, for tables that are filled once and then only read
+ * @details The keys are split into small buckets by one half of their hash. Each bucket gets a pilot, found by
+ * trying values until every key of the bucket lands on a free slot when the other half of the hash is mixed with
+ * it. Buckets are placed largest first while the table is still mostly free. The result maps n keys onto exactly
+ * n slots, so a lookup is one hash, one pilot load and one entry compare.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap_frozen.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#define KEYS_PER_BUCKET 4       // Average keys per pilot, trades pilot memory against search time
+#define PILOT_LIMIT (1u << 24)  // Pilots tried for one bucket before starting over with a new seed
+#define FREEZE_ATTEMPTS 8       // Seeds tried before giving up
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct frozen_entry frozen_entry_t;
+typedef struct frozen_key frozen_key_t;
+typedef struct frozen_bucket frozen_bucket_t;
+typedef struct freeze_ctx freeze_ctx_t;
+
+// Key-value pair in its slot of the table
+struct frozen_entry
+{
+    const char* key;    // Key of this entry, stored in the map's key bytes
+    void* value;        // Value of this entry
+    uint64_t hash;      // First half of the key's hash, compared before the key itself
+};
+
+// Key of the source map while the table is being built
+struct frozen_key
+{
+    const char* key;    // Key in the source map
+    void* value;        // Value of the key
+    uint64_t hash[2];   // Hash of the key: picks the bucket, then the slot with the bucket's pilot
+};
+
+// Keys sharing a pilot while the table is being built
+struct frozen_bucket
+{
+    size_t first;       // Index of the bucket's first key in the grouped keys
+    size_t count;       // Number of keys in the bucket
+    size_t bucket_idx;  // Index of the bucket's pilot
+};
+
+// Collects the keys of the source map
+struct freeze_ctx
+{
+    frozen_key_t* keys; // Keys collected so far
+    size_t space;       // Number of keys there is room for
+    size_t count;       // Number of key-value pairs seen
+    size_t key_bytes;   // Bytes needed to copy every key
+};
+
+// The frozen hashmap structure. Obfuscated from the user
+struct hashmap_frozen
+{
+    size_t size;                // Number of keys, and of slots
+    size_t bucket_count;        // Number of pilots
+    uint64_t seed;              // Seed for the hashes
+    uint32_t* pilots;           // Pilot of each bucket
+    frozen_entry_t* entries;    // Slot of each key
+    char* key_bytes;            // Copies of every key, back to back
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the slot a key lands on with a given pilot
+ * @details The pilot is mixed in before the reduction, not XORed onto the hash: with a power of 2 size the XOR
+ * would only translate the low bits, and keys of a bucket that share them could never be separated.
+ * 
+ * @param hash - second half of the key's hash
+ * @param pilot - pilot of the key's bucket
+ * @param size - number of slots
+ * @return size_t 
+ */
+static inline size_t frozen_slot(uint64_t hash, uint32_t pilot, size_t size)
+{
+    return MurmurHash3_fmix64(hash ^ MurmurHash3_fmix64(pilot)) % size;
+}
+
+/**
+ * @brief Copies one key-value pair of the source map into the build context
+ * 
+ * @param key - the key
+ * @param value - the value
+ * @param ctx - the freeze_ctx_t
+ */
+static void freeze_collect(const char* key, void* value, void* ctx)
+{
+    freeze_ctx_t* freeze = (freeze_ctx_t *)ctx;
+
+    // A multimap has more pairs than keys, it is turned down once they are counted
+    if(freeze->count >= freeze->space)
+    {
+        freeze->count++;
+        return;
+    }
+
+    freeze->keys[freeze->count].key = key;
+    freeze->keys[freeze->count].value = value;
+    freeze->key_bytes += strlen(key) + 1;
+    freeze->count++;
+}
+
+/**
+ * @brief Orders buckets largest first
+ * 
+ * @param a - first bucket
+ * @param b - second bucket
+ * @return int - <0, 0 or >0 like strcmp()
+ */
+static int bucket_compare(const void* a, const void* b)
+{
+    const frozen_bucket_t* left = (const frozen_bucket_t *)a;
+    const frozen_bucket_t* right = (const frozen_bucket_t *)b;
+
+    if(left->count != right->count) return (left->count > right->count) ? -1 : 1;
+
+    return (left->bucket_idx < right->bucket_idx) ? -1 : (left->bucket_idx > right->bucket_idx);
+}
+
+/**
+ * @brief Finds a pilot for every bucket with the map's current seed and fills the entries
+ * 
+ * @param map - the map being built, with size, bucket_count, seed and its arrays set
+ * @param keys - keys of the source map
+ * @param grouped - scratch array of map->size keys
+ * @param buckets - scratch array of map->bucket_count buckets
+ * @param taken - scratch array of map->size flags
+ * @return STATUS - ERROR if some bucket found no pilot with this seed
+ */
+static STATUS frozen_place(hashmap_frozen_t* map, frozen_key_t* keys, frozen_key_t* grouped, frozen_bucket_t* buckets, unsigned char* taken)
+{
+    size_t first = 0;
+
+    for(size_t key_idx = 0; key_idx < map->size; key_idx++)
+    {
+        MurmurHash3_x64_128_seed64(keys[key_idx].key, (int)strlen(keys[key_idx].key), map->seed, keys[key_idx].hash);
+    }
+
+    // Group the keys by bucket with a counting sort
+    for(size_t bucket_idx = 0; bucket_idx < map->bucket_count; bucket_idx++)
+    {
+        buckets[bucket_idx].count = 0;
+        buckets[bucket_idx].bucket_idx = bucket_idx;
+    }
+
+    for(size_t key_idx = 0; key_idx < map->size; key_idx++)
+    {
+        buckets[keys[key_idx].hash[0] % map->bucket_count].count++;
+    }
+
+    for(size_t bucket_idx = 0; bucket_idx < map->bucket_count; bucket_idx++)
+    {
+        buckets[bucket_idx].first = first;
+        first += buckets[bucket_idx].count;
+        buckets[bucket_idx].count = 0;
+    }
+
+    for(size_t key_idx = 0; key_idx < map->size; key_idx++)
+    {
+        frozen_bucket_t* bucket = &buckets[keys[key_idx].hash[0] % map->bucket_count];
+
+        grouped[bucket->first + bucket->count++] = keys[key_idx];
+    }
+
+    qsort(buckets, map->bucket_count, sizeof(frozen_bucket_t), bucket_compare);
+    memset(taken, 0, map->size);
+
+    for(size_t order = 0; order < map->bucket_count && buckets[order].count > 0; order++)
+    {
+        const frozen_bucket_t* bucket = &buckets[order];
+        uint32_t pilot = 0;
+
+        for(; pilot < PILOT_LIMIT; pilot++)
+        {
+            size_t placed = 0;
+
+            // Claim slots until one is taken, by another bucket or by a key of this one
+            for(; placed < bucket->count; placed++)
+            {
+                size_t slot = frozen_slot(grouped[bucket->first + placed].hash[1], pilot, map->size);
+
+                if(taken[slot]) break;
+                taken[slot] = 1;
+            }
+
+            if(placed == bucket->count) break;
+
+            while(placed > 0)
+            {
+                placed--;
+                taken[frozen_slot(grouped[bucket->first + placed].hash[1], pilot, map->size)] = 0;
+            }
+        }
+
+        if(pilot == PILOT_LIMIT) return ERROR;
+
+        map->pilots[bucket->bucket_idx] = pilot;
+
+        for(size_t key_idx = bucket->first; key_idx < bucket->first + bucket->count; key_idx++)
+        {
+            frozen_entry_t* entry = &map->entries[frozen_slot(grouped[key_idx].hash[1], pilot, map->size)];
+
+            entry->key = grouped[key_idx].key;
+            entry->value = grouped[key_idx].value;
+            entry->hash = grouped[key_idx].hash[0];
+        }
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Frees the map's arrays and the map
+ * 
+ * @param map - pointer to the map
+ */
+static void frozen_free(hashmap_frozen_t* map)
+{
+    free(map->pilots);
+    free(map->entries);
+    free(map->key_bytes);
+    free(map);
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds an immutable, perfectly hashed copy of map for read-only lookups
+ * @details Building is expected linear time in the number of keys. The keys are copied, the values are shared
+ * with map. The frozen map doesn't depend on map afterwards, so map may be destroyed without freeing the values
+ * and the frozen map left to own them. Multimaps can't be frozen.
+ * 
+ * @param map - pointer to the source map
+ * @return hashmap_frozen_t* - pointer to the hashmap_frozen_t object. NULL if error.
+ */
+hashmap_frozen_t* hashmap_freeze(const hashmap_t* map)
+{
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    size_t size = hashmap_size(map);
+    freeze_ctx_t freeze = { NULL, 0, 0, 0 };
+    hashmap_frozen_t* frozen = NULL;
+    frozen_key_t* grouped = NULL;
+    frozen_bucket_t* buckets = NULL;
+    unsigned char* taken = NULL;
+    STATUS status = ERROR;
+    char* key_bytes = NULL;
+
+    frozen = (hashmap_frozen_t *)calloc(1, sizeof(hashmap_frozen_t));
+    freeze.keys = (frozen_key_t *)malloc((size + 1) * sizeof(frozen_key_t));
+
+    if(frozen == NULL || freeze.keys == NULL)
+    {
+        free(frozen);
+        free(freeze.keys);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    freeze.space = size;
+    hashmap_foreach(map, freeze_collect, &freeze);
+
+    // Keys with several values have no single slot to go to
+    if(freeze.count > freeze.space)
+    {
+        free(frozen);
+        free(freeze.keys);
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    frozen->size = freeze.count;
+    frozen->bucket_count = freeze.count / KEYS_PER_BUCKET + 1;
+    frozen->pilots = (uint32_t *)malloc(frozen->bucket_count * sizeof(uint32_t));
+    frozen->entries = (frozen_entry_t *)malloc((freeze.count + 1) * sizeof(frozen_entry_t));
+    frozen->key_bytes = (char *)malloc(freeze.key_bytes + 1);
+    grouped = (frozen_key_t *)malloc((freeze.count + 1) * sizeof(frozen_key_t));
+    buckets = (frozen_bucket_t *)malloc(frozen->bucket_count * sizeof(frozen_bucket_t));
+    taken = (unsigned char *)malloc(freeze.count + 1);
+
+    if(frozen->pilots != NULL && frozen->entries != NULL && frozen->key_bytes != NULL && grouped != NULL && buckets != NULL && taken != NULL)
+    {
+        // Two keys with the same 128 bit hash can never be separated, a new seed fixes that along with a stuck bucket
+        for(int attempt = 0; attempt < FREEZE_ATTEMPTS && status == ERROR; attempt++)
+        {
+            frozen->seed = hashmap_random_u64();
+            status = frozen_place(frozen, freeze.keys, grouped, buckets, taken);
+        }
+
+        hashmap_set_errno((status == SUCCESS) ? HASHMAP_ERR_NONE : HASHMAP_ERR_INVALID_CONFIG);
+    }
+    else
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+    }
+
+    free(freeze.keys);
+    free(grouped);
+    free(buckets);
+    free(taken);
+
+    if(status == ERROR)
+    {
+        frozen_free(frozen);
+        return NULL;
+    }
+
+    // Point the entries at copies of the keys so the source map can go away
+    key_bytes = frozen->key_bytes;
+
+    for(size_t slot = 0; slot < frozen->size; slot++)
+    {
+        size_t len = strlen(frozen->entries[slot].key) + 1;
+
+        memcpy(key_bytes, frozen->entries[slot].key, len);
+        frozen->entries[slot].key = key_bytes;
+        key_bytes += len;
+    }
+
+    return frozen;
+}
+
+/**
+ * @brief Safely deallocates map. User can optionally provide a function for freeing values.
+ * @details Only pass fn if the frozen map was given ownership of the values, see hashmap_freeze().
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional pointer to function for freeing values. Can pass NULL to not have library handle freeing values.
+ */
+void hashmap_frozen_destroy(hashmap_frozen_t* map, free_value_fn_t fn)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(map == NULL) return;
+
+    for(size_t slot = 0; fn != NULL && slot < map->size; slot++)
+    {
+        fn(map->entries[slot].value);
+    }
+
+    frozen_free(map);
+}
+
+/**
+ * @brief Returns the value for the given key
+ * @details Safe to call from any number of threads at once, the map never changes
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_frozen_get(const hashmap_frozen_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    uint64_t hash[2] = {0};
+    const frozen_entry_t* entry = NULL;
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(map->size > 0)
+    {
+        MurmurHash3_x64_128_seed64(key, (int)strlen(key), map->seed, hash);
+        entry = &map->entries[frozen_slot(hash[1], map->pilots[hash[0] % map->bucket_count], map->size)];
+
+        // Every slot holds some key, so a missing key is caught by the compare
+        if(entry->hash == hash[0] && strcmp(entry->key, key) == 0) return entry->value;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+
+    return NULL;
+}
+
+/**
+ * @brief Returns the number of keys in the map
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_frozen_size(const hashmap_frozen_t* map)
+{
+    return (map != NULL) ? map->size : 0;
+}
+
+/**
+ * @brief Calls fn on every key-value pair of the map
+ * @details The order is unspecified
+ * 
+ * @param map - pointer to the map
+ * @param fn - function called with each key, its value and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS
+ */
+STATUS hashmap_frozen_foreach(const hashmap_frozen_t* map, hashmap_foreach_fn_t fn, void* ctx)
+{
+    if(map == NULL || fn == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    for(size_t slot = 0; slot < map->size; slot++)
+    {
+        fn(map->entries[slot].key, map->entries[slot].value, ctx);
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return SUCCESS;
+}
@@ -0,0 +1,451 @@
+/**
+ * @file hashmap_index.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Ordered index of a hashmap's keys for prefix and range scans
+ * @details The index is a crit-bit tree: every internal node records the first bit at which the keys of its two
+ * subtrees differ, and the leaves are the keys stored by the map's buckets, not copies of them, so the map must
+ * point a leaf at the new copy whenever it copies a key. An in-order walk returns the keys in strcmp() order.
+ * Finding where a prefix or a range starts costs one descent, O(key length), and every key returned after that
+ * costs O(1) amortized, so scans never touch keys outside the result.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap_internal.h"
+
+#define INDEX_STACK_INITIAL 64  // Subtrees a walk has room for before its stack grows
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct index_node index_node_t;
+typedef struct index_stack index_stack_t;
+
+// Internal node. Pointers to internal nodes are tagged with their lowest bit, leaves are the map's key strings.
+struct index_node
+{
+    void* child[2];     // Subtrees whose keys have the critical bit clear and set
+    size_t byte;        // Byte of the critical bit
+    uint8_t otherbits;  // Every bit of that byte except the critical one
+};
+
+// The ordered index structure. Obfuscated from the maps using it
+struct hashmap_index
+{
+    void* root;         // Root node or only leaf, NULL while empty
+};
+
+// Subtrees left to walk, the next one on top
+struct index_stack
+{
+    void** items;       // Tagged subtree pointers
+    size_t count;       // Number of subtrees on the stack
+    size_t space;       // Number of subtrees items has room for
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns whether p points to an internal node rather than a leaf
+ * 
+ * @param p - tagged pointer
+ * @return int
+ */
+static inline int is_node(const void* p)
+{
+    return ((uintptr_t)p & 1) != 0;
+}
+
+/**
+ * @brief Strips the tag from a pointer to an internal node
+ * 
+ * @param p - tagged pointer
+ * @return index_node_t*
+ */
+static inline index_node_t* as_node(const void* p)
+{
+    return (index_node_t *)((uintptr_t)p - 1);
+}
+
+/**
+ * @brief Returns the subtree of node that key belongs to
+ * 
+ * @param node - internal node
+ * @param key - key bytes
+ * @param len - length of the key
+ * @return int - 0 or 1
+ */
+static inline int direction(const index_node_t* node, const uint8_t* key, size_t len)
+{
+    uint8_t c = (node->byte < len) ? key[node->byte] : 0;
+
+    return (1 + (node->otherbits | c)) >> 8;
+}
+
+/**
+ * @brief Finds the first bit at which two keys differ
+ * 
+ * @param leaf - key of a leaf
+ * @param key - key bytes
+ * @param len - length of key
+ * @param byte - set to the byte of the differing bit
+ * @param otherbits - set to every bit of that byte except the differing one
+ * @return int - 0 if the keys are equal, 1 otherwise
+ */
+static int first_difference(const uint8_t* leaf, const uint8_t* key, size_t len, size_t* byte, uint8_t* otherbits)
+{
+    uint32_t bits = 0;
+    size_t pos = 0;
+
+    // The leaf's terminator differs from the key's bytes if it is shorter
+    while(pos < len && leaf[pos] == key[pos]) pos++;
+
+    bits = (pos < len) ? (uint32_t)(leaf[pos] ^ key[pos]) : leaf[pos];
+    if(bits == 0) return 0;
+
+    // Keep only the highest differing bit
+    bits |= bits >> 1;
+    bits |= bits >> 2;
+    bits |= bits >> 4;
+    *byte = pos;
+    *otherbits = (uint8_t)((bits & ~(bits >> 1)) ^ 255);
+
+    return 1;
+}
+
+/**
+ * @brief Pushes a subtree onto a walk's stack
+ * 
+ * @param stack - the stack
+ * @param p - tagged subtree pointer
+ * @return STATUS - ERROR if the stack could not grow
+ */
+static STATUS stack_push(index_stack_t* stack, void* p)
+{
+    if(stack->count == stack->space)
+    {
+        size_t space = (stack->space == 0) ? INDEX_STACK_INITIAL : stack->space * 2;
+        void** items = (void **)realloc(stack->items, space * sizeof(void *));
+
+        if(items == NULL) return ERROR;
+
+        stack->items = items;
+        stack->space = space;
+    }
+
+    stack->items[stack->count++] = p;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Calls fn on the keys of the stacked subtrees in order, stopping at the first key not below high
+ * 
+ * @param stack - subtrees to walk, the leftmost on top. Freed on return.
+ * @param high - exclusive upper bound, NULL for none
+ * @param fn - function called with each key and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS - ERROR if the stack could not grow
+ */
+static STATUS stack_walk(index_stack_t* stack, const char* high, hashmap_index_fn_t fn, void* ctx)
+{
+    STATUS status = SUCCESS;
+
+    while(stack->count > 0 && status == SUCCESS)
+    {
+        void* p = stack->items[--stack->count];
+
+        // Go down the left spine, leaving the right subtrees for later
+        while(is_node(p) && status == SUCCESS)
+        {
+            status = stack_push(stack, as_node(p)->child[1]);
+            p = as_node(p)->child[0];
+        }
+
+        if(status == ERROR) break;
+        if(high != NULL && strcmp((const char *)p, high) >= 0) break;
+
+        fn((const char *)p, ctx);
+    }
+
+    free(stack->items);
+
+    return status;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates an empty index
+ * 
+ * @return hashmap_index_t* - NULL if it could not be allocated
+ */
+hashmap_index_t* hashmap_index_create(void)
+{
+    return (hashmap_index_t *)calloc(1, sizeof(hashmap_index_t));
+}
+
+/**
+ * @brief Frees every node of the index, leaving it empty
+ * @details Left subtrees are rotated up until the left child is a leaf, so no stack is needed however deep the
+ * tree is
+ * 
+ * @param index - the index
+ */
+void hashmap_index_clear(hashmap_index_t* index)
+{
+    void* p = index->root;
+
+    while(is_node(p))
+    {
+        index_node_t* node = as_node(p);
+        void* left = node->child[0];
+
+        if(is_node(left))
+        {
+            node->child[0] = as_node(left)->child[1];
+            as_node(left)->child[1] = p;
+            p = left;
+            continue;
+        }
+
+        p = node->child[1];
+        free(node);
+    }
+
+    index->root = NULL;
+}
+
+/**
+ * @brief Frees the index
+ * 
+ * @param index - the index, may be NULL
+ */
+void hashmap_index_destroy(hashmap_index_t* index)
+{
+    if(index == NULL) return;
+
+    hashmap_index_clear(index);
+    free(index);
+}
+
+/**
+ * @brief Adds key to the index. Adding a key that is already there does nothing.
+ * 
+ * @param index - the index
+ * @param key - the key as stored by the map, which must outlive its leaf
+ * @return STATUS - ERROR if memory could not be allocated
+ */
+STATUS hashmap_index_insert(hashmap_index_t* index, const char* key)
+{
+    const uint8_t* bytes = (const uint8_t *)key;
+    size_t len = strlen(key);
+    void* p = index->root;
+    void** where = &index->root;
+    index_node_t* node = NULL;
+    size_t byte = 0;
+    uint8_t otherbits = 0;
+    int old_direction = 0;
+
+    if(p == NULL)
+    {
+        index->root = (void *)key;
+        return SUCCESS;
+    }
+
+    // The closest leaf shares the longest run of leading bits with key
+    while(is_node(p)) p = as_node(p)->child[direction(as_node(p), bytes, len)];
+
+    if(!first_difference((const uint8_t *)p, bytes, len, &byte, &otherbits)) return SUCCESS;
+
+    old_direction = (1 + (otherbits | ((const uint8_t *)p)[byte])) >> 8;
+    node = (index_node_t *)malloc(sizeof(index_node_t));
+
+    if(node == NULL) return ERROR;
+
+    node->byte = byte;
+    node->otherbits = otherbits;
+    node->child[1 - old_direction] = (void *)key;
+
+    // The new node goes above the first node testing a later bit
+    for(p = *where; is_node(p); p = *where)
+    {
+        index_node_t* current = as_node(p);
+
+        if(current->byte > byte || (current->byte == byte && current->otherbits > otherbits)) break;
+
+        where = &current->child[direction(current, bytes, len)];
+    }
+
+    node->child[old_direction] = *where;
+    *where = (void *)((uintptr_t)node + 1);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Removes key from the index. Removing a key that isn't there does nothing.
+ * 
+ * @param index - the index
+ * @param key - the key
+ */
+void hashmap_index_remove(hashmap_index_t* index, const char* key)
+{
+    const uint8_t* bytes = (const uint8_t *)key;
+    size_t len = strlen(key);
+    void** where = &index->root;
+    void** parent_where = NULL;
+    index_node_t* parent = NULL;
+    int side = 0;
+
+    if(index->root == NULL) return;
+
+    while(is_node(*where))
+    {
+        parent_where = where;
+        parent = as_node(*where);
+        side = direction(parent, bytes, len);
+        where = &parent->child[side];
+    }
+
+    if(strcmp((const char *)*where, key) != 0) return;
+
+    // The sibling takes the parent's place
+    if(parent == NULL)
+    {
+        index->root = NULL;
+        return;
+    }
+
+    *parent_where = parent->child[1 - side];
+    free(parent);
+}
+
+/**
+ * @brief Points the leaf of key at key, for when the map moved the key to a new copy with the same bytes
+ * 
+ * @param index - the index
+ * @param key - the new copy of the key
+ */
+void hashmap_index_update(hashmap_index_t* index, const char* key)
+{
+    const uint8_t* bytes = (const uint8_t *)key;
+    size_t len = strlen(key);
+    void** where = &index->root;
+
+    if(index->root == NULL) return;
+
+    while(is_node(*where))
+    {
+        index_node_t* node = as_node(*where);
+
+        where = &node->child[direction(node, bytes, len)];
+    }
+
+    if(strcmp((const char *)*where, key) == 0) *where = (void *)key;
+}
+
+/**
+ * @brief Calls fn, in order, on every key of the index starting with prefix
+ * 
+ * @param index - the index
+ * @param prefix - the prefix, "" for every key
+ * @param fn - function called with each key and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS - ERROR if memory could not be allocated
+ */
+STATUS hashmap_index_prefix(const hashmap_index_t* index, const char* prefix, hashmap_index_fn_t fn, void* ctx)
+{
+    const uint8_t* bytes = (const uint8_t *)prefix;
+    size_t len = strlen(prefix);
+    index_stack_t stack = { NULL, 0, 0 };
+    void* p = index->root;
+    void* top = p;
+
+    if(p == NULL) return SUCCESS;
+
+    // Every key below top agrees with prefix on the bits tested so far
+    while(is_node(p))
+    {
+        index_node_t* node = as_node(p);
+
+        p = node->child[direction(node, bytes, len)];
+        if(node->byte < len) top = p;
+    }
+
+    if(strncmp((const char *)p, prefix, len) != 0) return SUCCESS;
+    if(stack_push(&stack, top) == ERROR) return ERROR;
+
+    return stack_walk(&stack, NULL, fn, ctx);
+}
+
+/**
+ * @brief Calls fn, in order, on every key of the index in [low, high)
+ * 
+ * @param index - the index
+ * @param low - inclusive lower bound, NULL for none
+ * @param high - exclusive upper bound, NULL for none
+ * @param fn - function called with each key and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS - ERROR if memory could not be allocated
+ */
+STATUS hashmap_index_range(const hashmap_index_t* index, const char* low, const char* high, hashmap_index_fn_t fn, void* ctx)
+{
+    const uint8_t* bytes = (const uint8_t *)low;
+    size_t len = (low != NULL) ? strlen(low) : 0;
+    index_stack_t stack = { NULL, 0, 0 };
+    void* p = index->root;
+    const uint8_t* closest = NULL;
+    size_t byte = 0;
+    uint8_t otherbits = 0;
+    int differs = 0;
+
+    if(p == NULL) return SUCCESS;
+
+    if(low == NULL)
+    {
+        if(stack_push(&stack, p) == ERROR) return ERROR;
+        return stack_walk(&stack, high, fn, ctx);
+    }
+
+    while(is_node(p)) p = as_node(p)->child[direction(as_node(p), bytes, len)];
+
+    closest = (const uint8_t *)p;
+    differs = first_difference(closest, bytes, len, &byte, &otherbits);
+
+    // Follow low down to where it leaves the tree, stacking the subtrees to its right on the way
+    for(p = index->root; is_node(p); )
+    {
+        index_node_t* node = as_node(p);
+        int side = 0;
+
+        if(differs && (node->byte > byte || (node->byte == byte && node->otherbits > otherbits))) break;
+
+        side = direction(node, bytes, len);
+
+        if(side == 0 && stack_push(&stack, node->child[1]) == ERROR)
+        {
+            free(stack.items);
+            return ERROR;
+        }
+
+        p = node->child[side];
+    }
+
+    // The keys under p share the closest leaf's bit where it differs from low, all of them are above low if it is set
+    if(!differs || ((1 + (otherbits | closest[byte])) >> 8) == 1)
+    {
+        if(stack_push(&stack, p) == ERROR)
+        {
+            free(stack.items);
+            return ERROR;
+        }
+    }
+
+    return stack_walk(&stack, high, fn, ctx);
+}
@@ -0,0 +1,236 @@
+/**
+ * @file hashmap_intern.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Pool of reference counted key strings that any number of hashmaps can share
+ * @details Maps created with a pool keep one copy of each distinct key between them. The pool is a chained hash
+ * set behind a mutex, so maps on different threads can share it. A string is freed when its last reference is
+ * released. The count and hash sit in a header just before the key bytes so releasing needs no lookup.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap_intern.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#define INTERN_INITIAL_CAPACITY 64  // Buckets of a new pool
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct interned interned_t;
+
+// One distinct key string
+struct interned
+{
+    interned_t* next;   // Next string in the same bucket
+    uint64_t hash;      // Hash of the key
+    size_t refs;        // Number of map entries using the key
+    char key[];         // The key bytes handed out to the maps
+};
+
+// The intern pool structure. Obfuscated from the user
+struct hashmap_intern
+{
+    pthread_mutex_t lock;   // Held while the pool is used
+    uint64_t seed;          // Seed for the hashes
+    size_t size;            // Number of distinct strings
+    size_t capacity;        // Number of buckets
+    interned_t** buckets;   // Chains of strings
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Doubles the bucket count of the pool. The pool keeps working with longer chains if it can't.
+ * 
+ * @param pool - pointer to the pool, locked
+ */
+static void intern_grow(hashmap_intern_t* pool)
+{
+    size_t capacity = pool->capacity * 2;
+    interned_t** buckets = (interned_t **)calloc(capacity, sizeof(interned_t *));
+
+    if(buckets == NULL) return;
+
+    for(size_t bucket_idx = 0; bucket_idx < pool->capacity; bucket_idx++)
+    {
+        interned_t* current = pool->buckets[bucket_idx];
+
+        while(current != NULL)
+        {
+            interned_t* next = current->next;
+            size_t new_idx = current->hash & (capacity - 1);
+
+            current->next = buckets[new_idx];
+            buckets[new_idx] = current;
+            current = next;
+        }
+    }
+
+    free(pool->buckets);
+    pool->buckets = buckets;
+    pool->capacity = capacity;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates an empty intern pool and returns the handle
+ * @details Hand it to hashmap_create_ex() through hashmap_config_t.intern
+ * 
+ * @return hashmap_intern_t* - pointer to the pool. NULL if error.
+ */
+hashmap_intern_t* hashmap_intern_create(void)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_intern_t* pool = (hashmap_intern_t *)malloc(sizeof(hashmap_intern_t));
+
+    if(pool != NULL) pool->buckets = (interned_t **)calloc(INTERN_INITIAL_CAPACITY, sizeof(interned_t *));
+
+    if(pool == NULL || pool->buckets == NULL)
+    {
+        free(pool);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pool->seed = hashmap_random_u64();
+    pool->size = 0;
+    pool->capacity = INTERN_INITIAL_CAPACITY;
+
+    return pool;
+}
+
+/**
+ * @brief Frees the pool and every string left in it
+ * @details Every map using the pool must be destroyed first
+ * 
+ * @param pool - pointer to the pool
+ */
+void hashmap_intern_destroy(hashmap_intern_t* pool)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(pool == NULL) return;
+
+    for(size_t bucket_idx = 0; bucket_idx < pool->capacity; bucket_idx++)
+    {
+        interned_t* current = pool->buckets[bucket_idx];
+
+        while(current != NULL)
+        {
+            interned_t* next = current->next;
+
+            free(current);
+            current = next;
+        }
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->buckets);
+    free(pool);
+}
+
+/**
+ * @brief Returns the number of distinct strings in the pool
+ * 
+ * @param pool - pointer to the pool
+ * @return size_t - 0 if pool is NULL
+ */
+size_t hashmap_intern_size(hashmap_intern_t* pool)
+{
+    size_t size = 0;
+
+    if(pool == NULL) return 0;
+
+    pthread_mutex_lock(&pool->lock);
+    size = pool->size;
+    pthread_mutex_unlock(&pool->lock);
+
+    return size;
+}
+
+/**
+ * @brief Returns the pool's copy of key, adding one if needed, and takes a reference to it
+ * 
+ * @param pool - pointer to the pool
+ * @param key - the key
+ * @return char* - the pooled key. NULL if it could not be allocated.
+ */
+char* hashmap_intern_acquire(hashmap_intern_t* pool, const char* key)
+{
+    size_t len = strlen(key);
+    uint64_t hash[2] = {0};
+    interned_t* current = NULL;
+    size_t bucket_idx = 0;
+
+    MurmurHash3_x64_128_seed64(key, (int)len, pool->seed, hash);
+
+    pthread_mutex_lock(&pool->lock);
+    bucket_idx = hash[0] & (pool->capacity - 1);
+
+    for(current = pool->buckets[bucket_idx]; current != NULL; current = current->next)
+    {
+        if(current->hash == hash[0] && strcmp(current->key, key) == 0) break;
+    }
+
+    if(current == NULL)
+    {
+        current = (interned_t *)malloc(sizeof(interned_t) + len + 1);
+
+        if(current == NULL)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+
+        memcpy(current->key, key, len + 1);
+        current->hash = hash[0];
+        current->refs = 0;
+        current->next = pool->buckets[bucket_idx];
+        pool->buckets[bucket_idx] = current;
+
+        if(++pool->size > pool->capacity) intern_grow(pool);
+    }
+
+    current->refs++;
+    pthread_mutex_unlock(&pool->lock);
+
+    return current->key;
+}
+
+/**
+ * @brief Drops a reference taken by hashmap_intern_acquire(), freeing the string with the last one
+ * 
+ * @param pool - pointer to the pool
+ * @param key - pooled key returned by hashmap_intern_acquire()
+ */
+void hashmap_intern_release(hashmap_intern_t* pool, char* key)
+{
+    interned_t* string = (interned_t *)(key - offsetof(interned_t, key));
+    interned_t** link = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+
+    if(--string->refs == 0)
+    {
+        link = &pool->buckets[string->hash & (pool->capacity - 1)];
+
+        while(*link != string) link = &(*link)->next;
+
+        *link = string->next;
+        pool->size--;
+        free(string);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file hashmap_internal.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Functions shared between the library's translation units. Not part of the API.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_INTERNAL_H
+#define _C_HASH_MAP_INTERNAL_H
+
+#include <stdint.h>
+
+#include "hashmap.h"
+#include "hashmap_trace.h"
+
+typedef struct hashmap_index hashmap_index_t;
+typedef void (*hashmap_index_fn_t)(const char* key, void* ctx);
+typedef void (*hashmap_range_fn_t)(void* arg, size_t begin, size_t end, size_t worker);
+
+void hashmap_set_errno(hashmap_err_t err);
+uint64_t hashmap_random_u64(void);
+hashmap_t* hashmap_create_aligned(size_t capacity, const hashmap_config_t* config);
+
+char* hashmap_intern_acquire(hashmap_intern_t* pool, const char* key);
+void hashmap_intern_release(hashmap_intern_t* pool, char* key);
+
+hashmap_index_t* hashmap_index_create(void);
+void hashmap_index_destroy(hashmap_index_t* index);
+void hashmap_index_clear(hashmap_index_t* index);
+STATUS hashmap_index_insert(hashmap_index_t* index, const char* key);
+void hashmap_index_remove(hashmap_index_t* index, const char* key);
+void hashmap_index_update(hashmap_index_t* index, const char* key);
+STATUS hashmap_index_prefix(const hashmap_index_t* index, const char* prefix, hashmap_index_fn_t fn, void* ctx);
+STATUS hashmap_index_range(const hashmap_index_t* index, const char* low, const char* high, hashmap_index_fn_t fn, void* ctx);
+
+size_t hashmap_pool_workers(const hashmap_parallel_t* parallel);
+STATUS hashmap_pool_for(size_t count, const hashmap_parallel_t* parallel, hashmap_range_fn_t fn, void* arg);
+STATUS hashmap_pool_defer(hashmap_task_fn_t fn, void* arg);
+void hashmap_pool_wait(void);
+
+uint64_t hashmap_trace_now(void);
+void hashmap_trace_record(hashmap_trace_op_t op, uint64_t elapsed_ns, size_t probes, size_t chain);
+
+STATUS hashmap_ebr_enter(void);
+void hashmap_ebr_exit(void);
+void hashmap_ebr_retire(void* ptr);
+
+#endif
@@ -0,0 +1,457 @@
+/**
+ * @file hashmap_pool.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Thread pool and work-stealing loop behind the parallel bulk operations
+ * @details hashmap_pool_for() splits an index range into one slice per worker. Each worker takes POOL_CHUNK sized
+ * pieces from the front of its own slice and, once it is empty, steals the back half of another worker's slice,
+ * so buckets with long chains don't leave the other workers idle. The caller is worker 0. The other workers
+ * are tasks run by a caller-supplied executor or by the internal pool, whose threads are started on first use.
+ * When the caller runs out of work it takes back the tasks no pool thread has started yet, so the loop never
+ * waits on a busy pool and can be nested.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "hashmap_internal.h"
+
+#define CACHE_LINE 64           // Assumed cache line size
+#define POOL_CHUNK 1024         // Indexes a worker takes from its slice at a time
+#define POOL_MAX_THREADS 64     // Most threads the internal pool starts
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct pool_task pool_task_t;
+typedef struct pool_slice pool_slice_t;
+typedef struct pool_job pool_job_t;
+
+// Task waiting in the internal pool's queue
+struct pool_task
+{
+    hashmap_task_fn_t fn;   // Function to run
+    void* arg;              // Passed to fn
+    pool_task_t* next;      // Next task in the queue
+};
+
+// Part of the range left to one worker
+struct pool_slice
+{
+    _Alignas(CACHE_LINE) pthread_mutex_t lock;  // Held while the slice is changed
+    size_t begin;                               // First index left
+    size_t end;                                 // One past the last index left
+};
+
+// One hashmap_pool_for() call, shared with its tasks
+struct pool_job
+{
+    hashmap_range_fn_t fn;      // Called with each piece of the range
+    void* arg;                  // Passed to fn
+    size_t workers;             // Number of slices
+    pool_slice_t* slices;       // One slice per worker
+    atomic_size_t next_worker;  // Worker index handed to the next task that starts
+    pthread_mutex_t lock;       // Protects pending
+    pthread_cond_t done;        // Signalled when a task finishes
+    size_t pending;             // Tasks that were handed out and have not finished
+};
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;   // Protects the queue and the deferred count
+static pthread_cond_t pool_wake = PTHREAD_COND_INITIALIZER;     // Signalled when a task is queued
+static pthread_cond_t pool_idle = PTHREAD_COND_INITIALIZER;     // Signalled when the deferred count drops to 0
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;            // Starts the threads once
+static pool_task_t* queue_head = NULL;                          // Oldest queued task
+static pool_task_t* queue_tail = NULL;                          // Newest queued task
+static size_t pool_threads = 0;                                 // Number of threads started
+static size_t deferred = 0;                                     // Background tasks queued or running
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the number of online CPUs
+ * 
+ * @return size_t - at least 1
+ */
+static size_t online_cpus(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (cpus > 0) ? (size_t)cpus : 1;
+}
+
+/**
+ * @brief Runs queued tasks for the life of the process
+ * 
+ * @param arg - unused
+ * @return void* - never returns
+ */
+static void* pool_thread(void* arg)
+{
+    (void)arg;
+
+    for(;;)
+    {
+        pool_task_t* task = NULL;
+
+        pthread_mutex_lock(&pool_lock);
+        while(queue_head == NULL) pthread_cond_wait(&pool_wake, &pool_lock);
+
+        task = queue_head;
+        queue_head = task->next;
+        if(queue_head == NULL) queue_tail = NULL;
+        pthread_mutex_unlock(&pool_lock);
+
+        task->fn(task->arg);
+        free(task);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Starts one thread per online CPU but the caller's, up to POOL_MAX_THREADS
+ * 
+ */
+static void pool_start(void)
+{
+    size_t wanted = online_cpus() - 1;
+
+    if(wanted == 0) wanted = 1;
+    if(wanted > POOL_MAX_THREADS) wanted = POOL_MAX_THREADS;
+
+    for(size_t thread_idx = 0; thread_idx < wanted; thread_idx++)
+    {
+        pthread_t thread;
+
+        if(pthread_create(&thread, NULL, pool_thread, NULL) != 0) break;
+
+        pthread_detach(thread);
+        pool_threads++;
+    }
+}
+
+/**
+ * @brief Queues a task for the internal pool
+ * 
+ * @param fn - function to run
+ * @param arg - passed to fn
+ * @return STATUS - ERROR if the pool has no threads or the task could not be allocated
+ */
+static STATUS pool_submit(hashmap_task_fn_t fn, void* arg)
+{
+    pool_task_t* task = NULL;
+
+    pthread_once(&pool_once, pool_start);
+    if(pool_threads == 0) return ERROR;
+
+    task = (pool_task_t *)malloc(sizeof(pool_task_t));
+    if(task == NULL) return ERROR;
+
+    task->fn = fn;
+    task->arg = arg;
+    task->next = NULL;
+
+    pthread_mutex_lock(&pool_lock);
+    if(queue_tail != NULL) queue_tail->next = task;
+    else queue_head = task;
+    queue_tail = task;
+    pthread_cond_signal(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Takes the tasks of a job that no pool thread has started out of the queue
+ * 
+ * @param fn - task function of the job
+ * @param arg - task argument of the job
+ * @return size_t - number of tasks removed
+ */
+static size_t pool_cancel(hashmap_task_fn_t fn, void* arg)
+{
+    size_t removed = 0;
+    pool_task_t* previous = NULL;
+
+    pthread_mutex_lock(&pool_lock);
+
+    for(pool_task_t* task = queue_head; task != NULL;)
+    {
+        pool_task_t* next = task->next;
+
+        if(task->fn == fn && task->arg == arg)
+        {
+            if(previous != NULL) previous->next = next;
+            else queue_head = next;
+            if(queue_tail == task) queue_tail = previous;
+
+            free(task);
+            removed++;
+        }
+        else
+        {
+            previous = task;
+        }
+
+        task = next;
+    }
+
+    pthread_mutex_unlock(&pool_lock);
+
+    return removed;
+}
+
+/**
+ * @brief Takes the next piece of work for a worker, from its own slice or stolen from another
+ * 
+ * @param job - the job
+ * @param worker - index of the worker
+ * @param begin - set to the first index of the piece
+ * @param end - set to one past the last index of the piece
+ * @return int - 1 if a piece was taken, 0 once the whole range is handed out
+ */
+static int slice_take(pool_job_t* job, size_t worker, size_t* begin, size_t* end)
+{
+    // Only one slice is locked at a time, so two workers stealing from each other can't deadlock
+    for(size_t offset = 0; offset < job->workers; offset++)
+    {
+        pool_slice_t* slice = &job->slices[(worker + offset) % job->workers];
+        size_t stolen_end = 0;
+
+        pthread_mutex_lock(&slice->lock);
+
+        if(slice->begin == slice->end)
+        {
+            pthread_mutex_unlock(&slice->lock);
+            continue;
+        }
+
+        if(offset == 0)
+        {
+            *begin = slice->begin;
+            *end = (slice->end - slice->begin > POOL_CHUNK) ? slice->begin + POOL_CHUNK : slice->end;
+            slice->begin = *end;
+            pthread_mutex_unlock(&slice->lock);
+            return 1;
+        }
+
+        // Steal the back half, the owner keeps working from the front
+        *begin = slice->begin + (slice->end - slice->begin) / 2;
+        stolen_end = slice->end;
+        slice->end = *begin;
+        pthread_mutex_unlock(&slice->lock);
+
+        *end = (stolen_end - *begin > POOL_CHUNK) ? *begin + POOL_CHUNK : stolen_end;
+
+        // The rest of the stolen half becomes this worker's slice
+        pthread_mutex_lock(&job->slices[worker].lock);
+        job->slices[worker].begin = *end;
+        job->slices[worker].end = stolen_end;
+        pthread_mutex_unlock(&job->slices[worker].lock);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Works on the job until the whole range is handed out
+ * 
+ * @param job - the job
+ * @param worker - index of the worker
+ */
+static void job_work(pool_job_t* job, size_t worker)
+{
+    size_t begin = 0;
+    size_t end = 0;
+
+    while(slice_take(job, worker, &begin, &end)) job->fn(job->arg, begin, end, worker);
+}
+
+/**
+ * @brief Task run by the pool or the executor for each worker but the caller
+ * 
+ * @param arg - the job
+ */
+static void job_task(void* arg)
+{
+    pool_job_t* job = (pool_job_t *)arg;
+
+    job_work(job, atomic_fetch_add(&job->next_worker, 1));
+
+    pthread_mutex_lock(&job->lock);
+    job->pending--;
+    pthread_cond_signal(&job->done);
+    pthread_mutex_unlock(&job->lock);
+}
+
+/**
+ * @brief Runs a deferred task and wakes hashmap_pool_wait() when it was the last
+ * 
+ * @param arg - the pool_task_t holding the task
+ */
+static void deferred_task(void* arg)
+{
+    pool_task_t* task = (pool_task_t *)arg;
+
+    task->fn(task->arg);
+    free(task);
+
+    pthread_mutex_lock(&pool_lock);
+    if(--deferred == 0) pthread_cond_broadcast(&pool_idle);
+    pthread_mutex_unlock(&pool_lock);
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the number of workers a parallel operation uses
+ * 
+ * @param parallel - options, NULL for the defaults
+ * @return size_t - at least 1
+ */
+size_t hashmap_pool_workers(const hashmap_parallel_t* parallel)
+{
+    size_t workers = (parallel != NULL && parallel->threads > 0) ? parallel->threads : online_cpus();
+
+    return (workers > POOL_MAX_THREADS + 1) ? POOL_MAX_THREADS + 1 : workers;
+}
+
+/**
+ * @brief Calls fn over pieces of [0, count) on several threads and returns once every index was covered
+ * @details fn gets the index of the worker calling it, below hashmap_pool_workers(parallel), so it can keep
+ * per-worker results. Every index is passed to fn exactly once.
+ * 
+ * @param count - size of the range
+ * @param parallel - options, NULL for the defaults
+ * @param fn - called with arg, a piece of the range and the worker index
+ * @param arg - passed to fn
+ * @return STATUS - ERROR if the slices could not be allocated
+ */
+STATUS hashmap_pool_for(size_t count, const hashmap_parallel_t* parallel, hashmap_range_fn_t fn, void* arg)
+{
+    pool_job_t job;
+    size_t workers = hashmap_pool_workers(parallel);
+
+    // Below a couple of chunks per worker the threads would only get in each other's way
+    if(count / POOL_CHUNK < workers) workers = (count + POOL_CHUNK - 1) / POOL_CHUNK;
+
+    if(workers <= 1)
+    {
+        if(count > 0) fn(arg, 0, count, 0);
+        return SUCCESS;
+    }
+
+    job.slices = (pool_slice_t *)aligned_alloc(CACHE_LINE, workers * sizeof(pool_slice_t));
+    if(job.slices == NULL) return ERROR;
+
+    job.fn = fn;
+    job.arg = arg;
+    job.workers = workers;
+    job.pending = 0;
+    atomic_init(&job.next_worker, 1);
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.done, NULL);
+
+    for(size_t worker = 0; worker < workers; worker++)
+    {
+        pthread_mutex_init(&job.slices[worker].lock, NULL);
+        job.slices[worker].begin = count / workers * worker;
+        job.slices[worker].end = (worker + 1 == workers) ? count : count / workers * (worker + 1);
+    }
+
+    for(size_t worker = 1; worker < workers; worker++)
+    {
+        pthread_mutex_lock(&job.lock);
+        job.pending++;
+        pthread_mutex_unlock(&job.lock);
+
+        if(parallel != NULL && parallel->executor != NULL)
+        {
+            parallel->executor(job_task, &job, parallel->executor_ctx);
+        }
+        else if(pool_submit(job_task, &job) == ERROR)
+        {
+            // The caller steals the work instead
+            pthread_mutex_lock(&job.lock);
+            job.pending--;
+            pthread_mutex_unlock(&job.lock);
+            break;
+        }
+    }
+
+    job_work(&job, 0);
+
+    // Tasks the pool has not started would find nothing left to do
+    if(parallel == NULL || parallel->executor == NULL)
+    {
+        size_t cancelled = pool_cancel(job_task, &job);
+
+        pthread_mutex_lock(&job.lock);
+        job.pending -= cancelled;
+        pthread_mutex_unlock(&job.lock);
+    }
+
+    pthread_mutex_lock(&job.lock);
+    while(job.pending > 0) pthread_cond_wait(&job.done, &job.lock);
+    pthread_mutex_unlock(&job.lock);
+
+    for(size_t worker = 0; worker < workers; worker++) pthread_mutex_destroy(&job.slices[worker].lock);
+
+    pthread_cond_destroy(&job.done);
+    pthread_mutex_destroy(&job.lock);
+    free(job.slices);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Runs fn(arg) on a pool thread without waiting for it
+ * 
+ * @param fn - function to run
+ * @param arg - passed to fn
+ * @return STATUS - ERROR if it could not be queued, fn has not run
+ */
+STATUS hashmap_pool_defer(hashmap_task_fn_t fn, void* arg)
+{
+    pool_task_t* task = (pool_task_t *)malloc(sizeof(pool_task_t));
+
+    if(task == NULL) return ERROR;
+
+    task->fn = fn;
+    task->arg = arg;
+
+    pthread_mutex_lock(&pool_lock);
+    deferred++;
+    pthread_mutex_unlock(&pool_lock);
+
+    if(pool_submit(deferred_task, task) == ERROR)
+    {
+        free(task);
+
+        pthread_mutex_lock(&pool_lock);
+        if(--deferred == 0) pthread_cond_broadcast(&pool_idle);
+        pthread_mutex_unlock(&pool_lock);
+
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Waits until every task passed to hashmap_pool_defer() has finished
+ * 
+ */
+void hashmap_pool_wait(void)
+{
+    pthread_mutex_lock(&pool_lock);
+    while(deferred > 0) pthread_cond_wait(&pool_idle, &pool_lock);
+    pthread_mutex_unlock(&pool_lock);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file hashmap_random.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Random seeds for new maps
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#if defined(__linux__)
+    #include <sys/random.h>
+#endif
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns 64 random bits for seeding a map
+ * @details Uses getrandom() where available, then /dev/urandom. If neither works the bits are mixed from the
+ * clock, a counter and an address, which still differs per map and per process but is not secret.
+ * 
+ * @return uint64_t 
+ */
+uint64_t hashmap_random_u64(void)
+{
+    static uint64_t counter = 0;
+    uint64_t bits = 0;
+    FILE* file = NULL;
+
+#if defined(__linux__)
+    if(getrandom(&bits, sizeof(bits), 0) == (ssize_t)sizeof(bits)) return bits;
+#endif
+
+    file = fopen("/dev/urandom", "rb");
+
+    if(file != NULL)
+    {
+        size_t read = fread(&bits, sizeof(bits), 1, file);
+
+        fclose(file);
+        if(read == 1) return bits;
+    }
+
+    bits = (uint64_t)time(NULL) ^ (uint64_t)clock() ^ (uint64_t)(uintptr_t)&bits;
+    return MurmurHash3_fmix64(bits + ++counter * 0x9e3779b97f4a7c15ULL);
+}
+
+//---------------------------------------------------------------------------------------------------------
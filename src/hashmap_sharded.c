@@ -0,0 +1,312 @@
+/**
+ * @file hashmap_sharded.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Hashmap split into independent hashmap_t shards, each behind its own lock
+ * @details A key goes to the shard picked by the high bits of a hash with the sharded map's own seed, so the
+ * low bits the shard uses to pick a bucket stay independent of the routing. Every shard is aligned to its own
+ * cache lines so writers on different shards never share a line.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hashmap_sharded.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#define CACHE_LINE 64           // Assumed cache line size
+#define MAX_SHARDS 65536        // Most shards a map can be split into
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct shard shard_t;
+
+// One independent part of the map
+struct shard
+{
+    _Alignas(CACHE_LINE) pthread_mutex_t lock;  // Held while the shard's map is used
+    hashmap_t* map;                             // Keys routed to this shard
+    atomic_size_t size;                         // Number of keys in map, readable without the lock
+};
+
+// The sharded hashmap structure. Obfuscated from the user
+struct hashmap_sharded
+{
+    size_t shard_count;     // Number of shards, a power of 2
+    unsigned shard_shift;   // 64 - log2(shard_count), shifts the hash down to a shard index
+    uint64_t seed;          // Seed for routing keys to shards
+    shard_t shards[];       // The shards
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the shard for key
+ * 
+ * @param map - pointer to the map
+ * @param key - the key
+ * @return shard_t*
+ */
+static inline shard_t* shard_for(hashmap_sharded_t* map, const char* key)
+{
+    uint64_t hash[2] = {0};
+
+    if(map->shard_count == 1) return &map->shards[0];
+
+    MurmurHash3_x64_128_seed64(key, (int)strlen(key), map->seed, hash);
+
+    return &map->shards[hash[0] >> map->shard_shift];
+}
+
+/**
+ * @brief Frees the shards that were created and the map
+ * 
+ * @param map - pointer to the map
+ * @param count - number of shards that were created
+ * @param fn - optional function for freeing the values
+ */
+static void shards_free(hashmap_sharded_t* map, size_t count, free_value_fn_t fn)
+{
+    for(size_t shard_idx = 0; shard_idx < count; shard_idx++)
+    {
+        hashmap_destroy(map->shards[shard_idx].map, fn);
+        pthread_mutex_destroy(&map->shards[shard_idx].lock);
+    }
+
+    free(map);
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the hashmap_sharded_t object and returns the handle
+ * 
+ * @param shard_count - number of shards, rounded up to a power of 2. 0 uses one per online CPU.
+ * @param shard_capacity - max number of unique indexes for each shard, as for hashmap_create()
+ * @return hashmap_sharded_t* - pointer to the hashmap_sharded_t object. NULL if error.
+ */
+hashmap_sharded_t* hashmap_sharded_create(size_t shard_count, size_t shard_capacity)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_sharded_t* map = NULL;
+    size_t count = 1;
+    unsigned shard_bits = 0;
+    size_t bytes = 0;
+
+    if(shard_count == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        shard_count = (cpus > 0) ? (size_t)cpus : 1;
+    }
+
+    if(shard_count > MAX_SHARDS)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    while(count < shard_count)
+    {
+        count *= 2;
+        shard_bits++;
+    }
+
+    // aligned_alloc() wants a multiple of the alignment
+    bytes = (sizeof(hashmap_sharded_t) + count * sizeof(shard_t) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    map = (hashmap_sharded_t *)aligned_alloc(CACHE_LINE, bytes);
+
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    map->shard_count = count;
+    map->shard_shift = 64 - shard_bits;
+    map->seed = hashmap_random_u64();
+
+    for(size_t shard_idx = 0; shard_idx < count; shard_idx++)
+    {
+        shard_t* shard = &map->shards[shard_idx];
+
+        // A plain malloc() could put the maps of neighbouring shards on one cache line
+        shard->map = hashmap_create_aligned(shard_capacity, NULL);
+
+        if(shard->map == NULL)
+        {
+            hashmap_err_t err = hashmap_errno();
+
+            shards_free(map, shard_idx, NULL);
+            hashmap_set_errno(err);
+            return NULL;
+        }
+
+        pthread_mutex_init(&shard->lock, NULL);
+        atomic_init(&shard->size, 0);
+    }
+
+    return map;
+}
+
+/**
+ * @brief Safely deallocates map. User can optionally provide a function for freeing values.
+ * @details No other thread may be using the map.
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional pointer to function for freeing values. Can pass NULL to not have library handle freeing values.
+ */
+void hashmap_sharded_destroy(hashmap_sharded_t* map, free_value_fn_t fn)
+{
+    if(map != NULL) shards_free(map, map->shard_count, fn);
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+}
+
+/**
+ * @brief Add a new key-value pair to the map
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS
+ */
+STATUS hashmap_sharded_push(hashmap_sharded_t* map, const char* key, void* value)
+{
+    if(map == NULL || key == NULL || value == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    shard_t* shard = shard_for(map, key);
+    STATUS status = ERROR;
+
+    pthread_mutex_lock(&shard->lock);
+    status = hashmap_push(shard->map, key, value);
+    if(status == SUCCESS) atomic_fetch_add_explicit(&shard->size, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&shard->lock);
+
+    return status;
+}
+
+/**
+ * @brief Returns the value for the given key
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_sharded_get(hashmap_sharded_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    shard_t* shard = shard_for(map, key);
+    void* value = NULL;
+
+    pthread_mutex_lock(&shard->lock);
+    value = hashmap_get(shard->map, key);
+    pthread_mutex_unlock(&shard->lock);
+
+    return value;
+}
+
+/**
+ * @brief Deletes a key-value pair from the map
+ * 
+ * @param map - pointer to the map
+ * @param key - key to be deleted
+ * @param fn - optional function for freeing the value. Can be left NULL if user plans to handle deallocation.
+ * @return STATUS
+ */
+STATUS hashmap_sharded_delete(hashmap_sharded_t* map, const char* key, free_value_fn_t fn)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    shard_t* shard = shard_for(map, key);
+    STATUS status = ERROR;
+
+    pthread_mutex_lock(&shard->lock);
+    status = hashmap_delete(shard->map, key, fn);
+    if(status == SUCCESS) atomic_fetch_sub_explicit(&shard->size, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&shard->lock);
+
+    return status;
+}
+
+/**
+ * @brief Returns the number of keys over all shards
+ * @details Takes no locks, so the total is approximate while other threads are writing
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_sharded_size(hashmap_sharded_t* map)
+{
+    size_t size = 0;
+
+    for(size_t shard_idx = 0; map != NULL && shard_idx < map->shard_count; shard_idx++)
+    {
+        size += atomic_load_explicit(&map->shards[shard_idx].size, memory_order_relaxed);
+    }
+
+    return size;
+}
+
+/**
+ * @brief Returns the number of shards of the map
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_sharded_shard_count(const hashmap_sharded_t* map)
+{
+    return (map != NULL) ? map->shard_count : 0;
+}
+
+/**
+ * @brief Calls fn on every key-value pair of every shard, for example to add up totals across shards
+ * @details Each shard is locked while fn runs over it, so every shard is seen in a consistent state and writers
+ * are only held up on the shard being visited. fn must not use the sharded map.
+ * 
+ * @param map - pointer to the map
+ * @param fn - function called with each key, its value and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS
+ */
+STATUS hashmap_sharded_foreach(hashmap_sharded_t* map, hashmap_foreach_fn_t fn, void* ctx)
+{
+    if(map == NULL || fn == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    for(size_t shard_idx = 0; shard_idx < map->shard_count; shard_idx++)
+    {
+        shard_t* shard = &map->shards[shard_idx];
+
+        pthread_mutex_lock(&shard->lock);
+        hashmap_foreach(shard->map, fn, ctx);
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return SUCCESS;
+}
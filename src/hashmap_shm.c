@@ -0,0 +1,798 @@
+/**
+ * @file hashmap_shm.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Hashmap living entirely in a POSIX shared memory segment so several processes use one copy of it.
+ * Buckets, records and key bytes refer to each other by offsets from the start of the segment, as every process
+ * maps it at a different address. Writers take a process-shared robust mutex, readers take no lock: records are
+ * immutable once linked and their bytes are never reused, so a reader walking a chain while it changes only ever
+ * sees whole records. The bytes of dead records come back by compacting the live ones into a fresh segment.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hashmap_shm.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#define SHM_MAGIC 0x68736d6170736d31ULL     // Set once the segment is ready
+#define SHM_VERSION 2                       // Layout of the segment, bumped when it changes
+#define SHM_ALIGN(n) (((n) + 7) & ~(uint64_t)7) // Records and values start on 8 byte boundaries
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct shm_header shm_header_t;
+typedef struct shm_record shm_record_t;
+
+// Start of the segment, followed by the bucket heads and then the records
+struct shm_header
+{
+    _Atomic uint64_t magic;     // SHM_MAGIC once the creator is done, opens fail before that
+    uint64_t version;           // SHM_VERSION of the creator
+    uint64_t header_bytes;      // sizeof(shm_header_t) of the creator
+    uint64_t bytes;             // Size of the segment
+    uint64_t seed;              // Seed for the hashes
+    uint64_t mask;              // Number of buckets - 1, the bucket count is a power of 2
+    uint64_t arena;             // Offset of the first record
+    _Atomic uint64_t used;      // Offset where the next record goes
+    _Atomic uint64_t size;      // Number of keys
+    _Atomic uint64_t retired;   // Set once hashmap_shm_compact() moved the pairs to a new segment, writers fail after that
+    pthread_mutex_t lock;       // Process-shared robust mutex held by writers
+    _Atomic uint64_t buckets[]; // Offset of the first record of each bucket, 0 if empty
+};
+
+// Key-value pair. Only next changes once the record is linked.
+struct shm_record
+{
+    _Atomic uint64_t next;  // Offset of the next record in the bucket, 0 ends the chain
+    uint64_t hash;          // Hash of the key
+    uint64_t key_len;       // Length of the key
+    uint64_t value_len;     // Length of the value
+    char data[];            // Key, NUL, padding to 8 bytes, value
+};
+
+// The shared memory hashmap handle, local to a process. Obfuscated from the user
+struct hashmap_shm
+{
+    shm_header_t* header;   // Start of the mapping, the offsets count from here
+    size_t bytes;           // Size of the mapping
+};
+
+/**
+ * @brief Hashes a key with the segment's seed
+ * 
+ * @param header - the segment
+ * @param key - key to hash
+ * @param len - length of the key
+ * @return uint64_t - the hash
+ */
+static inline uint64_t hash_key(const shm_header_t* header, const char* key, size_t len)
+{
+    uint64_t hash[2] = {0};
+
+    MurmurHash3_x64_128_seed64(key, (int)len, header->seed, hash);
+
+    return hash[0];
+}
+
+/**
+ * @brief Turns an offset into a record pointer in this process' mapping
+ * 
+ * @param header - the segment
+ * @param offset - offset of the record, not 0
+ * @return shm_record_t*
+ */
+static inline shm_record_t* record_at(const shm_header_t* header, uint64_t offset)
+{
+    return (shm_record_t *)((char *)header + offset);
+}
+
+/**
+ * @brief Returns a pointer to the value bytes of a record
+ * 
+ * @param record - the record
+ * @return char*
+ */
+static inline char* record_value(shm_record_t* record)
+{
+    return record->data + SHM_ALIGN(record->key_len + 1);
+}
+
+/**
+ * @brief Returns the bytes a record with these lengths takes in the segment
+ * 
+ * @param key_len - length of the key
+ * @param value_len - length of the value
+ * @return uint64_t
+ */
+static inline uint64_t record_bytes(uint64_t key_len, uint64_t value_len)
+{
+    return sizeof(shm_record_t) + SHM_ALIGN(key_len + 1) + SHM_ALIGN(value_len);
+}
+
+/**
+ * @brief Walks key's bucket for the record holding it
+ * @details Safe without the lock, the links are read with acquire so a record is whole before it is seen
+ * 
+ * @param header - the segment
+ * @param key - key to search for
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @param link - if not NULL, set to the link pointing at the record, or at the end of the chain if not found
+ * @return uint64_t - offset of the record, 0 if not found
+ */
+static uint64_t chain_find(shm_header_t* header, const char* key, size_t len, uint64_t hash, _Atomic uint64_t** link)
+{
+    _Atomic uint64_t* current = &header->buckets[hash & header->mask];
+    uint64_t offset = atomic_load_explicit(current, memory_order_acquire);
+
+    while(offset != 0)
+    {
+        shm_record_t* record = record_at(header, offset);
+
+        if(record->hash == hash && record->key_len == len && memcmp(record->data, key, len) == 0) break;
+
+        current = &record->next;
+        offset = atomic_load_explicit(current, memory_order_acquire);
+    }
+
+    if(link != NULL) *link = current;
+
+    return offset;
+}
+
+/**
+ * @brief Copies a pair into a new record at the end of the used bytes
+ * @details The record is not linked yet. Must be called with the lock held.
+ * 
+ * @param header - the segment
+ * @param key - key of the pair
+ * @param len - length of the key
+ * @param hash - hash of the key
+ * @param value - value bytes
+ * @param value_len - number of value bytes
+ * @return uint64_t - offset of the record, 0 if the segment is full
+ */
+static uint64_t record_create(shm_header_t* header, const char* key, size_t len, uint64_t hash, const void* value, size_t value_len)
+{
+    uint64_t used = atomic_load_explicit(&header->used, memory_order_relaxed);
+    uint64_t bytes = record_bytes(len, value_len);
+    shm_record_t* record = NULL;
+
+    if(bytes > header->bytes - used) return 0;
+
+    record = record_at(header, used);
+    atomic_init(&record->next, 0);
+    record->hash = hash;
+    record->key_len = len;
+    record->value_len = value_len;
+    memcpy(record->data, key, len);
+    record->data[len] = '\0';
+    if(value_len > 0) memcpy(record_value(record), value, value_len);
+
+    atomic_store_explicit(&header->used, used + bytes, memory_order_relaxed);
+
+    return used;
+}
+
+/**
+ * @brief Counts the keys again after a writer died holding the lock
+ * @details A writer only ever publishes whole records with one store, so the chains are valid and only the size
+ * can be off
+ * 
+ * @param header - the segment
+ */
+static void shm_recover(shm_header_t* header)
+{
+    uint64_t size = 0;
+
+    for(uint64_t bucket = 0; bucket <= header->mask; bucket++)
+    {
+        uint64_t offset = atomic_load_explicit(&header->buckets[bucket], memory_order_relaxed);
+
+        while(offset != 0)
+        {
+            size++;
+            offset = atomic_load_explicit(&record_at(header, offset)->next, memory_order_relaxed);
+        }
+    }
+
+    atomic_store_explicit(&header->size, size, memory_order_relaxed);
+}
+
+/**
+ * @brief Takes the writer lock, repairing the map if its last holder died
+ * 
+ * @param header - the segment
+ * @return STATUS - ERROR if the lock can't be taken
+ */
+static STATUS shm_lock(shm_header_t* header)
+{
+    int result = pthread_mutex_lock(&header->lock);
+
+    if(result == EOWNERDEAD)
+    {
+        shm_recover(header);
+        pthread_mutex_consistent(&header->lock);
+        result = 0;
+    }
+
+    return (result == 0) ? SUCCESS : ERROR;
+}
+
+/**
+ * @brief Takes the writer lock of a segment that has not been compacted away
+ * 
+ * @param header - the segment
+ * @return STATUS - ERROR with errno set if the lock can't be taken or the segment is retired
+ */
+static STATUS writer_lock(shm_header_t* header)
+{
+    if(shm_lock(header) == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_IO);
+        return ERROR;
+    }
+
+    if(atomic_load_explicit(&header->retired, memory_order_relaxed))
+    {
+        pthread_mutex_unlock(&header->lock);
+        hashmap_set_errno(HASHMAP_ERR_READ_ONLY);
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Maps a segment and wraps it in a handle
+ * 
+ * @param fd - descriptor of the segment
+ * @param bytes - size of the segment
+ * @return hashmap_shm_t* - NULL if error, with errno set
+ */
+static hashmap_shm_t* shm_map(int fd, size_t bytes)
+{
+    hashmap_shm_t* map = (hashmap_shm_t *)calloc(1, sizeof(hashmap_shm_t));
+    void* base = NULL;
+
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if(base == MAP_FAILED)
+    {
+        free(map);
+        hashmap_set_errno(HASHMAP_ERR_IO);
+        return NULL;
+    }
+
+    map->header = (shm_header_t *)base;
+    map->bytes = bytes;
+
+    return map;
+}
+
+/**
+ * @brief Pushes a pair, or replaces the value of an existing key when replace is set
+ * 
+ * @param map - pointer to the map
+ * @param key - key of the pair
+ * @param value - value bytes
+ * @param value_len - number of value bytes
+ * @param replace - replace the value of an existing key instead of failing
+ * @return STATUS
+ */
+static STATUS shm_store(hashmap_shm_t* map, const char* key, const void* value, size_t value_len, int replace)
+{
+    if(map == NULL || key == NULL || (value == NULL && value_len > 0))
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    shm_header_t* header = map->header;
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(header, key, len);
+    _Atomic uint64_t* link = NULL;
+    uint64_t found = 0;
+    uint64_t offset = 0;
+
+    if(writer_lock(header) == ERROR) return ERROR;
+
+    found = chain_find(header, key, len, hash, &link);
+
+    if(found != 0 && !replace)
+    {
+        pthread_mutex_unlock(&header->lock);
+        hashmap_set_errno(HASHMAP_ERR_DUPLICATE);
+        return ERROR;
+    }
+
+    offset = record_create(header, key, len, hash, value, value_len);
+
+    if(offset == 0)
+    {
+        pthread_mutex_unlock(&header->lock);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    if(found != 0)
+    {
+        // The new record takes the old one's place, readers on the old one still reach the rest of the chain
+        shm_record_t* old = record_at(header, found);
+
+        atomic_store_explicit(&record_at(header, offset)->next, atomic_load_explicit(&old->next, memory_order_relaxed), memory_order_relaxed);
+        atomic_store_explicit(link, offset, memory_order_release);
+    }
+    else
+    {
+        atomic_store_explicit(link, offset, memory_order_release);
+        atomic_fetch_add_explicit(&header->size, 1, memory_order_relaxed);
+    }
+
+    pthread_mutex_unlock(&header->lock);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Creates a segment named name holding an empty map, and maps it without publishing it
+ * @details hashmap_shm_open() fails on the segment until its magic is stored
+ * 
+ * @param name - name of the segment
+ * @param buckets - number of buckets, a power of 2
+ * @param bytes - size of the segment
+ * @param seed - seed for the hashes
+ * @return hashmap_shm_t* - NULL if error, with errno set
+ */
+static hashmap_shm_t* segment_create(const char* name, uint64_t buckets, size_t bytes, uint64_t seed)
+{
+    hashmap_shm_t* map = NULL;
+    shm_header_t* header = NULL;
+    pthread_mutexattr_t attr;
+    int fd = -1;
+
+    if(bytes < sizeof(shm_header_t) + buckets * sizeof(uint64_t))
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if(fd < 0)
+    {
+        hashmap_set_errno(errno == EEXIST ? HASHMAP_ERR_DUPLICATE : HASHMAP_ERR_IO);
+        return NULL;
+    }
+
+    // New pages of the segment read as zero, so every bucket starts empty
+    if(ftruncate(fd, (off_t)bytes) != 0)
+    {
+        close(fd);
+        shm_unlink(name);
+        hashmap_set_errno(HASHMAP_ERR_IO);
+        return NULL;
+    }
+
+    map = shm_map(fd, bytes);
+    close(fd);
+
+    if(map == NULL)
+    {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    header = map->header;
+    header->version = SHM_VERSION;
+    header->header_bytes = sizeof(shm_header_t);
+    header->bytes = bytes;
+    header->seed = seed;
+    header->mask = buckets - 1;
+    header->arena = SHM_ALIGN(sizeof(shm_header_t) + buckets * sizeof(uint64_t));
+    atomic_init(&header->used, header->arena);
+    atomic_init(&header->size, 0);
+    atomic_init(&header->retired, 0);
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+
+    if(pthread_mutex_init(&header->lock, &attr) != 0)
+    {
+        pthread_mutexattr_destroy(&attr);
+        hashmap_shm_close(map);
+        shm_unlink(name);
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    pthread_mutexattr_destroy(&attr);
+
+    return map;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates a shared memory segment named name holding an empty map, and maps it
+ * @details Fails if the name exists. Processes forked after this share the handle, others use hashmap_shm_open().
+ * The bucket count is fixed here. The bytes of deleted and replaced pairs are only reused by moving the map to a
+ * new segment with hashmap_shm_compact(), so size the segment for the pairs written between compactions.
+ * 
+ * @param name - name of the segment, as for shm_open(), e.g. "/my_map"
+ * @param capacity - number of buckets, rounded up to a power of 2
+ * @param bytes - size of the segment, holding the buckets and every pair
+ * @return hashmap_shm_t* - pointer to the hashmap_shm_t object. NULL if error.
+ */
+hashmap_shm_t* hashmap_shm_create(const char* name, size_t capacity, size_t bytes)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_shm_t* map = NULL;
+    size_t buckets = 1;
+
+    if(name == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    if(capacity < 1 || capacity > (SIZE_MAX >> 4))
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CAPACITY);
+        return NULL;
+    }
+
+    while(buckets < capacity) buckets <<= 1;
+
+    map = segment_create(name, buckets, bytes, hashmap_random_u64());
+    if(map != NULL) atomic_store_explicit(&map->header->magic, SHM_MAGIC, memory_order_release);
+
+    return map;
+}
+
+/**
+ * @brief Maps a segment made by hashmap_shm_create(), in this or another process
+ * 
+ * @param name - name of the segment
+ * @return hashmap_shm_t* - pointer to the hashmap_shm_t object. NULL if error, with HASHMAP_ERR_IO if it can't be
+ * opened and HASHMAP_ERR_INVALID_CONFIG if it isn't a ready map of this version.
+ */
+hashmap_shm_t* hashmap_shm_open(const char* name)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_shm_t* map = NULL;
+    struct stat info;
+    int fd = -1;
+
+    if(name == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    fd = shm_open(name, O_RDWR, 0);
+
+    if(fd < 0 || fstat(fd, &info) != 0)
+    {
+        if(fd >= 0) close(fd);
+        hashmap_set_errno(HASHMAP_ERR_IO);
+        return NULL;
+    }
+
+    if((size_t)info.st_size < sizeof(shm_header_t))
+    {
+        close(fd);
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    map = shm_map(fd, (size_t)info.st_size);
+    close(fd);
+
+    if(map == NULL) return NULL;
+
+    if(atomic_load_explicit(&map->header->magic, memory_order_acquire) != SHM_MAGIC || map->header->version != SHM_VERSION ||
+       map->header->header_bytes != sizeof(shm_header_t) || map->header->bytes != map->bytes)
+    {
+        hashmap_shm_close(map);
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    return map;
+}
+
+/**
+ * @brief Unmaps the segment and frees the handle. The map stays in the segment for the other processes.
+ * 
+ * @param map - pointer to the map
+ * @return STATUS
+ */
+STATUS hashmap_shm_close(hashmap_shm_t* map)
+{
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    munmap(map->header, map->bytes);
+    free(map);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Removes the name of a segment. Processes that have it mapped keep using it until they close it.
+ * 
+ * @param name - name of the segment
+ * @return STATUS - ERROR with HASHMAP_ERR_NOT_FOUND if there is no such segment
+ */
+STATUS hashmap_shm_unlink(const char* name)
+{
+    if(name == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(shm_unlink(name) != 0)
+    {
+        hashmap_set_errno(errno == ENOENT ? HASHMAP_ERR_NOT_FOUND : HASHMAP_ERR_IO);
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Copies a new pair into the segment
+ * @details Values are stored as bytes, pointers into one process' memory mean nothing to the others
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value bytes, may be NULL if len is 0
+ * @param len - number of value bytes
+ * @return STATUS - ERROR with HASHMAP_ERR_DUPLICATE if key exists, HASHMAP_ERR_ALLOC_FAILED if the segment is full,
+ * HASHMAP_ERR_READ_ONLY if it was compacted
+ */
+STATUS hashmap_shm_push(hashmap_shm_t* map, const char* key, const void* value, size_t len)
+{
+    return shm_store(map, key, value, len, 0);
+}
+
+/**
+ * @brief Copies a pair into the segment, replacing the value if key exists
+ * @details Readers holding the old value keep reading the old bytes, which are not reused
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value bytes, may be NULL if len is 0
+ * @param len - number of value bytes
+ * @return STATUS - ERROR with HASHMAP_ERR_ALLOC_FAILED if the segment is full, HASHMAP_ERR_READ_ONLY if it was compacted
+ */
+STATUS hashmap_shm_set(hashmap_shm_t* map, const char* key, const void* value, size_t len)
+{
+    return shm_store(map, key, value, len, 1);
+}
+
+/**
+ * @brief Returns the value of key in place, without locking or copying
+ * @details The bytes are 8 byte aligned and stay valid until this process closes the map, even if the key is
+ * deleted or replaced meanwhile
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @param len - if not NULL, set to the number of value bytes
+ * @return const void* - the value, NULL if not found
+ */
+const void* hashmap_shm_get(const hashmap_shm_t* map, const char* key, size_t* len)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t key_len = strlen(key);
+    uint64_t offset = chain_find(map->header, key, key_len, hash_key(map->header, key, key_len), NULL);
+    shm_record_t* record = NULL;
+
+    if(offset == 0)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return NULL;
+    }
+
+    record = record_at(map->header, offset);
+    if(len != NULL) *len = (size_t)record->value_len;
+
+    return record_value(record);
+}
+
+/**
+ * @brief Deletes a key from the map
+ * 
+ * @param map - pointer to the map
+ * @param key - key to delete
+ * @return STATUS - ERROR with HASHMAP_ERR_NOT_FOUND if key is not in the map, HASHMAP_ERR_READ_ONLY if the segment
+ * was compacted
+ */
+STATUS hashmap_shm_delete(hashmap_shm_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    shm_header_t* header = map->header;
+    size_t len = strlen(key);
+    uint64_t hash = hash_key(header, key, len);
+    _Atomic uint64_t* link = NULL;
+    uint64_t found = 0;
+    shm_record_t* record = NULL;
+
+    if(writer_lock(header) == ERROR) return ERROR;
+
+    found = chain_find(header, key, len, hash, &link);
+
+    if(found == 0)
+    {
+        pthread_mutex_unlock(&header->lock);
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return ERROR;
+    }
+
+    // The record keeps its next link, so readers standing on it still reach the rest of the chain
+    record = record_at(header, found);
+    atomic_store_explicit(link, atomic_load_explicit(&record->next, memory_order_relaxed), memory_order_release);
+    atomic_fetch_sub_explicit(&header->size, 1, memory_order_relaxed);
+
+    pthread_mutex_unlock(&header->lock);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Moves the live pairs of the map into a new segment named name, leaving the bytes of dead pairs behind
+ * @details Writers to the old segment, from any process, fail with HASHMAP_ERR_READ_ONLY from then on. Readers of it
+ * keep seeing the pairs as they were, and the values they hold stay valid until they close it. Processes switch by
+ * opening name, after which the old segment can be unlinked. On failure the old segment is left as it was.
+ * 
+ * @param map - pointer to the map
+ * @param name - name of the new segment, must not exist
+ * @param bytes - size of the new segment, 0 for the size of the old one
+ * @return hashmap_shm_t* - pointer to the new map. NULL if error, with HASHMAP_ERR_ALLOC_FAILED if the live pairs
+ * don't fit and HASHMAP_ERR_READ_ONLY if the map was already compacted.
+ */
+hashmap_shm_t* hashmap_shm_compact(hashmap_shm_t* map, const char* name, size_t bytes)
+{
+    if(map == NULL || name == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    shm_header_t* header = map->header;
+    hashmap_shm_t* fresh = NULL;
+    uint64_t size = 0;
+
+    if(writer_lock(header) == ERROR) return NULL;
+
+    // Same buckets and seed, so every record keeps its bucket and hash
+    fresh = segment_create(name, header->mask + 1, (bytes == 0) ? (size_t)header->bytes : bytes, header->seed);
+
+    if(fresh == NULL)
+    {
+        pthread_mutex_unlock(&header->lock);
+        return NULL;
+    }
+
+    for(uint64_t bucket = 0; bucket <= header->mask && fresh != NULL; bucket++)
+    {
+        uint64_t offset = atomic_load_explicit(&header->buckets[bucket], memory_order_relaxed);
+
+        while(offset != 0)
+        {
+            shm_record_t* record = record_at(header, offset);
+            uint64_t copy = record_create(fresh->header, record->data, record->key_len, record->hash, record_value(record), record->value_len);
+
+            if(copy == 0)
+            {
+                hashmap_shm_close(fresh);
+                shm_unlink(name);
+                fresh = NULL;
+                break;
+            }
+
+            // Nobody can open the new segment yet, its chains are published with the magic
+            atomic_store_explicit(&record_at(fresh->header, copy)->next, atomic_load_explicit(&fresh->header->buckets[bucket], memory_order_relaxed), memory_order_relaxed);
+            atomic_store_explicit(&fresh->header->buckets[bucket], copy, memory_order_relaxed);
+            size++;
+
+            offset = atomic_load_explicit(&record->next, memory_order_relaxed);
+        }
+    }
+
+    if(fresh == NULL)
+    {
+        pthread_mutex_unlock(&header->lock);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    atomic_store_explicit(&fresh->header->size, size, memory_order_relaxed);
+    atomic_store_explicit(&fresh->header->magic, SHM_MAGIC, memory_order_release);
+    atomic_store_explicit(&header->retired, 1, memory_order_relaxed);
+
+    pthread_mutex_unlock(&header->lock);
+
+    return fresh;
+}
+
+/**
+ * @brief Returns the number of keys in the map, over every process
+ * 
+ * @param map - pointer to the map
+ * @return size_t
+ */
+size_t hashmap_shm_size(const hashmap_shm_t* map)
+{
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return 0;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return (size_t)atomic_load_explicit(&map->header->size, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the bytes of the segment that new pairs can still use
+ * 
+ * @param map - pointer to the map
+ * @return size_t
+ */
+size_t hashmap_shm_free_bytes(const hashmap_shm_t* map)
+{
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return 0;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return (size_t)(map->header->bytes - atomic_load_explicit(&map->header->used, memory_order_relaxed));
+}
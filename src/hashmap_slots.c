@@ -0,0 +1,151 @@
+/**
+ * @file hashmap_slots.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Internal open addressed slot array shared by the integer keyed hashmap and the hashset. Owners probe it
+ * themselves, since only they know how to compare keys, and leave sizing and deletion to these functions.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "hashmap_slots.h"
+
+#define MIN_SLOTS 16    // Smallest slot array, must be a power of 2
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates a zeroed array of slot_count slots
+ * 
+ * @param table - pointer to the slot array
+ * @param slot_count - number of slots, a power of 2
+ * @return STATUS 
+ */
+static STATUS slots_alloc(hashmap_slots_t* table, size_t slot_count)
+{
+    if(hashmap_mem_alloc(&table->mem, slot_count, sizeof(hashmap_slot_t), NULL) != HASHMAP_ERR_NONE) return ERROR;
+
+    table->slots = (hashmap_slot_t *)table->mem.ptr;
+    table->mask = slot_count - 1;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Doubles the slot array and reinserts every slot at its home
+ * 
+ * @param table - pointer to the slot array
+ * @return STATUS - ERROR with the array untouched if the new one could not be allocated
+ */
+static STATUS grow(hashmap_slots_t* table)
+{
+    hashmap_slot_t* old_slots = table->slots;
+    size_t old_count = table->mask + 1;
+    hashmap_mem_t old_mem = table->mem;
+
+    if(slots_alloc(table, old_count * 2) == ERROR)
+    {
+        table->mem = old_mem;
+        table->slots = old_slots;
+        table->mask = old_count - 1;
+        return ERROR;
+    }
+
+    for(size_t i = 0; i < old_count; i++)
+    {
+        if(old_slots[i].ptr == NULL) continue;
+
+        size_t slot_idx = hashmap_slots_home(table, old_slots[i].word);
+
+        while(table->slots[slot_idx].ptr != NULL)
+        {
+            slot_idx = (slot_idx + 1) & table->mask;
+        }
+
+        table->slots[slot_idx] = old_slots[i];
+    }
+
+    hashmap_mem_free(&old_mem);
+
+    return SUCCESS;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Allocates an empty slot array for capacity slots
+ * 
+ * @param table - the slot array to initialize
+ * @param capacity - number of slots expected to be filled, at most HASHMAP_SLOTS_MAX_CAPACITY
+ * @param seed - seed of the owner's keys
+ * @param mix - 1 if words are raw keys to mix with seed, 0 if they are hashes
+ * @return STATUS 
+ */
+STATUS hashmap_slots_init(hashmap_slots_t* table, size_t capacity, uint64_t seed, int mix)
+{
+    size_t slot_count = MIN_SLOTS;
+
+    // Keep the load factor at or below 3/4
+    while(slot_count / 4 * 3 < capacity)
+    {
+        slot_count *= 2;
+    }
+
+    table->size = 0;
+    table->seed = seed;
+    table->mix = mix;
+
+    return slots_alloc(table, slot_count);
+}
+
+/**
+ * @brief Frees the slot array. What the slots point to is left to the owner.
+ * 
+ * @param table - pointer to the slot array
+ */
+void hashmap_slots_free(hashmap_slots_t* table)
+{
+    hashmap_mem_free(&table->mem);
+    table->slots = NULL;
+}
+
+/**
+ * @brief Grows the slot array if filling one more slot would pass the 3/4 load factor
+ * @details Call before probing for the slot to fill, since growing moves every slot
+ * 
+ * @param table - pointer to the slot array
+ * @return STATUS - ERROR if the array had to grow and could not
+ */
+STATUS hashmap_slots_reserve(hashmap_slots_t* table)
+{
+    if((table->size + 1) > (table->mask + 1) / 4 * 3) return grow(table);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Empties a full slot
+ * @details Uses backward shift deletion so probe sequences never need tombstones
+ * 
+ * @param table - pointer to the slot array
+ * @param hole - index of the slot to empty
+ */
+void hashmap_slots_erase(hashmap_slots_t* table, size_t hole)
+{
+    // Pull back every following slot whose home is not between the hole and its current index
+    for(size_t slot_idx = (hole + 1) & table->mask; table->slots[slot_idx].ptr != NULL; slot_idx = (slot_idx + 1) & table->mask)
+    {
+        size_t home = hashmap_slots_home(table, table->slots[slot_idx].word);
+
+        if(((slot_idx - home) & table->mask) >= ((slot_idx - hole) & table->mask))
+        {
+            table->slots[hole] = table->slots[slot_idx];
+            hole = slot_idx;
+        }
+    }
+
+    table->slots[hole].ptr = NULL;
+    table->size--;
+}
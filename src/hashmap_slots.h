@@ -0,0 +1,66 @@
+/**
+ * @file hashmap_slots.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Internal open addressed slot array, probed linearly, shared by the integer keyed hashmap and the hashset
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _C_HASH_MAP_SLOTS_H
+#define _C_HASH_MAP_SLOTS_H
+
+#include <stdint.h>
+
+#include "hashmap.h"
+#include "hashmap_alloc.h"
+#include "murmur3.h"
+
+#define HASHMAP_SLOTS_MAX_CAPACITY (SIZE_MAX / sizeof(hashmap_slot_t) / 4) // Keeps the doubled array size from overflowing
+
+/**
+ * @brief Slot of the array. A NULL ptr marks an empty slot.
+ * 
+ */
+typedef struct HASHMAP_SLOT
+{
+    uint64_t word;  // Integer key, or hash of a string key, that picks the home slot
+    void* ptr;      // Value or string key of the slot, NULL if empty
+}hashmap_slot_t;
+
+/**
+ * @brief Slot array kept at or below a 3/4 load factor, growing by doubling
+ * 
+ */
+typedef struct HASHMAP_SLOTS
+{
+    size_t mask;            // Number of slots - 1, the slot count is a power of 2
+    size_t size;            // Number of full slots
+    hashmap_slot_t* slots;  // The slot array
+    hashmap_mem_t mem;      // How the slot array was allocated
+    uint64_t seed;          // Seed of the owner's keys
+    int mix;                // 1 if word is a raw key mixed with seed to find its home, 0 if it already is a hash
+}hashmap_slots_t;
+
+/**
+ * @brief Returns the home slot of a word
+ * 
+ * @param table - pointer to the slot array
+ * @param word - word of the slot
+ * @return size_t - index of the first slot to probe
+ */
+static inline size_t hashmap_slots_home(const hashmap_slots_t* table, uint64_t word)
+{
+    uint64_t hash = table->mix ? MurmurHash3_fmix64(word ^ table->seed) : word;
+
+    return (size_t)hash & table->mask;
+}
+
+STATUS hashmap_slots_init(hashmap_slots_t* table, size_t capacity, uint64_t seed, int mix);
+void hashmap_slots_free(hashmap_slots_t* table);
+STATUS hashmap_slots_reserve(hashmap_slots_t* table);
+void hashmap_slots_erase(hashmap_slots_t* table, size_t hole);
+
+#endif
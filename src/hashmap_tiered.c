@@ -0,0 +1,1114 @@
+/**
+ * @file hashmap_tiered.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Hashmap that keeps its recently used pairs in memory and spills the rest to an append-only file
+ * @details Hot pairs live in a hashmap_t and are aged by a CLOCK sweep. Once there are more than hot_limit of them,
+ * the sweep appends the least recently used ones to the file and forgets them, keeping only a hashmap_u64_t from
+ * the key's hash to the record's offset and length. Reading a cold pair brings it back into memory. Asynchronous
+ * reads go into an io_uring submission queue, set up with raw system calls, and are only submitted by
+ * hashmap_tiered_poll(), so a single thread can keep a whole batch of reads in flight. Without io_uring the same
+ * calls fall back to pread().
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hashmap_tiered.h"
+#include "hashmap_u64.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #define HASHMAP_IO_URING 1
+    #endif
+#endif
+
+#ifndef HASHMAP_IO_URING
+    #define HASHMAP_IO_URING 0
+#endif
+
+#if HASHMAP_IO_URING
+    #include <errno.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+#define TIERED_DEFAULT_DEPTH 256    // Reads in flight when queue_depth is 0
+#define TIERED_HEADER_BYTES 8       // Key length and value length in front of every record
+#define TIERED_CLOCK_INITIAL 64     // Entries of the CLOCK ring before it first grows
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct hot hot_t;
+typedef struct cold cold_t;
+typedef struct request request_t;
+typedef struct uring uring_t;
+
+// Pair held in memory
+struct hot
+{
+    void* value;        // The value
+    int referenced;     // Set when the pair is used, cleared as the CLOCK hand passes
+    int dead;           // Set once the pair is deleted, the CLOCK ring frees it when it comes round or is compacted
+    char key[];         // The key
+};
+
+// Where a spilled pair's record is in the file
+struct cold
+{
+    uint64_t offset;    // Offset of the record
+    uint32_t len;       // Length of the whole record
+};
+
+// Asynchronous read of a cold pair
+struct request
+{
+    char* key;                  // Key looked up, NULL while the slot is free
+    hashmap_tiered_fn_t fn;     // Called with the value
+    void* ctx;                  // Passed through to fn
+    uint64_t hash;              // Hash of the key
+    uint64_t offset;            // Offset of the record when the read was queued
+    uint32_t len;               // Length of the record
+    char* buf;                  // Receives the record
+};
+
+// Mappings of an io_uring instance, fd is -1 when reads fall back to pread()
+struct uring
+{
+    int fd;                     // io_uring file descriptor
+#if HASHMAP_IO_URING
+    unsigned* sq_tail;          // Submission queue tail, written by us
+    unsigned* sq_mask;          // Submission queue index mask
+    unsigned* sq_array;         // Submission queue indexes into sqes
+    unsigned* cq_head;          // Completion queue head, written by us
+    unsigned* cq_tail;          // Completion queue tail, written by the kernel
+    unsigned* cq_mask;          // Completion queue index mask
+    struct io_uring_sqe* sqes;  // Submission queue entries
+    struct io_uring_cqe* cqes;  // Completion queue entries
+    void* sq_ring;              // Mapping of the submission ring
+    size_t sq_ring_size;        // Size of sq_ring
+    void* cq_ring;              // Mapping of the completion ring, may be sq_ring
+    size_t cq_ring_size;        // Size of cq_ring
+    size_t sqes_size;           // Size of the sqes mapping
+#endif
+    unsigned queued;            // Entries queued but not yet submitted
+};
+
+// The tiered hashmap structure. Obfuscated from the user
+struct hashmap_tiered
+{
+    hashmap_t* hot;             // Key to hot_t of the pairs in memory
+    hashmap_u64_t* cold;        // Key hash to cold_t of the pairs on disk
+    hashmap_tiered_config_t config;     // Options given to hashmap_tiered_create()
+    uint64_t seed;              // Seed of the key hashes
+    char* path;                 // Path of the file
+    int fd;                     // The file
+    uint64_t file_end;          // Offset the next record is written at
+    size_t hot_size;            // Number of live pairs in memory
+    hot_t** clock;              // CLOCK ring of the pairs in memory, oldest at clock_head
+    size_t clock_head;          // Index of the oldest entry of the ring
+    size_t clock_count;         // Number of entries in the ring, dead ones included
+    size_t clock_dead;          // Number of dead entries in the ring
+    size_t clock_space;         // Number of entries the ring has room for
+    char* scratch;              // Buffer for records written and read synchronously
+    size_t scratch_space;       // Number of bytes scratch has room for
+    request_t* requests;        // Asynchronous read slots
+    size_t* free_slots;         // Indexes of the free slots
+    size_t free_count;          // Number of entries in free_slots
+    size_t depth;               // Number of slots
+    uring_t ring;               // io_uring used for the reads
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hashes a key for the cold index
+ * 
+ * @param map - pointer to the map
+ * @param key - the key
+ * @return uint64_t - the hash
+ */
+static inline uint64_t hash_key(const hashmap_tiered_t* map, const char* key)
+{
+    uint64_t hash[2] = {0};
+
+    MurmurHash3_x64_128_seed64(key, (int)strlen(key), map->seed, hash);
+
+    return hash[0];
+}
+
+/**
+ * @brief Makes sure the scratch buffer holds at least size bytes
+ * 
+ * @param map - pointer to the map
+ * @param size - bytes needed
+ * @return STATUS - ERROR if it could not grow
+ */
+static STATUS scratch_reserve(hashmap_tiered_t* map, size_t size)
+{
+    if(size <= map->scratch_space) return SUCCESS;
+
+    char* scratch = (char *)realloc(map->scratch, size);
+    if(scratch == NULL) return ERROR;
+
+    map->scratch = scratch;
+    map->scratch_space = size;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Finds the value bytes in a record, checking that it is the record of key
+ * 
+ * @param record - the record
+ * @param len - length of the record
+ * @param key - key expected
+ * @param bytes - set to the value bytes
+ * @param value_len - set to the number of value bytes
+ * @return int - 1 if the record holds key, 0 otherwise
+ */
+static int record_value(const char* record, size_t len, const char* key, const char** bytes, uint32_t* value_len)
+{
+    uint32_t key_len = 0;
+
+    if(len < TIERED_HEADER_BYTES) return 0;
+
+    memcpy(&key_len, record, sizeof(key_len));
+    memcpy(value_len, record + 4, sizeof(*value_len));
+
+    if((uint64_t)TIERED_HEADER_BYTES + key_len + *value_len != len) return 0;
+    if(strlen(key) != key_len || memcmp(record + TIERED_HEADER_BYTES, key, key_len) != 0) return 0;
+
+    *bytes = record + TIERED_HEADER_BYTES + key_len;
+
+    return 1;
+}
+
+/**
+ * @brief Reads the record at loc into the scratch buffer
+ * 
+ * @param map - pointer to the map
+ * @param loc - where the record is
+ * @return const char* - the record, NULL if it could not be read
+ */
+static const char* cold_read(hashmap_tiered_t* map, const cold_t* loc)
+{
+    size_t done = 0;
+
+    if(scratch_reserve(map, loc->len) == ERROR) return NULL;
+
+    while(done < loc->len)
+    {
+        ssize_t got = pread(map->fd, map->scratch + done, loc->len - done, (off_t)(loc->offset + done));
+
+        if(got <= 0) return NULL;
+        done += (size_t)got;
+    }
+
+    return map->scratch;
+}
+
+/**
+ * @brief Returns the location of key's record if key is on disk
+ * 
+ * @param map - pointer to the map
+ * @param key - the key
+ * @param hash - hash of the key
+ * @param bytes - optional, set to the value bytes in the scratch buffer
+ * @param value_len - optional, set to the number of value bytes
+ * @return cold_t* - NULL if key is not on disk or its record could not be read
+ */
+static cold_t* cold_find(hashmap_tiered_t* map, const char* key, uint64_t hash, const char** bytes, uint32_t* value_len)
+{
+    cold_t* loc = (cold_t *)hashmap_u64_get(map->cold, hash);
+    const char* record = NULL;
+    const char* found_bytes = NULL;
+    uint32_t found_len = 0;
+
+    if(loc == NULL) return NULL;
+
+    // Another key may share the hash, only the record tells
+    record = cold_read(map, loc);
+    if(record == NULL || !record_value(record, loc->len, key, &found_bytes, &found_len)) return NULL;
+
+    if(bytes != NULL) *bytes = found_bytes;
+    if(value_len != NULL) *value_len = found_len;
+
+    return loc;
+}
+
+/**
+ * @brief Appends a pair to the CLOCK ring, growing it if needed
+ * 
+ * @param map - pointer to the map
+ * @param entry - the pair
+ * @return STATUS - ERROR if the ring could not grow
+ */
+static STATUS clock_push(hashmap_tiered_t* map, hot_t* entry)
+{
+    if(map->clock_count == map->clock_space)
+    {
+        size_t space = (map->clock_space == 0) ? TIERED_CLOCK_INITIAL : map->clock_space * 2;
+        hot_t** clock = (hot_t **)malloc(space * sizeof(hot_t *));
+
+        if(clock == NULL) return ERROR;
+
+        // Unwrap the ring so the oldest entry is first again
+        for(size_t i = 0; i < map->clock_count; i++)
+        {
+            clock[i] = map->clock[(map->clock_head + i) % map->clock_space];
+        }
+
+        free(map->clock);
+        map->clock = clock;
+        map->clock_space = space;
+        map->clock_head = 0;
+    }
+
+    map->clock[(map->clock_head + map->clock_count) % map->clock_space] = entry;
+    map->clock_count++;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Takes the oldest entry off the CLOCK ring
+ * 
+ * @param map - pointer to the map, with a non-empty ring
+ * @return hot_t*
+ */
+static hot_t* clock_pop(hashmap_tiered_t* map)
+{
+    hot_t* entry = map->clock[map->clock_head];
+
+    map->clock_head = (map->clock_head + 1) % map->clock_space;
+    map->clock_count--;
+
+    return entry;
+}
+
+/**
+ * @brief Frees the dead entries of the CLOCK ring, keeping the live ones in their order
+ * @details Done once dead entries outnumber live ones, so each delete pays O(1) amortized however rarely the
+ * hand moves
+ * 
+ * @param map - pointer to the map
+ */
+static void clock_compact(hashmap_tiered_t* map)
+{
+    size_t kept = 0;
+
+    // An entry only ever moves towards the head, so the ring can be compacted in place
+    for(size_t i = 0; i < map->clock_count; i++)
+    {
+        hot_t* entry = map->clock[(map->clock_head + i) % map->clock_space];
+
+        if(entry->dead) free(entry);
+        else map->clock[(map->clock_head + kept++) % map->clock_space] = entry;
+    }
+
+    map->clock_count = kept;
+    map->clock_dead = 0;
+}
+
+/**
+ * @brief Adds a pair to memory
+ * 
+ * @param map - pointer to the map
+ * @param key - the key, not in memory yet
+ * @param value - the value
+ * @return STATUS - ERROR if memory could not be allocated
+ */
+static STATUS hot_insert(hashmap_tiered_t* map, const char* key, void* value)
+{
+    size_t key_len = strlen(key);
+    hot_t* entry = (hot_t *)malloc(sizeof(hot_t) + key_len + 1);
+
+    if(entry == NULL) return ERROR;
+
+    entry->value = value;
+    entry->referenced = 1;
+    entry->dead = 0;
+    memcpy(entry->key, key, key_len + 1);
+
+    // The hot map borrows the entry's copy of the key
+    if(hashmap_push(map->hot, entry->key, entry) == ERROR)
+    {
+        free(entry);
+        return ERROR;
+    }
+
+    if(clock_push(map, entry) == ERROR)
+    {
+        hashmap_delete(map->hot, entry->key, NULL);
+        free(entry);
+        return ERROR;
+    }
+
+    map->hot_size++;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Writes a pair to the end of the file and drops it from memory
+ * 
+ * @param map - pointer to the map
+ * @param entry - the pair, already taken off the CLOCK ring
+ * @return STATUS - ERROR if it has to stay in memory
+ */
+static STATUS hot_spill(hashmap_tiered_t* map, hot_t* entry)
+{
+    uint64_t hash = hash_key(map, entry->key);
+    uint32_t key_len = (uint32_t)strlen(entry->key);
+    uint32_t value_len = 0;
+    size_t space = 0;
+    size_t needed = 0;
+    size_t done = 0;
+    cold_t* loc = NULL;
+
+    // The index holds one record per hash, so a key sharing the hash of one on disk stays in memory
+    if(hashmap_u64_get(map->cold, hash) != NULL) return ERROR;
+    if(scratch_reserve(map, TIERED_HEADER_BYTES + key_len) == ERROR) return ERROR;
+
+    space = map->scratch_space - TIERED_HEADER_BYTES - key_len;
+    needed = map->config.encode(entry->value, map->scratch + TIERED_HEADER_BYTES + key_len, space);
+
+    if(needed > UINT32_MAX - TIERED_HEADER_BYTES - key_len) return ERROR;
+
+    if(needed > space)
+    {
+        if(scratch_reserve(map, TIERED_HEADER_BYTES + key_len + needed) == ERROR) return ERROR;
+        map->config.encode(entry->value, map->scratch + TIERED_HEADER_BYTES + key_len, needed);
+    }
+
+    value_len = (uint32_t)needed;
+    memcpy(map->scratch, &key_len, sizeof(key_len));
+    memcpy(map->scratch + 4, &value_len, sizeof(value_len));
+    memcpy(map->scratch + TIERED_HEADER_BYTES, entry->key, key_len);
+
+    loc = (cold_t *)malloc(sizeof(cold_t));
+    if(loc == NULL) return ERROR;
+
+    loc->offset = map->file_end;
+    loc->len = TIERED_HEADER_BYTES + key_len + value_len;
+
+    while(done < loc->len)
+    {
+        ssize_t written = pwrite(map->fd, map->scratch + done, loc->len - done, (off_t)(loc->offset + done));
+
+        if(written < 0)
+        {
+            free(loc);
+            return ERROR;
+        }
+
+        done += (size_t)written;
+    }
+
+    if(hashmap_u64_push(map->cold, hash, loc) == ERROR)
+    {
+        free(loc);
+        return ERROR;
+    }
+
+    map->file_end += loc->len;
+    hashmap_delete(map->hot, entry->key, NULL);
+    if(map->config.free_value != NULL) map->config.free_value(entry->value);
+    free(entry);
+    map->hot_size--;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Sweeps the CLOCK hand until no more than hot_limit pairs are in memory
+ * @details Pairs used since the hand last passed get another round, the first one that wasn't is spilled. A pair
+ * that can't be spilled is passed over, and the sweep gives up once every pair on the ring was.
+ * 
+ * @param map - pointer to the map
+ */
+static void hot_evict(hashmap_tiered_t* map)
+{
+    size_t failed = 0;
+
+    while(map->hot_size > map->config.hot_limit && map->clock_count > 0 && failed < map->clock_count)
+    {
+        hot_t* entry = clock_pop(map);
+
+        if(entry->dead)
+        {
+            map->clock_dead--;
+            free(entry);
+            continue;
+        }
+
+        if(entry->referenced)
+        {
+            entry->referenced = 0;
+            clock_push(map, entry);
+            continue;
+        }
+
+        // Stays in memory, the pair is retried when the hand comes round again
+        if(hot_spill(map, entry) == ERROR)
+        {
+            clock_push(map, entry);
+            failed++;
+        }
+    }
+}
+
+/**
+ * @brief Brings a cold pair back into memory
+ * 
+ * @param map - pointer to the map
+ * @param key - the key
+ * @param hash - hash of the key
+ * @param bytes - value bytes of its record
+ * @param value_len - number of value bytes
+ * @return void* - the value, NULL if it could not be decoded or stored
+ */
+static void* cold_take(hashmap_tiered_t* map, const char* key, uint64_t hash, const char* bytes, uint32_t value_len)
+{
+    void* value = map->config.decode(bytes, value_len);
+
+    if(value == NULL || hot_insert(map, key, value) == ERROR)
+    {
+        if(value != NULL && map->config.free_value != NULL) map->config.free_value(value);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    // The record stays in the file as garbage
+    hashmap_u64_delete(map->cold, hash, free);
+    hot_evict(map);
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return value;
+}
+
+/**
+ * @brief Delivers the value of a finished read and frees its slot
+ * 
+ * @param map - pointer to the map
+ * @param slot - index of the request
+ * @param result - number of bytes read, negative on error
+ */
+static void request_complete(hashmap_tiered_t* map, size_t slot, long result)
+{
+    request_t* request = &map->requests[slot];
+    request_t done = *request;
+    const cold_t* loc = (const cold_t *)hashmap_u64_get(map->cold, done.hash);
+    const char* bytes = NULL;
+    uint32_t value_len = 0;
+    void* value = NULL;
+
+    // Free the slot first, fn may queue more reads
+    request->key = NULL;
+    request->buf = NULL;
+    map->free_slots[map->free_count++] = slot;
+
+    if(loc != NULL && loc->offset == done.offset && result == (long)done.len &&
+       record_value(done.buf, done.len, done.key, &bytes, &value_len))
+    {
+        value = cold_take(map, done.key, done.hash, bytes, value_len);
+    }
+    else
+    {
+        // The pair was deleted, brought back or read short while the read was in flight
+        value = hashmap_tiered_get(map, done.key);
+    }
+
+    done.fn(done.key, value, done.ctx);
+    free(done.buf);
+    free(done.key);
+}
+
+#if HASHMAP_IO_URING
+
+/**
+ * @brief Sets up an io_uring instance and maps its rings
+ * 
+ * @param ring - set up on success, fd is -1 on failure
+ * @param entries - submission queue entries wanted
+ * @return STATUS - ERROR if io_uring is unavailable
+ */
+static STATUS uring_setup(uring_t* ring, unsigned entries)
+{
+    struct io_uring_params params;
+
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if(ring->fd < 0) return ERROR;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Newer kernels map both rings with one call
+    if(params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if(ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = ring->sq_ring;
+
+    if(ring->sq_ring != MAP_FAILED && !(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    }
+
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+    if(ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED)
+    {
+        if(ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+        if(ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+        if(ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+        close(ring->fd);
+        ring->fd = -1;
+        return ERROR;
+    }
+
+    ring->sq_tail = (unsigned *)((char *)ring->sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)((char *)ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)((char *)ring->sq_ring + params.sq_off.array);
+    ring->cq_head = (unsigned *)((char *)ring->cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned *)((char *)ring->cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)((char *)ring->cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)((char *)ring->cq_ring + params.cq_off.cqes);
+    ring->queued = 0;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Unmaps the rings and closes the io_uring instance
+ * 
+ * @param ring - the ring
+ */
+static void uring_teardown(uring_t* ring)
+{
+    if(ring->fd < 0) return;
+
+    munmap(ring->sqes, ring->sqes_size);
+    if(ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+/**
+ * @brief Queues the read of a request without submitting it
+ * 
+ * @param map - pointer to the map
+ * @param slot - index of the request
+ */
+static void uring_queue(hashmap_tiered_t* map, size_t slot)
+{
+    uring_t* ring = &map->ring;
+    const request_t* request = &map->requests[slot];
+    unsigned tail = *ring->sq_tail;
+    unsigned idx = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[idx];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = map->fd;
+    sqe->addr = (uint64_t)(uintptr_t)request->buf;
+    sqe->len = request->len;
+    sqe->off = request->offset;
+    sqe->user_data = slot;
+    ring->sq_array[idx] = idx;
+
+    // The kernel must see the entry before the new tail
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+}
+
+/**
+ * @brief Submits the queued reads and completes the finished ones
+ * 
+ * @param map - pointer to the map
+ * @param min_complete - completions to wait for
+ * @return size_t - number of reads completed
+ */
+static size_t uring_poll(hashmap_tiered_t* map, size_t min_complete)
+{
+    uring_t* ring = &map->ring;
+    size_t completed = 0;
+    unsigned flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+
+    if(ring->queued > 0 || min_complete > 0)
+    {
+        long submitted = 0;
+
+        do
+        {
+            submitted = syscall(__NR_io_uring_enter, ring->fd, ring->queued, (unsigned)min_complete, flags, NULL, 0);
+        } while(submitted < 0 && errno == EINTR);
+
+        if(submitted > 0) ring->queued -= (unsigned)submitted;
+    }
+
+    for(;;)
+    {
+        unsigned head = *ring->cq_head;
+        struct io_uring_cqe cqe;
+
+        if(head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) break;
+
+        cqe = ring->cqes[head & *ring->cq_mask];
+
+        // Hand the entry back before fn runs, it may queue and poll again
+        __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+        request_complete(map, (size_t)cqe.user_data, cqe.res);
+        completed++;
+    }
+
+    return completed;
+}
+
+#endif
+
+/**
+ * @brief Completes every queued read with pread(), for when io_uring is unavailable
+ * 
+ * @param map - pointer to the map
+ * @return size_t - number of reads completed
+ */
+static size_t pread_poll(hashmap_tiered_t* map)
+{
+    size_t completed = 0;
+
+    for(size_t slot = 0; slot < map->depth; slot++)
+    {
+        request_t* request = &map->requests[slot];
+        long result = 0;
+
+        if(request->key == NULL) continue;
+
+        result = (long)pread(map->fd, request->buf, request->len, (off_t)request->offset);
+        request_complete(map, slot, result);
+        completed++;
+    }
+
+    return completed;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the hashmap_tiered_t object and returns the handle
+ * @details path is created, or truncated, as the file cold pairs are written to, and removed by
+ * hashmap_tiered_destroy(). The map is not thread safe, like hashmap_t.
+ * 
+ * @param path - file for the cold pairs
+ * @param capacity - max number of unique indexes for the in-memory map, as for hashmap_create()
+ * @param config - hot_limit of at least 1 and the functions that turn values into bytes and back
+ * @return hashmap_tiered_t* - pointer to the hashmap_tiered_t object. NULL if error.
+ */
+hashmap_tiered_t* hashmap_tiered_create(const char* path, size_t capacity, const hashmap_tiered_config_t* config)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_config_t hot_config = { HASHMAP_FLAG_BORROW_KEYS, 0, NULL };
+    hashmap_tiered_t* map = NULL;
+
+    if(path == NULL || config == NULL || config->encode == NULL || config->decode == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    if(config->hot_limit == 0)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    map = (hashmap_tiered_t *)calloc(1, sizeof(hashmap_tiered_t));
+
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    map->config = *config;
+    map->depth = (config->queue_depth > 0) ? config->queue_depth : TIERED_DEFAULT_DEPTH;
+    map->seed = hashmap_random_u64();
+    map->fd = -1;
+    map->ring.fd = -1;
+    map->hot = hashmap_create_ex(capacity, &hot_config);
+    map->cold = hashmap_u64_create(capacity);
+    map->path = strdup(path);
+    map->requests = (request_t *)calloc(map->depth, sizeof(request_t));
+    map->free_slots = (size_t *)malloc(map->depth * sizeof(size_t));
+
+    if(map->hot == NULL || map->cold == NULL || map->path == NULL || map->requests == NULL || map->free_slots == NULL)
+    {
+        hashmap_err_t err = (map->hot == NULL) ? hashmap_errno() : HASHMAP_ERR_ALLOC_FAILED;
+
+        hashmap_tiered_destroy(map);
+        hashmap_set_errno(err);
+        return NULL;
+    }
+
+    for(size_t slot = 0; slot < map->depth; slot++) map->free_slots[map->free_count++] = map->depth - 1 - slot;
+
+    map->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+    if(map->fd < 0)
+    {
+        hashmap_tiered_destroy(map);
+        hashmap_set_errno(HASHMAP_ERR_IO);
+        return NULL;
+    }
+
+#if HASHMAP_IO_URING
+    // Kernels or sandboxes without io_uring get pread() instead
+    uring_setup(&map->ring, (unsigned)map->depth);
+#endif
+
+    return map;
+}
+
+/**
+ * @brief Safely deallocates map and removes its file
+ * @details Reads still in flight are waited for, their functions are not called. Values in memory are freed
+ * with the configured free function.
+ * 
+ * @param map - pointer to the map
+ */
+void hashmap_tiered_destroy(hashmap_tiered_t* map)
+{
+    if(map == NULL) return;
+
+#if HASHMAP_IO_URING
+    // The kernel may still be writing to the request buffers
+    for(size_t in_flight = hashmap_tiered_pending(map); map->ring.fd >= 0 && in_flight > 0; in_flight = hashmap_tiered_pending(map))
+    {
+        struct io_uring_cqe cqe;
+        unsigned head = *map->ring.cq_head;
+
+        if(head == __atomic_load_n(map->ring.cq_tail, __ATOMIC_ACQUIRE))
+        {
+            syscall(__NR_io_uring_enter, map->ring.fd, map->ring.queued, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+            map->ring.queued = 0;
+            continue;
+        }
+
+        cqe = map->ring.cqes[head & *map->ring.cq_mask];
+        __atomic_store_n(map->ring.cq_head, head + 1, __ATOMIC_RELEASE);
+        free(map->requests[cqe.user_data].key);
+        free(map->requests[cqe.user_data].buf);
+        map->requests[cqe.user_data].key = NULL;
+        map->requests[cqe.user_data].buf = NULL;
+        map->free_slots[map->free_count++] = (size_t)cqe.user_data;
+    }
+
+    uring_teardown(&map->ring);
+#endif
+
+    for(size_t slot = 0; map->requests != NULL && slot < map->depth; slot++)
+    {
+        free(map->requests[slot].key);
+        free(map->requests[slot].buf);
+    }
+
+    // Every pair in memory, and every deleted one not yet freed, is on the CLOCK ring
+    while(map->clock_count > 0)
+    {
+        hot_t* entry = clock_pop(map);
+
+        if(!entry->dead && map->config.free_value != NULL) map->config.free_value(entry->value);
+        free(entry);
+    }
+
+    if(map->fd >= 0)
+    {
+        close(map->fd);
+        unlink(map->path);
+    }
+
+    hashmap_destroy(map->hot, NULL);
+    hashmap_u64_destroy(map->cold, free);
+    free(map->clock);
+    free(map->scratch);
+    free(map->requests);
+    free(map->free_slots);
+    free(map->path);
+    free(map);
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+}
+
+/**
+ * @brief Add a new key-value pair to the map
+ * @details The pair starts out in memory. Pushing may write the least recently used pairs to disk.
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS
+ */
+STATUS hashmap_tiered_push(hashmap_tiered_t* map, const char* key, void* value)
+{
+    if(map == NULL || key == NULL || value == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    if(hashmap_get(map->hot, key) != NULL || cold_find(map, key, hash_key(map, key), NULL, NULL) != NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_DUPLICATE);
+        return ERROR;
+    }
+
+    if(hot_insert(map, key, value) == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    hot_evict(map);
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the value for the given key, reading it from disk if needed
+ * @details A pair read from disk is kept in memory again. The value stays valid until the pair is deleted or
+ * written back to disk by a later call.
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_tiered_get(hashmap_tiered_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    hot_t* entry = (hot_t *)hashmap_get(map->hot, key);
+    uint64_t hash = 0;
+    const char* bytes = NULL;
+    uint32_t value_len = 0;
+
+    if(entry != NULL)
+    {
+        entry->referenced = 1;
+        return entry->value;
+    }
+
+    hash = hash_key(map, key);
+
+    if(cold_find(map, key, hash, &bytes, &value_len) == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return NULL;
+    }
+
+    return cold_take(map, key, hash, bytes, value_len);
+}
+
+/**
+ * @brief Looks up a key without waiting for the disk
+ * @details If the pair is in memory, or the key is not in the map, fn is called before this returns. Otherwise
+ * the read is queued and fn is called by the hashmap_tiered_poll() call that completes it, with the value as
+ * hashmap_tiered_get() would return it. When every read slot is busy, this polls for one first.
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @param fn - called with the key, its value or NULL, and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS - ERROR if the read could not be queued
+ */
+STATUS hashmap_tiered_get_async(hashmap_tiered_t* map, const char* key, hashmap_tiered_fn_t fn, void* ctx)
+{
+    if(map == NULL || key == NULL || fn == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hot_t* entry = (hot_t *)hashmap_get(map->hot, key);
+    uint64_t hash = 0;
+    const cold_t* loc = NULL;
+    request_t* request = NULL;
+    size_t slot = 0;
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(entry != NULL)
+    {
+        entry->referenced = 1;
+        fn(key, entry->value, ctx);
+        return SUCCESS;
+    }
+
+    hash = hash_key(map, key);
+    loc = (const cold_t *)hashmap_u64_get(map->cold, hash);
+
+    if(loc == NULL)
+    {
+        fn(key, NULL, ctx);
+        return SUCCESS;
+    }
+
+    while(map->free_count == 0) hashmap_tiered_poll(map, 1);
+
+    // Polling may have brought the pair back into memory, the completion sorts that out
+    slot = map->free_slots[map->free_count - 1];
+    request = &map->requests[slot];
+    request->key = strdup(key);
+    request->buf = (char *)malloc(loc->len);
+
+    if(request->key == NULL || request->buf == NULL)
+    {
+        free(request->key);
+        free(request->buf);
+        request->key = NULL;
+        request->buf = NULL;
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    map->free_count--;
+    request->fn = fn;
+    request->ctx = ctx;
+    request->hash = hash;
+    request->offset = loc->offset;
+    request->len = loc->len;
+
+#if HASHMAP_IO_URING
+    if(map->ring.fd >= 0) uring_queue(map, slot);
+#endif
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Submits the queued reads and calls the functions of the ones that finished
+ * @details Waits until at least min_complete reads finished, or as many as are in flight if fewer
+ * 
+ * @param map - pointer to the map
+ * @param min_complete - reads to wait for, 0 to only collect what already finished
+ * @return size_t - number of reads completed
+ */
+size_t hashmap_tiered_poll(hashmap_tiered_t* map, size_t min_complete)
+{
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return 0;
+    }
+
+    size_t in_flight = hashmap_tiered_pending(map);
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(min_complete > in_flight) min_complete = in_flight;
+
+#if HASHMAP_IO_URING
+    if(map->ring.fd >= 0) return uring_poll(map, min_complete);
+#endif
+
+    return pread_poll(map);
+}
+
+/**
+ * @brief Deletes a key-value pair from the map, freeing the value with the configured function
+ * 
+ * @param map - pointer to the map
+ * @param key - key to be deleted
+ * @return STATUS
+ */
+STATUS hashmap_tiered_delete(hashmap_tiered_t* map, const char* key)
+{
+    if(map == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hot_t* entry = (hot_t *)hashmap_get(map->hot, key);
+    uint64_t hash = 0;
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(entry != NULL)
+    {
+        // The CLOCK ring still points at the entry and frees it when the hand gets there or it is compacted
+        hashmap_delete(map->hot, key, NULL);
+        if(map->config.free_value != NULL) map->config.free_value(entry->value);
+        entry->value = NULL;
+        entry->dead = 1;
+        map->hot_size--;
+
+        if(++map->clock_dead > map->hot_size) clock_compact(map);
+
+        return SUCCESS;
+    }
+
+    hash = hash_key(map, key);
+
+    if(cold_find(map, key, hash, NULL, NULL) == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return ERROR;
+    }
+
+    hashmap_u64_delete(map->cold, hash, free);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the number of keys in the map, in memory and on disk
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_tiered_size(const hashmap_tiered_t* map)
+{
+    return (map != NULL) ? map->hot_size + hashmap_u64_size(map->cold) : 0;
+}
+
+/**
+ * @brief Returns the number of keys whose pairs are only on disk
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_tiered_cold_size(const hashmap_tiered_t* map)
+{
+    return (map != NULL) ? hashmap_u64_size(map->cold) : 0;
+}
+
+/**
+ * @brief Returns the number of reads queued or in flight
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_tiered_pending(const hashmap_tiered_t* map)
+{
+    return (map != NULL) ? map->depth - map->free_count : 0;
+}
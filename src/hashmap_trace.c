@@ -0,0 +1,433 @@
+/**
+ * @file hashmap_trace.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Latency histograms of push, get and delete, recorded when the library is built with HASHMAP_TRACE
+ * @details Every thread records into its own buffer, so tracing adds no shared writes to the operations. A buffer
+ * holds a log-linear latency histogram per operation like HdrHistogram: values below TRACE_SUB_BINS nanoseconds get
+ * a bin each, and every power of two above is split into TRACE_SUB_BINS bins, which keeps each bin within about 3%
+ * of the values in it. The probe and chain samples get one bin per count. The buffers are registered in a list
+ * that hashmap_trace_stats() sums on demand, and a buffer is folded into the retired totals when its thread exits.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "hashmap_internal.h"
+#include "hashmap_trace.h"
+
+#ifdef HASHMAP_TRACE
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACE_SUB_BITS 5                                // Bins per power of two, as a shift
+#define TRACE_SUB_BINS (1 << TRACE_SUB_BITS)            // Bins per power of two
+#define TRACE_MAX_BITS 40                               // Latencies are capped just under 2^40 ns, about 18 minutes
+#define TRACE_LATENCY_BINS ((TRACE_MAX_BITS - TRACE_SUB_BITS + 1) * TRACE_SUB_BINS)
+#define TRACE_CHAIN_BINS (HASHMAP_TRACE_MAX_CHAIN + 1)  // One bin per probe or chain count
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct trace_hist trace_hist_t;
+typedef struct trace_buffer trace_buffer_t;
+
+// Samples of one operation. Only the owning thread writes them, readers may see a sample half recorded.
+struct trace_hist
+{
+    atomic_uint_least64_t latency[TRACE_LATENCY_BINS];  // Calls per latency bin
+    atomic_uint_least64_t probes[TRACE_CHAIN_BINS];     // Calls per number of keys compared
+    atomic_uint_least64_t chain[TRACE_CHAIN_BINS];      // Calls per number of keys in the bucket
+    atomic_uint_least64_t total_ns;                     // Sum of the latencies, for the mean
+};
+
+// Histograms of one thread
+struct trace_buffer
+{
+    trace_hist_t ops[HASHMAP_TRACE_OPS];    // One per operation
+    trace_buffer_t* next;                   // Next registered buffer
+    trace_buffer_t* prev;                   // Previous registered buffer
+};
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;  // Protects the buffer list and the retired totals
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;           // Creates trace_key once
+static pthread_key_t trace_key;                                 // Retires a thread's buffer when it exits
+static trace_buffer_t* buffers = NULL;                          // Buffers of the live threads
+static trace_buffer_t retired;                                  // Samples of the threads that exited
+static _Thread_local trace_buffer_t* local = NULL;              // Buffer of this thread, NULL until it records
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Adds n to a counter only the calling thread writes, without a locked instruction
+ * 
+ * @param counter - the counter
+ * @param n - amount to add
+ */
+static inline void counter_add(atomic_uint_least64_t* counter, uint64_t n)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+/**
+ * @brief Adds the samples of one set of histograms to another
+ * 
+ * @param into - histograms added to
+ * @param from - histograms to add
+ */
+static void hist_merge(trace_hist_t* into, trace_hist_t* from)
+{
+    for(size_t bin = 0; bin < TRACE_LATENCY_BINS; bin++) counter_add(&into->latency[bin], atomic_load_explicit(&from->latency[bin], memory_order_relaxed));
+
+    for(size_t bin = 0; bin < TRACE_CHAIN_BINS; bin++)
+    {
+        counter_add(&into->probes[bin], atomic_load_explicit(&from->probes[bin], memory_order_relaxed));
+        counter_add(&into->chain[bin], atomic_load_explicit(&from->chain[bin], memory_order_relaxed));
+    }
+
+    counter_add(&into->total_ns, atomic_load_explicit(&from->total_ns, memory_order_relaxed));
+}
+
+/**
+ * @brief Folds the buffer of an exiting thread into the retired totals and frees it
+ * 
+ * @param arg - the thread's buffer
+ */
+static void buffer_retire(void* arg)
+{
+    trace_buffer_t* buffer = (trace_buffer_t *)arg;
+
+    pthread_mutex_lock(&trace_lock);
+
+    for(size_t op = 0; op < HASHMAP_TRACE_OPS; op++) hist_merge(&retired.ops[op], &buffer->ops[op]);
+
+    if(buffer->prev != NULL) buffer->prev->next = buffer->next;
+    else buffers = buffer->next;
+    if(buffer->next != NULL) buffer->next->prev = buffer->prev;
+
+    pthread_mutex_unlock(&trace_lock);
+
+    // The thread may still push from another destructor, it then starts a new buffer
+    local = NULL;
+    free(buffer);
+}
+
+/**
+ * @brief Creates the key that retires buffers at thread exit
+ * 
+ */
+static void trace_init(void)
+{
+    pthread_key_create(&trace_key, buffer_retire);
+}
+
+/**
+ * @brief Returns the calling thread's buffer, registering a new one on its first sample
+ * 
+ * @return trace_buffer_t* - NULL if it could not be allocated
+ */
+static trace_buffer_t* buffer_local(void)
+{
+    if(local != NULL) return local;
+
+    pthread_once(&trace_once, trace_init);
+
+    local = (trace_buffer_t *)calloc(1, sizeof(trace_buffer_t));
+    if(local == NULL) return NULL;
+
+    pthread_mutex_lock(&trace_lock);
+    local->next = buffers;
+    if(buffers != NULL) buffers->prev = local;
+    buffers = local;
+    pthread_mutex_unlock(&trace_lock);
+
+    pthread_setspecific(trace_key, local);
+
+    return local;
+}
+
+/**
+ * @brief Returns the latency bin of a value
+ * 
+ * @param ns - the latency
+ * @return size_t
+ */
+static inline size_t latency_bin(uint64_t ns)
+{
+    unsigned int magnitude = 0;
+
+    if(ns >= (1ULL << TRACE_MAX_BITS)) ns = (1ULL << TRACE_MAX_BITS) - 1;
+    if(ns < TRACE_SUB_BINS) return (size_t)ns;
+
+    magnitude = 63 - (unsigned int)__builtin_clzll(ns);
+
+    return (size_t)(magnitude - TRACE_SUB_BITS + 1) * TRACE_SUB_BINS + (size_t)((ns >> (magnitude - TRACE_SUB_BITS)) - TRACE_SUB_BINS);
+}
+
+/**
+ * @brief Returns the lowest latency a bin holds
+ * 
+ * @param bin - the bin
+ * @return uint64_t
+ */
+static uint64_t bin_lowest(size_t bin)
+{
+    size_t magnitude = 0;
+
+    if(bin < TRACE_SUB_BINS) return bin;
+
+    magnitude = bin / TRACE_SUB_BINS + TRACE_SUB_BITS - 1;
+
+    return (uint64_t)(TRACE_SUB_BINS + bin % TRACE_SUB_BINS) << (magnitude - TRACE_SUB_BITS);
+}
+
+/**
+ * @brief Returns the highest latency a bin holds
+ * 
+ * @param bin - the bin
+ * @return uint64_t
+ */
+static uint64_t bin_highest(size_t bin)
+{
+    return (bin + 1 < TRACE_LATENCY_BINS) ? bin_lowest(bin + 1) - 1 : (1ULL << TRACE_MAX_BITS) - 1;
+}
+
+/**
+ * @brief Returns the latency under which a fraction of the calls finished
+ * 
+ * @param hist - merged histograms
+ * @param count - number of calls in them
+ * @param fraction - between 0 and 1
+ * @return uint64_t - highest latency of the bin holding that call
+ */
+static uint64_t hist_percentile(trace_hist_t* hist, uint64_t count, double fraction)
+{
+    uint64_t target = (uint64_t)(fraction * (double)count);
+    uint64_t seen = 0;
+
+    if(target == 0) target = 1;
+
+    for(size_t bin = 0; bin < TRACE_LATENCY_BINS; bin++)
+    {
+        seen += atomic_load_explicit(&hist->latency[bin], memory_order_relaxed);
+        if(seen >= target) return bin_highest(bin);
+    }
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns a monotonic time in nanoseconds to measure an operation from
+ * 
+ * @return uint64_t
+ */
+uint64_t hashmap_trace_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Records one call of an operation into the calling thread's histograms
+ * 
+ * @param op - the operation
+ * @param elapsed_ns - how long it took
+ * @param probes - keys compared in the key's bucket
+ * @param chain - keys in the key's bucket
+ */
+void hashmap_trace_record(hashmap_trace_op_t op, uint64_t elapsed_ns, size_t probes, size_t chain)
+{
+    trace_buffer_t* buffer = buffer_local();
+    trace_hist_t* hist = NULL;
+
+    if(buffer == NULL || op >= HASHMAP_TRACE_OPS) return;
+
+    hist = &buffer->ops[op];
+    counter_add(&hist->latency[latency_bin(elapsed_ns)], 1);
+    counter_add(&hist->probes[(probes < HASHMAP_TRACE_MAX_CHAIN) ? probes : HASHMAP_TRACE_MAX_CHAIN], 1);
+    counter_add(&hist->chain[(chain < HASHMAP_TRACE_MAX_CHAIN) ? chain : HASHMAP_TRACE_MAX_CHAIN], 1);
+    counter_add(&hist->total_ns, elapsed_ns);
+}
+
+/**
+ * @brief Fills stats with the samples of op merged over every thread, the exited ones included
+ * 
+ * @param op - the operation
+ * @param stats - filled with the summary
+ * @return STATUS - ERROR with HASHMAP_ERR_INVALID_CONFIG if the library was built without HASHMAP_TRACE
+ */
+STATUS hashmap_trace_stats(hashmap_trace_op_t op, hashmap_trace_stats_t* stats)
+{
+    if(stats == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    if(op >= HASHMAP_TRACE_OPS)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return ERROR;
+    }
+
+    trace_hist_t* merged = (trace_hist_t *)calloc(1, sizeof(trace_hist_t));
+    uint64_t probes = 0;
+    uint64_t chain = 0;
+
+    if(merged == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    pthread_mutex_lock(&trace_lock);
+    hist_merge(merged, &retired.ops[op]);
+    for(trace_buffer_t* buffer = buffers; buffer != NULL; buffer = buffer->next) hist_merge(merged, &buffer->ops[op]);
+    pthread_mutex_unlock(&trace_lock);
+
+    memset(stats, 0, sizeof(hashmap_trace_stats_t));
+
+    for(size_t bin = 0; bin < TRACE_LATENCY_BINS; bin++)
+    {
+        uint64_t calls = atomic_load_explicit(&merged->latency[bin], memory_order_relaxed);
+
+        if(calls == 0) continue;
+        if(stats->count == 0) stats->min_ns = bin_lowest(bin);
+
+        stats->count += calls;
+        stats->max_ns = bin_highest(bin);
+    }
+
+    for(size_t bin = 0; bin < TRACE_CHAIN_BINS; bin++)
+    {
+        uint64_t probe_calls = atomic_load_explicit(&merged->probes[bin], memory_order_relaxed);
+        uint64_t chain_calls = atomic_load_explicit(&merged->chain[bin], memory_order_relaxed);
+
+        probes += probe_calls * bin;
+        chain += chain_calls * bin;
+        if(probe_calls > 0) stats->max_probes = bin;
+        if(chain_calls > 0) stats->max_chain = bin;
+    }
+
+    if(stats->count > 0)
+    {
+        stats->p50_ns = hist_percentile(merged, stats->count, 0.5);
+        stats->p90_ns = hist_percentile(merged, stats->count, 0.9);
+        stats->p99_ns = hist_percentile(merged, stats->count, 0.99);
+        stats->p999_ns = hist_percentile(merged, stats->count, 0.999);
+        stats->mean_ns = (double)atomic_load_explicit(&merged->total_ns, memory_order_relaxed) / (double)stats->count;
+        stats->mean_probes = (double)probes / (double)stats->count;
+        stats->mean_chain = (double)chain / (double)stats->count;
+    }
+
+    free(merged);
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Writes a table of the latency percentiles and bucket samples of every operation to out
+ * 
+ * @param out - stream to write to, stderr if NULL
+ */
+void hashmap_trace_dump(FILE* out)
+{
+    static const char* names[HASHMAP_TRACE_OPS] = { "push", "get", "delete" };
+
+    if(out == NULL) out = stderr;
+
+    fprintf(out, "%-8s %12s %10s %10s %10s %10s %10s %10s %10s %8s %8s\n", "op", "count", "min ns", "p50 ns", "p90 ns",
+            "p99 ns", "p99.9 ns", "max ns", "mean ns", "probes", "chain");
+
+    for(size_t op = 0; op < HASHMAP_TRACE_OPS; op++)
+    {
+        hashmap_trace_stats_t stats;
+
+        if(hashmap_trace_stats((hashmap_trace_op_t)op, &stats) == ERROR) continue;
+
+        fprintf(out, "%-8s %12llu %10llu %10llu %10llu %10llu %10llu %10llu %10.1f %8.2f %8.2f\n", names[op],
+                (unsigned long long)stats.count, (unsigned long long)stats.min_ns, (unsigned long long)stats.p50_ns,
+                (unsigned long long)stats.p90_ns, (unsigned long long)stats.p99_ns, (unsigned long long)stats.p999_ns,
+                (unsigned long long)stats.max_ns, stats.mean_ns, stats.mean_probes, stats.mean_chain);
+    }
+}
+
+/**
+ * @brief Drops every sample recorded so far
+ * @details Samples recorded by other threads while this runs may be kept
+ * 
+ */
+void hashmap_trace_reset(void)
+{
+    pthread_mutex_lock(&trace_lock);
+
+    memset(&retired, 0, sizeof(retired.ops));
+
+    for(trace_buffer_t* buffer = buffers; buffer != NULL; buffer = buffer->next)
+    {
+        for(size_t op = 0; op < HASHMAP_TRACE_OPS; op++)
+        {
+            trace_hist_t* hist = &buffer->ops[op];
+
+            for(size_t bin = 0; bin < TRACE_LATENCY_BINS; bin++) atomic_store_explicit(&hist->latency[bin], 0, memory_order_relaxed);
+
+            for(size_t bin = 0; bin < TRACE_CHAIN_BINS; bin++)
+            {
+                atomic_store_explicit(&hist->probes[bin], 0, memory_order_relaxed);
+                atomic_store_explicit(&hist->chain[bin], 0, memory_order_relaxed);
+            }
+
+            atomic_store_explicit(&hist->total_ns, 0, memory_order_relaxed);
+        }
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+}
+
+#else
+
+/**
+ * @brief Fills stats with the samples of op, but the library was built without HASHMAP_TRACE
+ * 
+ * @param op - the operation
+ * @param stats - left untouched
+ * @return STATUS - ERROR with HASHMAP_ERR_INVALID_CONFIG
+ */
+STATUS hashmap_trace_stats(hashmap_trace_op_t op, hashmap_trace_stats_t* stats)
+{
+    (void)op;
+    (void)stats;
+
+    hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+    return ERROR;
+}
+
+/**
+ * @brief Writes the latency table, but the library was built without HASHMAP_TRACE so only says so
+ * 
+ * @param out - stream to write to, stderr if NULL
+ */
+void hashmap_trace_dump(FILE* out)
+{
+    fprintf((out != NULL) ? out : stderr, "hashmap: built without HASHMAP_TRACE, no latencies recorded\n");
+}
+
+/**
+ * @brief Drops every sample recorded so far. Nothing is recorded without HASHMAP_TRACE.
+ * 
+ */
+void hashmap_trace_reset(void)
+{
+}
+
+#endif
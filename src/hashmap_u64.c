@@ -0,0 +1,213 @@
+/**
+ * @file hashmap_u64.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Hashmap keyed by 64 bit integers. Keys are stored inline in an open addressed slot array so
+ * there is no allocation per entry.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdlib.h>
+
+#include "hashmap_u64.h"
+#include "hashmap_internal.h"
+#include "hashmap_slots.h"
+
+//---------------------------------------------------------------------------------------------------------
+
+// The integer keyed hashmap structure. Obfuscated from the user
+struct hashmap_u64
+{
+    hashmap_slots_t table;  // Slot array holding each key as the word and its value as the pointer
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the hashmap_u64_t object and returns the handle
+ * @details The map grows as needed, capacity only sizes the initial slot array
+ * 
+ * @param capacity - number of keys expected
+ * @return hashmap_u64_t* - pointer to the hashmap_u64_t object. NULL if error.
+ */
+hashmap_u64_t* hashmap_u64_create(size_t capacity)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_u64_t* map = NULL;
+
+    if(capacity == 0 || capacity > HASHMAP_SLOTS_MAX_CAPACITY)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CAPACITY);
+        return NULL;
+    }
+
+    map = (hashmap_u64_t *)malloc(sizeof(hashmap_u64_t));
+
+    if(map == NULL || hashmap_slots_init(&map->table, capacity, hashmap_random_u64(), 1) == ERROR)
+    {
+        free(map);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    return map;
+}
+
+/**
+ * @brief Safely deallocates map. User can optionally provide a function for freeing values.
+ * 
+ * @param map - pointer to the map
+ * @param fn - optional pointer to function for freeing values. Can pass NULL to not have library handle freeing values.
+ */
+void hashmap_u64_destroy(hashmap_u64_t* map, free_value_fn_t fn)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(map != NULL)
+    {
+        if(fn != NULL)
+        {
+            for(size_t i = 0; i <= map->table.mask; i++)
+            {
+                if(map->table.slots[i].ptr != NULL) fn(map->table.slots[i].ptr);
+            }
+        }
+
+        hashmap_slots_free(&map->table);
+        free(map);
+    }
+}
+
+/**
+ * @brief Add a new key-value pair to the map
+ * 
+ * @param map - pointer to the map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS 
+ */
+STATUS hashmap_u64_push(hashmap_u64_t* map, uint64_t key, void* value)
+{
+    if(map == NULL || value == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(hashmap_slots_reserve(&map->table) == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    hashmap_slot_t* slots = map->table.slots;
+    size_t slot_idx = hashmap_slots_home(&map->table, key);
+
+    // Probe until an empty slot or the same key is found
+    while(slots[slot_idx].ptr != NULL)
+    {
+        if(slots[slot_idx].word == key)
+        {
+            hashmap_set_errno(HASHMAP_ERR_DUPLICATE);
+            return ERROR;
+        }
+
+        slot_idx = (slot_idx + 1) & map->table.mask;
+    }
+
+    slots[slot_idx].word = key;
+    slots[slot_idx].ptr = value;
+    map->table.size++;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the value for the given key
+ * 
+ * @param map - pointer to the map
+ * @param key - key to search for
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_u64_get(const hashmap_u64_t* map, uint64_t key)
+{
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    const hashmap_slot_t* slots = map->table.slots;
+    size_t slot_idx = hashmap_slots_home(&map->table, key);
+
+    while(slots[slot_idx].ptr != NULL)
+    {
+        if(slots[slot_idx].word == key)
+        {
+            hashmap_set_errno(HASHMAP_ERR_NONE);
+            return slots[slot_idx].ptr;
+        }
+
+        slot_idx = (slot_idx + 1) & map->table.mask;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+    return NULL;
+}
+
+/**
+ * @brief Deletes a key-value pair from the map
+ * @details Uses backward shift deletion so probe sequences never need tombstones
+ * 
+ * @param map - pointer to the map
+ * @param key - key to be deleted
+ * @param fn - optional function for freeing the value. Can be left NULL if user plans to handle deallocation.
+ * @return STATUS 
+ */
+STATUS hashmap_u64_delete(hashmap_u64_t* map, uint64_t key, free_value_fn_t fn)
+{
+    if(map == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    const hashmap_slot_t* slots = map->table.slots;
+    size_t hole = hashmap_slots_home(&map->table, key);
+
+    while(slots[hole].ptr != NULL && slots[hole].word != key)
+    {
+        hole = (hole + 1) & map->table.mask;
+    }
+
+    if(slots[hole].ptr == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return ERROR;
+    }
+
+    if(fn != NULL) fn(slots[hole].ptr);
+
+    hashmap_slots_erase(&map->table, hole);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the number of keys in the map
+ * 
+ * @param map - pointer to the map
+ * @return size_t - 0 if map is NULL
+ */
+size_t hashmap_u64_size(const hashmap_u64_t* map)
+{
+    return (map != NULL) ? map->table.size : 0;
+}
+
+//---------------------------------------------------------------------------------------------------------
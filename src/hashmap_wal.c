@@ -0,0 +1,993 @@
+/**
+ * @file hashmap_wal.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Hashmap whose pushes and deletes are recorded in a write-ahead log so it survives a crash
+ * @details The map lives in a directory holding a snapshot file and a log file, both a sequence of the same
+ * checksummed records. Opening the directory replays the snapshot and then the log. Records go to an in-memory
+ * buffer under the lock that orders them with the map, and are written out in batches: with
+ * HASHMAP_WAL_SYNC_ALWAYS the first waiting writer writes and syncs everything buffered so far while the others
+ * wait for it, so concurrent writers share one fsync(). Compaction moves the log aside, writes every pair of an
+ * O(1) hashmap_snapshot() to a new snapshot file from a background thread while writers carry on, and then drops
+ * the old log. Replaying a push replaces the key, so replaying a record that the snapshot already holds is harmless
+ * and a crash at any point recovers the last synced state.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hashmap_wal.h"
+#include "hashmap_internal.h"
+#include "murmur3.h"
+
+#define WAL_BUFFER_BYTES 65536          // Buffered bytes that make a writer flush without waiting for a sync
+#define WAL_DEFAULT_INTERVAL_MS 10      // Background sync period when sync_interval_ms is 0
+#define WAL_HEADER_BYTES 13             // Checksum, key length, value length and type
+#define WAL_CHECKSUM_SEED 0x77616c31    // Seed of the record checksums
+#define WAL_PATH_MAX 4096               // Longest file path in the directory
+#define WAL_DIR_MAX (WAL_PATH_MAX - 16) // Longest directory path, leaves room for "/snapshot.tmp"
+
+#define RECORD_PUSH 1   // Record of a push, or of a pair in the snapshot
+#define RECORD_DELETE 2 // Record of a delete
+
+//---------------------------------------------------------------------------------------------------------
+
+typedef struct wal_buffer wal_buffer_t;
+
+// Growable byte buffer
+struct wal_buffer
+{
+    char* data;     // The bytes
+    size_t len;     // Number of bytes used
+    size_t space;   // Number of bytes data has room for
+};
+
+// The durable hashmap structure. Obfuscated from the user
+struct hashmap_wal
+{
+    pthread_mutex_t lock;       // Held while the map, the buffer or the log file are used
+    pthread_cond_t done;        // Signalled when a flush or a compaction finishes
+    pthread_cond_t wake;        // Wakes the background thread
+    pthread_t thread;           // Background thread syncing and compacting the log
+    hashmap_t* map;             // The pairs
+    hashmap_wal_config_t config;    // Options given to hashmap_wal_open()
+    char dir[WAL_DIR_MAX];      // Directory of the files
+    int fd;                     // Log file
+    wal_buffer_t buffer;        // Records not written to the log yet
+    wal_buffer_t spare;         // Second buffer, swapped in while the first one is written
+    uint64_t appended;          // Number of records appended
+    uint64_t written;           // Number of records written to the log file
+    uint64_t synced;            // Number of records made durable with fdatasync(), never more than written
+    size_t log_bytes;           // Size of the log file
+    int flushing;               // Set while a thread writes a buffer outside the lock
+    int compacting;             // Set while a compaction runs
+    int closing;                // Tells the background thread to stop
+    int failed;                 // Set once writing the log failed, no more writes are accepted
+    void** deferred;            // Values deleted during a compaction, which may still be encoding them
+    size_t deferred_count;      // Number of entries in deferred
+    size_t deferred_space;      // Number of entries deferred has room for
+};
+
+// Passed through hashmap_foreach() while a snapshot file is written
+typedef struct snapshot_ctx
+{
+    hashmap_wal_t* wal;         // The durable map
+    int fd;                     // Snapshot file
+    wal_buffer_t buffer;        // Records not written yet
+    STATUS status;              // ERROR once anything failed
+}snapshot_ctx_t;
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Makes sure a buffer has room for more bytes
+ * 
+ * @param buffer - the buffer
+ * @param more - number of bytes to add
+ * @return STATUS - ERROR if it could not grow
+ */
+static STATUS buffer_reserve(wal_buffer_t* buffer, size_t more)
+{
+    if(buffer->len + more <= buffer->space) return SUCCESS;
+
+    size_t space = (buffer->space == 0) ? WAL_BUFFER_BYTES : buffer->space;
+
+    while(space < buffer->len + more) space *= 2;
+
+    char* data = (char *)realloc(buffer->data, space);
+    if(data == NULL) return ERROR;
+
+    buffer->data = data;
+    buffer->space = space;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Makes sure a value deleted during a compaction can be added to the deferred list
+ * 
+ * @param wal - the durable map
+ * @return STATUS - ERROR if the list could not grow
+ */
+static STATUS deferred_reserve(hashmap_wal_t* wal)
+{
+    if(wal->deferred_count < wal->deferred_space) return SUCCESS;
+
+    size_t space = (wal->deferred_space == 0) ? 16 : wal->deferred_space * 2;
+    void** deferred = (void **)realloc(wal->deferred, space * sizeof(void *));
+
+    if(deferred == NULL) return ERROR;
+
+    wal->deferred = deferred;
+    wal->deferred_space = space;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Appends a record to a buffer
+ * 
+ * @param buffer - the buffer
+ * @param config - options holding the encode function
+ * @param type - RECORD_PUSH or RECORD_DELETE
+ * @param key - key of the record
+ * @param value - value of a push, NULL for a delete
+ * @return STATUS - ERROR if the buffer could not grow
+ */
+static STATUS record_append(wal_buffer_t* buffer, const hashmap_wal_config_t* config, uint8_t type, const char* key, const void* value)
+{
+    uint32_t key_len = (uint32_t)strlen(key);
+    uint32_t value_len = 0;
+    uint32_t checksum = 0;
+    char* record = NULL;
+
+    if(buffer_reserve(buffer, WAL_HEADER_BYTES + key_len) == ERROR) return ERROR;
+
+    if(value != NULL)
+    {
+        size_t space = buffer->space - buffer->len - WAL_HEADER_BYTES - key_len;
+        size_t needed = config->encode(value, buffer->data + buffer->len + WAL_HEADER_BYTES + key_len, space);
+
+        if(needed > UINT32_MAX) return ERROR;
+
+        // Too big for what was left, encode again once there is room
+        if(needed > space)
+        {
+            if(buffer_reserve(buffer, WAL_HEADER_BYTES + key_len + needed) == ERROR) return ERROR;
+            config->encode(value, buffer->data + buffer->len + WAL_HEADER_BYTES + key_len, needed);
+        }
+
+        value_len = (uint32_t)needed;
+    }
+
+    record = buffer->data + buffer->len;
+    memcpy(record + 4, &key_len, sizeof(key_len));
+    memcpy(record + 8, &value_len, sizeof(value_len));
+    record[12] = (char)type;
+    memcpy(record + WAL_HEADER_BYTES, key, key_len);
+
+    MurmurHash3_x86_32(record + 4, (int)(WAL_HEADER_BYTES - 4 + key_len + value_len), WAL_CHECKSUM_SEED, &checksum);
+    memcpy(record, &checksum, sizeof(checksum));
+
+    buffer->len += WAL_HEADER_BYTES + key_len + value_len;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Writes all of len bytes to fd
+ * 
+ * @param fd - file descriptor
+ * @param data - the bytes
+ * @param len - number of bytes
+ * @return STATUS
+ */
+static STATUS write_all(int fd, const char* data, size_t len)
+{
+    while(len > 0)
+    {
+        ssize_t written = write(fd, data, len);
+
+        if(written < 0) return ERROR;
+
+        data += written;
+        len -= (size_t)written;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Builds the path of a file of the directory
+ * 
+ * @param wal - the durable map
+ * @param name - file name
+ * @param path - set to the path, WAL_PATH_MAX bytes
+ */
+static void wal_path(const hashmap_wal_t* wal, const char* name, char* path)
+{
+    snprintf(path, WAL_PATH_MAX, "%s/%s", wal->dir, name);
+}
+
+/**
+ * @brief Syncs the directory so renames and new files survive a crash
+ * 
+ * @param wal - the durable map
+ * @return STATUS
+ */
+static STATUS dir_sync(const hashmap_wal_t* wal)
+{
+    int fd = open(wal->dir, O_RDONLY | O_DIRECTORY);
+    STATUS status = SUCCESS;
+
+    if(fd < 0) return ERROR;
+    if(fsync(fd) != 0) status = ERROR;
+    close(fd);
+
+    return status;
+}
+
+/**
+ * @brief Applies one record to the map
+ * @details A push replaces the key if it is there, so replaying a record twice changes nothing
+ * 
+ * @param wal - the durable map
+ * @param key - the key
+ * @param value - decoded value of a push, NULL for a delete
+ * @return STATUS - ERROR if the value could not be pushed
+ */
+static STATUS record_apply(hashmap_wal_t* wal, const char* key, void* value)
+{
+    if(value == NULL)
+    {
+        hashmap_delete(wal->map, key, wal->config.free_value);
+        return SUCCESS;
+    }
+
+    hashmap_delete(wal->map, key, wal->config.free_value);
+
+    if(hashmap_push(wal->map, key, value) == ERROR)
+    {
+        if(wal->config.free_value != NULL) wal->config.free_value(value);
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Applies every record of a file to the map
+ * @details Replay stops at the first record that is cut short or fails its checksum, which is where a crash
+ * interrupted a write. Nothing after it was ever reported durable.
+ * 
+ * @param wal - the durable map
+ * @param name - file name in the directory
+ * @param valid - optional, set to the length of the intact records
+ * @return STATUS - ERROR if the file could not be read or a record could not be applied
+ */
+static STATUS file_replay(hashmap_wal_t* wal, const char* name, size_t* valid)
+{
+    char path[WAL_PATH_MAX];
+    struct stat info;
+    char* data = NULL;
+    size_t size = 0;
+    size_t pos = 0;
+    STATUS status = SUCCESS;
+    int fd = -1;
+
+    if(valid != NULL) *valid = 0;
+
+    wal_path(wal, name, path);
+    fd = open(path, O_RDONLY);
+    if(fd < 0) return SUCCESS;
+
+    if(fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return ERROR;
+    }
+
+    size = (size_t)info.st_size;
+    data = (char *)malloc((size > 0) ? size : 1);
+
+    for(size_t read_bytes = 0; data != NULL && read_bytes < size; )
+    {
+        ssize_t got = read(fd, data + read_bytes, size - read_bytes);
+
+        if(got <= 0)
+        {
+            size = read_bytes;
+            break;
+        }
+
+        read_bytes += (size_t)got;
+    }
+
+    close(fd);
+    if(data == NULL) return ERROR;
+
+    while(status == SUCCESS && size - pos >= WAL_HEADER_BYTES)
+    {
+        char* record = data + pos;
+        uint32_t stored = 0;
+        uint32_t checksum = 0;
+        uint32_t key_len = 0;
+        uint32_t value_len = 0;
+        uint8_t type = (uint8_t)record[12];
+        void* value = NULL;
+
+        memcpy(&stored, record, sizeof(stored));
+        memcpy(&key_len, record + 4, sizeof(key_len));
+        memcpy(&value_len, record + 8, sizeof(value_len));
+
+        if((uint64_t)key_len + value_len > size - pos - WAL_HEADER_BYTES) break;
+
+        MurmurHash3_x86_32(record + 4, (int)(WAL_HEADER_BYTES - 4 + key_len + value_len), WAL_CHECKSUM_SEED, &checksum);
+        if(checksum != stored || (type != RECORD_PUSH && type != RECORD_DELETE)) break;
+
+        if(type == RECORD_PUSH)
+        {
+            value = wal->config.decode(record + WAL_HEADER_BYTES + key_len, value_len);
+            if(value == NULL) status = ERROR;
+        }
+
+        // Move the key back over the type byte, which was already read, to make room for its terminator
+        memmove(record + WAL_HEADER_BYTES - 1, record + WAL_HEADER_BYTES, key_len);
+        record[WAL_HEADER_BYTES - 1 + key_len] = '\0';
+        if(status == SUCCESS) status = record_apply(wal, record + WAL_HEADER_BYTES - 1, value);
+
+        pos += WAL_HEADER_BYTES + key_len + value_len;
+    }
+
+    free(data);
+    if(valid != NULL) *valid = pos;
+
+    return status;
+}
+
+/**
+ * @brief Writes one pair of the map being compacted to the snapshot file
+ * 
+ * @param key - the key
+ * @param value - the value
+ * @param ctx - the snapshot_ctx_t
+ */
+static void snapshot_pair(const char* key, void* value, void* ctx)
+{
+    snapshot_ctx_t* snapshot = (snapshot_ctx_t *)ctx;
+
+    if(snapshot->status == ERROR) return;
+
+    if(record_append(&snapshot->buffer, &snapshot->wal->config, RECORD_PUSH, key, value) == ERROR)
+    {
+        snapshot->status = ERROR;
+        return;
+    }
+
+    if(snapshot->buffer.len >= WAL_BUFFER_BYTES)
+    {
+        snapshot->status = write_all(snapshot->fd, snapshot->buffer.data, snapshot->buffer.len);
+        snapshot->buffer.len = 0;
+    }
+}
+
+/**
+ * @brief Replaces the snapshot file with the pairs of map
+ * @details The pairs go to a temporary file that is synced and then renamed over the old snapshot, so a crash
+ * leaves either the old or the new snapshot whole
+ * 
+ * @param wal - the durable map
+ * @param map - the map or a snapshot of it
+ * @return STATUS
+ */
+static STATUS snapshot_write(hashmap_wal_t* wal, const hashmap_t* map)
+{
+    char tmp_path[WAL_PATH_MAX];
+    char path[WAL_PATH_MAX];
+    snapshot_ctx_t snapshot = { wal, -1, { NULL, 0, 0 }, SUCCESS };
+
+    wal_path(wal, "snapshot.tmp", tmp_path);
+    wal_path(wal, "snapshot", path);
+
+    snapshot.fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(snapshot.fd < 0) return ERROR;
+
+    hashmap_foreach(map, snapshot_pair, &snapshot);
+
+    if(snapshot.status == SUCCESS) snapshot.status = write_all(snapshot.fd, snapshot.buffer.data, snapshot.buffer.len);
+    if(snapshot.status == SUCCESS && fsync(snapshot.fd) != 0) snapshot.status = ERROR;
+
+    close(snapshot.fd);
+    free(snapshot.buffer.data);
+
+    if(snapshot.status == SUCCESS && rename(tmp_path, path) != 0) snapshot.status = ERROR;
+    if(snapshot.status == SUCCESS) snapshot.status = dir_sync(wal);
+    if(snapshot.status == ERROR) unlink(tmp_path);
+
+    return snapshot.status;
+}
+
+/**
+ * @brief Writes the buffered records to the log, syncing them if sync is set
+ * @details Called with the lock held. The buffer is swapped for the spare and written with the lock released, so
+ * writers keep appending to the next batch meanwhile. Only one thread writes at a time, the others wait here.
+ * With sync set, records written earlier without a sync are synced too, even if nothing new is buffered.
+ * 
+ * @param wal - the durable map
+ * @param sync - 1 to fdatasync() the log after writing
+ * @return STATUS - ERROR if writing failed, the log then takes no more writes
+ */
+static STATUS log_flush(hashmap_wal_t* wal, int sync)
+{
+    wal_buffer_t batch;
+    uint64_t target = 0;
+    STATUS status = SUCCESS;
+
+    while(wal->flushing) pthread_cond_wait(&wal->done, &wal->lock);
+
+    if(wal->failed) return ERROR;
+    if(wal->buffer.len == 0 && wal->written == wal->appended && (!sync || wal->synced == wal->written)) return SUCCESS;
+
+    batch = wal->buffer;
+    wal->buffer = wal->spare;
+    wal->buffer.len = 0;
+    target = wal->appended;
+    wal->flushing = 1;
+    pthread_mutex_unlock(&wal->lock);
+
+    status = write_all(wal->fd, batch.data, batch.len);
+    if(status == SUCCESS && sync && fdatasync(wal->fd) != 0) status = ERROR;
+
+    pthread_mutex_lock(&wal->lock);
+    wal->spare = batch;
+    wal->log_bytes += batch.len;
+    wal->flushing = 0;
+
+    if(status == SUCCESS)
+    {
+        wal->written = target;
+        if(sync) wal->synced = target;
+    }
+    else
+    {
+        wal->failed = 1;
+    }
+
+    pthread_cond_broadcast(&wal->done);
+
+    return status;
+}
+
+/**
+ * @brief Waits until the record numbered lsn is as durable as the policy asks, writing it out if needed
+ * @details Called with the lock held, right after appending a record
+ * 
+ * @param wal - the durable map
+ * @param lsn - number of the record
+ * @return STATUS
+ */
+static STATUS log_commit(hashmap_wal_t* wal, uint64_t lsn)
+{
+    STATUS status = SUCCESS;
+
+    if(wal->config.sync == HASHMAP_WAL_SYNC_ALWAYS)
+    {
+        // Whoever gets here first writes out everyone's records. The rest find theirs done when it returns.
+        while(wal->synced < lsn && status == SUCCESS) status = log_flush(wal, 1);
+    }
+    else if(wal->buffer.len >= WAL_BUFFER_BYTES && !wal->flushing)
+    {
+        status = log_flush(wal, 0);
+    }
+
+    if(wal->config.compact_bytes > 0 && wal->log_bytes >= wal->config.compact_bytes && !wal->compacting)
+    {
+        pthread_cond_signal(&wal->wake);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Ends a compaction, freeing the values deleted while it ran
+ * @details Called with the lock held
+ * 
+ * @param wal - the durable map
+ */
+static void compact_finish(hashmap_wal_t* wal)
+{
+    for(size_t value_idx = 0; value_idx < wal->deferred_count; value_idx++) wal->config.free_value(wal->deferred[value_idx]);
+
+    wal->deferred_count = 0;
+    wal->compacting = 0;
+    pthread_cond_broadcast(&wal->done);
+}
+
+/**
+ * @brief Snapshots the map and drops the log that the snapshot replaces
+ * @details Takes the lock itself and releases it while the snapshot file is written, so writers are only held up
+ * while the log is moved aside. Values deleted in the meantime are freed once the snapshot file is written.
+ * 
+ * @param wal - the durable map
+ * @return STATUS
+ */
+static STATUS log_compact(hashmap_wal_t* wal)
+{
+    char path[WAL_PATH_MAX];
+    char old_path[WAL_PATH_MAX];
+    hashmap_t* snapshot = NULL;
+    STATUS status = SUCCESS;
+    int fd = -1;
+
+    wal_path(wal, "log", path);
+    wal_path(wal, "log.old", old_path);
+
+    pthread_mutex_lock(&wal->lock);
+
+    // Claimed before flushing, which lets go of the lock
+    while(wal->compacting) pthread_cond_wait(&wal->done, &wal->lock);
+    wal->compacting = 1;
+
+    // Everything in the log must be on disk before the snapshot can stand in for it
+    status = log_flush(wal, 1);
+
+    if(status == SUCCESS && rename(path, old_path) != 0) status = ERROR;
+    if(status == SUCCESS) fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+
+    if(status == ERROR || fd < 0)
+    {
+        compact_finish(wal);
+        pthread_mutex_unlock(&wal->lock);
+        return ERROR;
+    }
+
+    // Writers must not be told their records are durable in a log the directory may not name yet
+    if(dir_sync(wal) == ERROR)
+    {
+        close(fd);
+        rename(old_path, path);
+        compact_finish(wal);
+        pthread_mutex_unlock(&wal->lock);
+        return ERROR;
+    }
+
+    close(wal->fd);
+    wal->fd = fd;
+    wal->log_bytes = 0;
+
+    snapshot = hashmap_snapshot(wal->map);
+    pthread_mutex_unlock(&wal->lock);
+
+    status = (snapshot != NULL) ? snapshot_write(wal, snapshot) : ERROR;
+
+    // Until the new snapshot is in place, recovery still needs the old log
+    if(status == SUCCESS) unlink(old_path);
+
+    pthread_mutex_lock(&wal->lock);
+    hashmap_destroy(snapshot, NULL);
+    compact_finish(wal);
+    pthread_mutex_unlock(&wal->lock);
+
+    return status;
+}
+
+/**
+ * @brief Background thread: syncs the log on the policy's schedule and compacts it once it grows too long
+ * 
+ * @param arg - the durable map
+ * @return void* - NULL
+ */
+static void* wal_thread(void* arg)
+{
+    hashmap_wal_t* wal = (hashmap_wal_t *)arg;
+    unsigned int interval = (wal->config.sync_interval_ms > 0) ? wal->config.sync_interval_ms : WAL_DEFAULT_INTERVAL_MS;
+
+    pthread_mutex_lock(&wal->lock);
+
+    while(!wal->closing)
+    {
+        struct timespec deadline;
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += interval / 1000;
+        deadline.tv_nsec += (long)(interval % 1000) * 1000000L;
+
+        if(deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_cond_timedwait(&wal->wake, &wal->lock, &deadline);
+        if(wal->closing) break;
+
+        if(wal->config.sync == HASHMAP_WAL_SYNC_INTERVAL) log_flush(wal, 1);
+
+        if(wal->config.compact_bytes > 0 && wal->log_bytes >= wal->config.compact_bytes && !wal->failed)
+        {
+            pthread_mutex_unlock(&wal->lock);
+            log_compact(wal);
+            pthread_mutex_lock(&wal->lock);
+        }
+    }
+
+    pthread_mutex_unlock(&wal->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Rebuilds the map from the directory and leaves an empty log ready for appending
+ * @details A leftover log.old means a compaction was interrupted, it is replayed between the snapshot and the
+ * log. If there was anything to replay, a new snapshot is written before the log is emptied.
+ * 
+ * @param wal - the durable map
+ * @return STATUS
+ */
+static STATUS wal_recover(hashmap_wal_t* wal)
+{
+    char path[WAL_PATH_MAX];
+    char old_path[WAL_PATH_MAX];
+    size_t old_valid = 0;
+    size_t valid = 0;
+
+    wal_path(wal, "log", path);
+    wal_path(wal, "log.old", old_path);
+
+    if(file_replay(wal, "snapshot", NULL) == ERROR) return ERROR;
+    if(file_replay(wal, "log.old", &old_valid) == ERROR) return ERROR;
+    if(file_replay(wal, "log", &valid) == ERROR) return ERROR;
+
+    if((old_valid > 0 || valid > 0) && snapshot_write(wal, wal->map) == ERROR) return ERROR;
+
+    // The snapshot now holds every intact record, and a torn one at the end of the log is dropped with the rest
+    unlink(old_path);
+    wal->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+
+    if(wal->fd < 0) return ERROR;
+
+    return dir_sync(wal);
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Opens the durable map in dir, recovering the pairs it held, and returns the handle
+ * @details dir is created if it does not exist. Only one handle may have a directory open at a time.
+ * 
+ * @param dir - directory holding the snapshot and the log
+ * @param capacity - max number of unique indexes for the map, as for hashmap_create()
+ * @param config - durability policy and the functions that turn values into bytes and back
+ * @return hashmap_wal_t* - pointer to the hashmap_wal_t object. NULL if error.
+ */
+hashmap_wal_t* hashmap_wal_open(const char* dir, size_t capacity, const hashmap_wal_config_t* config)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashmap_wal_t* wal = NULL;
+
+    if(dir == NULL || config == NULL || config->encode == NULL || config->decode == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    if(strlen(dir) >= WAL_DIR_MAX || config->sync > HASHMAP_WAL_SYNC_NONE)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CONFIG);
+        return NULL;
+    }
+
+    wal = (hashmap_wal_t *)calloc(1, sizeof(hashmap_wal_t));
+
+    if(wal == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    wal->map = hashmap_create(capacity);
+
+    if(wal->map == NULL)
+    {
+        hashmap_err_t err = hashmap_errno();
+
+        free(wal);
+        hashmap_set_errno(err);
+        return NULL;
+    }
+
+    wal->config = *config;
+    wal->fd = -1;
+    strcpy(wal->dir, dir);
+    mkdir(dir, 0755);
+
+    if(wal_recover(wal) == ERROR)
+    {
+        if(wal->fd >= 0) close(wal->fd);
+        hashmap_destroy(wal->map, wal->config.free_value);
+        free(wal);
+        hashmap_set_errno(HASHMAP_ERR_IO);
+        return NULL;
+    }
+
+    pthread_mutex_init(&wal->lock, NULL);
+    pthread_cond_init(&wal->done, NULL);
+    pthread_cond_init(&wal->wake, NULL);
+
+    if(pthread_create(&wal->thread, NULL, wal_thread, wal) != 0)
+    {
+        close(wal->fd);
+        hashmap_destroy(wal->map, wal->config.free_value);
+        pthread_cond_destroy(&wal->wake);
+        pthread_cond_destroy(&wal->done);
+        pthread_mutex_destroy(&wal->lock);
+        free(wal);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return NULL;
+    }
+
+    return wal;
+}
+
+/**
+ * @brief Syncs the log and frees the durable map, including its values if a free function was configured
+ * @details No other thread may be using the map. The handle is freed even if the final sync fails.
+ * 
+ * @param wal - pointer to the durable map
+ * @return STATUS - ERROR with HASHMAP_ERR_IO if the last records could not be made durable
+ */
+STATUS hashmap_wal_close(hashmap_wal_t* wal)
+{
+    if(wal == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    STATUS status = SUCCESS;
+
+    pthread_mutex_lock(&wal->lock);
+    wal->closing = 1;
+    pthread_cond_signal(&wal->wake);
+    pthread_mutex_unlock(&wal->lock);
+    pthread_join(wal->thread, NULL);
+
+    pthread_mutex_lock(&wal->lock);
+    status = log_flush(wal, 1);
+    pthread_mutex_unlock(&wal->lock);
+
+    close(wal->fd);
+    hashmap_destroy(wal->map, wal->config.free_value);
+    pthread_cond_destroy(&wal->wake);
+    pthread_cond_destroy(&wal->done);
+    pthread_mutex_destroy(&wal->lock);
+    free(wal->buffer.data);
+    free(wal->spare.data);
+    free(wal->deferred);
+    free(wal);
+
+    hashmap_set_errno((status == SUCCESS) ? HASHMAP_ERR_NONE : HASHMAP_ERR_IO);
+
+    return status;
+}
+
+/**
+ * @brief Add a new key-value pair to the map and log it
+ * @details Returns once the record is as durable as the policy asks. If the log can't be written the pair is
+ * still in memory but may not survive a crash, and ERROR is returned with HASHMAP_ERR_IO.
+ * 
+ * @param wal - pointer to the durable map
+ * @param key - key for the pair
+ * @param value - value for the pair
+ * @return STATUS
+ */
+STATUS hashmap_wal_push(hashmap_wal_t* wal, const char* key, void* value)
+{
+    if(wal == NULL || key == NULL || value == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    STATUS status = SUCCESS;
+    hashmap_err_t err = HASHMAP_ERR_NONE;
+
+    pthread_mutex_lock(&wal->lock);
+
+    if(wal->failed)
+    {
+        pthread_mutex_unlock(&wal->lock);
+        hashmap_set_errno(HASHMAP_ERR_IO);
+        return ERROR;
+    }
+
+    // Log the record first so a push that can't be logged never happens
+    size_t record_start = wal->buffer.len;
+
+    if(record_append(&wal->buffer, &wal->config, RECORD_PUSH, key, value) == ERROR)
+    {
+        pthread_mutex_unlock(&wal->lock);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    status = hashmap_push(wal->map, key, value);
+    err = hashmap_errno();
+
+    if(status == ERROR)
+    {
+        // Take the record back out, nothing was appended after it while the lock was held
+        wal->buffer.len = record_start;
+    }
+    else
+    {
+        status = log_commit(wal, ++wal->appended);
+        if(status == ERROR) err = HASHMAP_ERR_IO;
+    }
+
+    pthread_mutex_unlock(&wal->lock);
+    hashmap_set_errno(err);
+
+    return status;
+}
+
+/**
+ * @brief Returns the value for the given key
+ * @details A value returned here may be freed by a concurrent delete, as with hashmap_concurrent_get()
+ * 
+ * @param wal - pointer to the durable map
+ * @param key - key to search for
+ * @return void* - NULL if not found, pointer to value otherwise
+ */
+void* hashmap_wal_get(hashmap_wal_t* wal, const char* key)
+{
+    if(wal == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    void* value = NULL;
+
+    pthread_mutex_lock(&wal->lock);
+    value = hashmap_get(wal->map, key);
+    pthread_mutex_unlock(&wal->lock);
+
+    return value;
+}
+
+/**
+ * @brief Deletes a key-value pair from the map and logs it, freeing the value with the configured function
+ * 
+ * @param wal - pointer to the durable map
+ * @param key - key to be deleted
+ * @return STATUS
+ */
+STATUS hashmap_wal_delete(hashmap_wal_t* wal, const char* key)
+{
+    if(wal == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    STATUS status = SUCCESS;
+    hashmap_err_t err = HASHMAP_ERR_NONE;
+    void* value = NULL;
+
+    pthread_mutex_lock(&wal->lock);
+
+    value = hashmap_get(wal->map, key);
+
+    if(wal->failed || value == NULL)
+    {
+        err = wal->failed ? HASHMAP_ERR_IO : HASHMAP_ERR_NOT_FOUND;
+        pthread_mutex_unlock(&wal->lock);
+        hashmap_set_errno(err);
+        return ERROR;
+    }
+
+    // Room for the deferred value is made first so the delete can't fail halfway
+    if((wal->compacting && wal->config.free_value != NULL && deferred_reserve(wal) == ERROR) ||
+       record_append(&wal->buffer, &wal->config, RECORD_DELETE, key, NULL) == ERROR)
+    {
+        pthread_mutex_unlock(&wal->lock);
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    hashmap_delete(wal->map, key, NULL);
+
+    // The compaction may still be encoding the value from its snapshot
+    if(wal->config.free_value != NULL)
+    {
+        if(wal->compacting) wal->deferred[wal->deferred_count++] = value;
+        else wal->config.free_value(value);
+    }
+
+    status = log_commit(wal, ++wal->appended);
+    if(status == ERROR) err = HASHMAP_ERR_IO;
+
+    pthread_mutex_unlock(&wal->lock);
+    hashmap_set_errno(err);
+
+    return status;
+}
+
+/**
+ * @brief Returns the number of keys in the map
+ * 
+ * @param wal - pointer to the durable map
+ * @return size_t - 0 if wal is NULL
+ */
+size_t hashmap_wal_size(hashmap_wal_t* wal)
+{
+    size_t size = 0;
+
+    if(wal == NULL) return 0;
+
+    pthread_mutex_lock(&wal->lock);
+    size = hashmap_size(wal->map);
+    pthread_mutex_unlock(&wal->lock);
+
+    return size;
+}
+
+/**
+ * @brief Writes and syncs every record logged so far, whatever the policy
+ * 
+ * @param wal - pointer to the durable map
+ * @return STATUS - ERROR with HASHMAP_ERR_IO if the log could not be written
+ */
+STATUS hashmap_wal_sync(hashmap_wal_t* wal)
+{
+    if(wal == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    STATUS status = SUCCESS;
+
+    pthread_mutex_lock(&wal->lock);
+
+    status = log_flush(wal, 1);
+
+    pthread_mutex_unlock(&wal->lock);
+    hashmap_set_errno((status == SUCCESS) ? HASHMAP_ERR_NONE : HASHMAP_ERR_IO);
+
+    return status;
+}
+
+/**
+ * @brief Replaces the snapshot with the current pairs and empties the log, on the calling thread
+ * @details Other threads can keep using the map meanwhile. Compactions also start by themselves once the log
+ * reaches compact_bytes.
+ * 
+ * @param wal - pointer to the durable map
+ * @return STATUS - ERROR with HASHMAP_ERR_IO if the files could not be written
+ */
+STATUS hashmap_wal_compact(hashmap_wal_t* wal)
+{
+    if(wal == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    STATUS status = log_compact(wal);
+
+    hashmap_set_errno((status == SUCCESS) ? HASHMAP_ERR_NONE : HASHMAP_ERR_IO);
+
+    return status;
+}
@@ -0,0 +1,461 @@
+/**
+ * @file hashset.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Set of strings. Keys and their hashes sit in the open addressed slot array shared with the
+ * integer keyed hashmap, so membership costs no value slot and no node.
+ * @details Union, intersection and difference walk one set's slots in batches: the hashes of a whole batch are
+ * computed and their slots in the other set prefetched before any of them is probed, so the cache misses of a
+ * batch overlap instead of being taken one key at a time.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashset.h"
+#include "hashmap_internal.h"
+#include "hashmap_slots.h"
+
+#define SET_BATCH 16    // Keys hashed and prefetched together by the set operations
+
+//---------------------------------------------------------------------------------------------------------
+
+// The set structure. Obfuscated from the user
+struct hashset
+{
+    hashmap_slots_t table;  // Slot array holding each key's hash as the word and the key as the pointer
+};
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hashes a key with the set's seed
+ * 
+ * @param set - pointer to the set
+ * @param key - key to hash
+ * @return uint64_t - the hash
+ */
+static inline uint64_t hash_key(const hashset_t* set, const char* key)
+{
+    uint64_t hash[2] = {0};
+
+    MurmurHash3_x64_128_seed64(key, (int)strlen(key), set->table.seed, hash);
+
+    return hash[0];
+}
+
+/**
+ * @brief Returns the slot holding key, or the empty slot that ends its probe sequence
+ * 
+ * @param set - pointer to the set
+ * @param key - the key
+ * @param hash - hash of the key with the set's seed
+ * @return size_t - index of the slot
+ */
+static inline size_t set_probe(const hashset_t* set, const char* key, uint64_t hash)
+{
+    const hashmap_slot_t* slots = set->table.slots;
+    size_t slot_idx = hashmap_slots_home(&set->table, hash);
+
+    while(slots[slot_idx].ptr != NULL)
+    {
+        if(slots[slot_idx].word == hash && strcmp((const char *)slots[slot_idx].ptr, key) == 0) break;
+
+        slot_idx = (slot_idx + 1) & set->table.mask;
+    }
+
+    return slot_idx;
+}
+
+/**
+ * @brief Allocates an empty set
+ * 
+ * @param capacity - number of keys expected
+ * @param seed - seed for the hashes
+ * @return hashset_t* - NULL if it could not be allocated
+ */
+static hashset_t* set_alloc(size_t capacity, uint64_t seed)
+{
+    hashset_t* set = (hashset_t *)malloc(sizeof(hashset_t));
+
+    if(set == NULL || hashmap_slots_init(&set->table, capacity, seed, 0) == ERROR)
+    {
+        free(set);
+        return NULL;
+    }
+
+    return set;
+}
+
+/**
+ * @brief Copies a key that is not in the set yet into it
+ * 
+ * @param set - pointer to the set
+ * @param key - the key
+ * @param hash - hash of the key with the set's seed
+ * @return STATUS 
+ */
+static STATUS set_insert(hashset_t* set, const char* key, uint64_t hash)
+{
+    char* copy = NULL;
+    size_t slot_idx = 0;
+
+    if(hashmap_slots_reserve(&set->table) == ERROR) return ERROR;
+
+    copy = strdup(key);
+    if(copy == NULL) return ERROR;
+
+    slot_idx = set_probe(set, key, hash);
+    set->table.slots[slot_idx].word = hash;
+    set->table.slots[slot_idx].ptr = copy;
+    set->table.size++;
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Adds to result every key of source whose membership in filter is wanted
+ * @details Keys are handled SET_BATCH at a time: hashed and prefetched in filter first, then probed. Stored hashes,
+ * and the hashes computed for filter, are reused wherever the sets share a seed.
+ * 
+ * @param result - set to add to. May be filter itself, since every probe is done after the prefetches.
+ * @param source - set whose keys are visited
+ * @param filter - set the keys are looked up in, NULL to take every key
+ * @param keep_found - 1 to take keys that are in filter, 0 to take keys that are not
+ * @return STATUS - ERROR if result could not grow
+ */
+static STATUS set_merge(hashset_t* result, const hashset_t* source, const hashset_t* filter, int keep_found)
+{
+    const hashmap_slot_t* batch[SET_BATCH];
+    uint64_t hashes[SET_BATCH];
+    size_t slot_idx = 0;
+
+    while(slot_idx <= source->table.mask)
+    {
+        size_t count = 0;
+
+        for(; slot_idx <= source->table.mask && count < SET_BATCH; slot_idx++)
+        {
+            const hashmap_slot_t* slot = &source->table.slots[slot_idx];
+
+            if(slot->ptr == NULL) continue;
+
+            batch[count] = slot;
+
+            if(filter != NULL)
+            {
+                hashes[count] = (filter->table.seed == source->table.seed) ? slot->word : hash_key(filter, (const char *)slot->ptr);
+#if defined(__GNUC__) || defined(__clang__)
+                __builtin_prefetch(&filter->table.slots[hashmap_slots_home(&filter->table, hashes[count])], 0, 1);
+#endif
+            }
+
+            count++;
+        }
+
+        for(size_t batch_idx = 0; batch_idx < count; batch_idx++)
+        {
+            const char* key = (const char *)batch[batch_idx]->ptr;
+            uint64_t hash = 0;
+
+            if(filter != NULL)
+            {
+                int found = filter->table.slots[set_probe(filter, key, hashes[batch_idx])].ptr != NULL;
+
+                if(found != keep_found) continue;
+            }
+
+            if(result->table.seed == source->table.seed)
+            {
+                hash = batch[batch_idx]->word;
+            }
+            else if(filter != NULL && result->table.seed == filter->table.seed)
+            {
+                hash = hashes[batch_idx];
+            }
+            else
+            {
+                hash = hash_key(result, key);
+            }
+
+            if(set_insert(result, key, hash) == ERROR) return ERROR;
+        }
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the result of a set operation, or NULL with errno set if it could not be built
+ * 
+ * @param result - the result set, NULL if it could not be allocated
+ * @param status - status of filling it
+ * @return hashset_t* 
+ */
+static hashset_t* set_result(hashset_t* result, STATUS status)
+{
+    if(result != NULL && status == SUCCESS)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NONE);
+        return result;
+    }
+
+    hashset_destroy(result);
+    hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+
+    return NULL;
+}
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates the hashset_t object and returns the handle
+ * @details The set grows as needed, capacity only sizes the initial slot array
+ * 
+ * @param capacity - number of keys expected
+ * @return hashset_t* - pointer to the hashset_t object. NULL if error.
+ */
+hashset_t* hashset_create(size_t capacity)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    hashset_t* set = NULL;
+
+    if(capacity == 0 || capacity > HASHMAP_SLOTS_MAX_CAPACITY)
+    {
+        hashmap_set_errno(HASHMAP_ERR_INVALID_CAPACITY);
+        return NULL;
+    }
+
+    set = set_alloc(capacity, hashmap_random_u64());
+
+    if(set == NULL) hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+
+    return set;
+}
+
+/**
+ * @brief Safely deallocates set
+ * 
+ * @param set - pointer to the set
+ */
+void hashset_destroy(hashset_t* set)
+{
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    if(set != NULL)
+    {
+        for(size_t i = 0; i <= set->table.mask; i++)
+        {
+            free(set->table.slots[i].ptr);
+        }
+
+        hashmap_slots_free(&set->table);
+        free(set);
+    }
+}
+
+/**
+ * @brief Adds a key to the set
+ * 
+ * @param set - pointer to the set
+ * @param key - key to add
+ * @return STATUS - ERROR with HASHMAP_ERR_DUPLICATE if the key is already in the set
+ */
+STATUS hashset_add(hashset_t* set, const char* key)
+{
+    if(set == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    uint64_t hash = hash_key(set, key);
+
+    if(set->table.slots[set_probe(set, key, hash)].ptr != NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_DUPLICATE);
+        return ERROR;
+    }
+
+    if(set_insert(set, key, hash) == ERROR)
+    {
+        hashmap_set_errno(HASHMAP_ERR_ALLOC_FAILED);
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns whether a key is in the set
+ * 
+ * @param set - pointer to the set
+ * @param key - key to search for
+ * @return int - 1 if found, 0 otherwise
+ */
+int hashset_contains(const hashset_t* set, const char* key)
+{
+    if(set == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return 0;
+    }
+
+    if(set->table.slots[set_probe(set, key, hash_key(set, key))].ptr == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return 0;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return 1;
+}
+
+/**
+ * @brief Removes a key from the set
+ * @details Uses backward shift deletion so probe sequences never need tombstones
+ * 
+ * @param set - pointer to the set
+ * @param key - key to be removed
+ * @return STATUS 
+ */
+STATUS hashset_remove(hashset_t* set, const char* key)
+{
+    if(set == NULL || key == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+    size_t hole = set_probe(set, key, hash_key(set, key));
+
+    if(set->table.slots[hole].ptr == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NOT_FOUND);
+        return ERROR;
+    }
+
+    free(set->table.slots[hole].ptr);
+    hashmap_slots_erase(&set->table, hole);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns the number of keys in the set
+ * 
+ * @param set - pointer to the set
+ * @return size_t - 0 if set is NULL
+ */
+size_t hashset_size(const hashset_t* set)
+{
+    return (set != NULL) ? set->table.size : 0;
+}
+
+/**
+ * @brief Calls fn on every key of the set
+ * @details The order is unspecified. fn must not add to or remove from the set.
+ * 
+ * @param set - pointer to the set
+ * @param fn - function called with each key and ctx
+ * @param ctx - passed through to fn
+ * @return STATUS 
+ */
+STATUS hashset_foreach(const hashset_t* set, hashset_foreach_fn_t fn, void* ctx)
+{
+    if(set == NULL || fn == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return ERROR;
+    }
+
+    for(size_t i = 0; i <= set->table.mask; i++)
+    {
+        if(set->table.slots[i].ptr != NULL) fn((const char *)set->table.slots[i].ptr, ctx);
+    }
+
+    hashmap_set_errno(HASHMAP_ERR_NONE);
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Returns a new set of the keys in a, b or both
+ * 
+ * @param a - first set
+ * @param b - second set
+ * @return hashset_t* - the union. NULL if error.
+ */
+hashset_t* hashset_union(const hashset_t* a, const hashset_t* b)
+{
+    if(a == NULL || b == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    hashset_t* result = set_alloc(a->table.size + b->table.size, a->table.seed);
+    STATUS status = ERROR;
+
+    // Copying a first needs no lookups, then b is filtered against what is already in
+    if(result != NULL) status = set_merge(result, a, NULL, 0);
+    if(status == SUCCESS) status = set_merge(result, b, result, 0);
+
+    return set_result(result, status);
+}
+
+/**
+ * @brief Returns a new set of the keys in both a and b
+ * 
+ * @param a - first set
+ * @param b - second set
+ * @return hashset_t* - the intersection. NULL if error.
+ */
+hashset_t* hashset_intersection(const hashset_t* a, const hashset_t* b)
+{
+    if(a == NULL || b == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    // Walk the smaller set and look its keys up in the larger one
+    const hashset_t* small = (a->table.size <= b->table.size) ? a : b;
+    const hashset_t* large = (a->table.size <= b->table.size) ? b : a;
+    hashset_t* result = set_alloc(small->table.size, small->table.seed);
+    STATUS status = ERROR;
+
+    if(result != NULL) status = set_merge(result, small, large, 1);
+
+    return set_result(result, status);
+}
+
+/**
+ * @brief Returns a new set of the keys in a but not in b
+ * 
+ * @param a - first set
+ * @param b - second set
+ * @return hashset_t* - the difference. NULL if error.
+ */
+hashset_t* hashset_difference(const hashset_t* a, const hashset_t* b)
+{
+    if(a == NULL || b == NULL)
+    {
+        hashmap_set_errno(HASHMAP_ERR_NULL_ARG);
+        return NULL;
+    }
+
+    hashset_t* result = set_alloc(a->table.size, a->table.seed);
+    STATUS status = ERROR;
+
+    if(result != NULL) status = set_merge(result, a, b, 0);
+
+    return set_result(result, status);
+}
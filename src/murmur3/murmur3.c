@@ -7,6 +7,9 @@
 // compile and run any of them on any platform, but your performance with the
 // non-native version will be less than optimal.
 
+#include <stddef.h>
+#include <string.h>
+
 #include "murmur3.h"
 
 //-----------------------------------------------------------------------------
@@ -37,7 +40,22 @@ static FORCE_INLINE uint64_t rotl64 ( uint64_t x, int8_t r )
 // Block read - if your platform needs to do endian-swapping or can only
 // handle aligned reads, do the conversion here
 
-#define getblock(p, i) (p[i])
+// Keys and log records start at any byte, so blocks are read with memcpy(), which compiles to one load where
+// unaligned loads are allowed
+
+static FORCE_INLINE uint32_t getblock32 ( const uint32_t * p, int i )
+{
+  uint32_t block;
+  memcpy(&block, (const uint8_t *)p + (ptrdiff_t)i * 4, sizeof(block));
+  return block;
+}
+
+static FORCE_INLINE uint64_t getblock64 ( const uint64_t * p, int i )
+{
+  uint64_t block;
+  memcpy(&block, (const uint8_t *)p + (ptrdiff_t)i * 8, sizeof(block));
+  return block;
+}
 
 //-----------------------------------------------------------------------------
 // Finalization mix - force all bits of a hash block to avalanche
@@ -55,16 +73,8 @@ static FORCE_INLINE uint32_t fmix32 ( uint32_t h )
 
 //----------
 
-static FORCE_INLINE uint64_t fmix64 ( uint64_t k )
-{
-  k ^= k >> 33;
-  k *= BIG_CONSTANT(0xff51afd7ed558ccd);
-  k ^= k >> 33;
-  k *= BIG_CONSTANT(0xc4ceb9fe1a85ec53);
-  k ^= k >> 33;
-
-  return k;
-}
+// fmix64 lives in murmur3.h so integer keys can be hashed inline
+#define fmix64(k) MurmurHash3_fmix64(k)
 
 //-----------------------------------------------------------------------------
 
@@ -87,7 +97,7 @@ void MurmurHash3_x86_32 ( const void * key, int len,
 
   for(i = -nblocks; i; i++)
   {
-    uint32_t k1 = getblock(blocks,i);
+    uint32_t k1 = getblock32(blocks,i);
 
     k1 *= c1;
     k1 = ROTL32(k1,15);
@@ -149,10 +159,10 @@ void MurmurHash3_x86_128 ( const void * key, const int len,
 
   for(i = -nblocks; i; i++)
   {
-    uint32_t k1 = getblock(blocks,i*4+0);
-    uint32_t k2 = getblock(blocks,i*4+1);
-    uint32_t k3 = getblock(blocks,i*4+2);
-    uint32_t k4 = getblock(blocks,i*4+3);
+    uint32_t k1 = getblock32(blocks,i*4+0);
+    uint32_t k2 = getblock32(blocks,i*4+1);
+    uint32_t k3 = getblock32(blocks,i*4+2);
+    uint32_t k4 = getblock32(blocks,i*4+3);
 
     k1 *= c1; k1  = ROTL32(k1,15); k1 *= c2; h1 ^= k1;
 
@@ -233,6 +243,15 @@ void MurmurHash3_x86_128 ( const void * key, const int len,
 
 void MurmurHash3_x64_128 ( const void * key, const int len,
                            const uint32_t seed, void * out )
+{
+  MurmurHash3_x64_128_seed64(key, len, seed, out);
+}
+
+//-----------------------------------------------------------------------------
+// Same as MurmurHash3_x64_128 but both lanes start from a full 64 bit seed
+
+void MurmurHash3_x64_128_seed64 ( const void * key, const int len,
+                                  const uint64_t seed, void * out )
 {
   const uint8_t * data = (const uint8_t*)key;
   const int nblocks = len / 16;
@@ -251,8 +270,8 @@ void MurmurHash3_x64_128 ( const void * key, const int len,
 
   for(i = 0; i < nblocks; i++)
   {
-    uint64_t k1 = getblock(blocks,i*2+0);
-    uint64_t k2 = getblock(blocks,i*2+1);
+    uint64_t k1 = getblock64(blocks,i*2+0);
+    uint64_t k2 = getblock64(blocks,i*2+1);
 
     k1 *= c1; k1  = ROTL64(k1,31); k1 *= c2; h1 ^= k1;
 
@@ -0,0 +1,94 @@
+/**
+ * @file siphash.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief SipHash-1-3 (one compression round, three finalization rounds) as described by Aumasson and
+ * Bernstein. Without the 128 bit key an attacker can't predict which keys collide.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <string.h>
+
+#include "siphash.h"
+
+#define ROTL64(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v0, v1, v2, v3)                                        \
+    do                                                                  \
+    {                                                                   \
+        v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32);   \
+        v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2;                        \
+        v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0;                        \
+        v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32);   \
+    } while(0)
+
+//---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Reads 8 bytes as a little endian word
+ * 
+ * @param p - pointer to the bytes
+ * @return uint64_t 
+ */
+static inline uint64_t read_u64_le(const uint8_t* p)
+{
+    uint64_t word = 0;
+
+    memcpy(&word, p, sizeof(word));
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    word = __builtin_bswap64(word);
+#endif
+
+    return word;
+}
+
+/**
+ * @brief Hashes len bytes of key with SipHash-1-3
+ * 
+ * @param key - bytes to hash
+ * @param len - number of bytes
+ * @param k - 128 bit secret key
+ * @return uint64_t - the hash
+ */
+uint64_t SipHash13(const void* key, size_t len, const uint64_t k[2])
+{
+    const uint8_t* data = (const uint8_t *)key;
+    const uint8_t* end = data + (len & ~(size_t)7);
+    uint64_t v0 = k[0] ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = k[1] ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k[0] ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = k[1] ^ 0x7465646279746573ULL;
+    uint64_t last = (uint64_t)len << 56;
+
+    for(; data != end; data += 8)
+    {
+        uint64_t m = read_u64_le(data);
+
+        v3 ^= m;
+        SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    // Remaining 0-7 bytes go in the low bytes of the last word, the length in its top byte
+    for(size_t i = 0; i < (len & 7); i++)
+    {
+        last |= (uint64_t)data[i] << (8 * i);
+    }
+
+    v3 ^= last;
+    SIPROUND(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+//---------------------------------------------------------------------------------------------------------
@@ -0,0 +1,28 @@
+/**
+ * @file siphash.h
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief SipHash-1-3 keyed hash, used for maps exposed to untrusted keys
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _SIPHASH_H_
+#define _SIPHASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t SipHash13(const void* key, size_t len, const uint64_t k[2]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SIPHASH_H_
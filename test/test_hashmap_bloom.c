@@ -0,0 +1,136 @@
+/**
+ * @file test_hashmap_bloom.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for maps created with HASHMAP_FLAG_BLOOM
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+
+#define BLOOM_TEST_KEYS 4000
+
+static int values[BLOOM_TEST_KEYS];
+
+/**
+ * @brief Checks that exactly the keys in [present_from, present_to) are found
+ * 
+ * @param map - pointer to the map
+ * @param present_from - first key expected in the map
+ * @param present_to - one past the last key expected in the map
+ * @return STATUS - SUCCESS or ERROR
+ */
+static STATUS check_keys(const hashmap_t* map, int present_from, int present_to)
+{
+    char key[32];
+
+    for(int i = 0; i < BLOOM_TEST_KEYS; i++)
+    {
+        int present = (i >= present_from && i < present_to);
+
+        snprintf(key, sizeof(key), "key-%d", i);
+
+        if(hashmap_get(map, key) != (present ? &values[i] : NULL)) return ERROR;
+        if(!present && hashmap_errno() != HASHMAP_ERR_NOT_FOUND) return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Test that the filter never hides a key as the map grows past the filter's size, is reseeded and is cleared
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(bloom_grow_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_BLOOM, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(16, &config);
+    char key[32];
+
+    for(int i = 0; i < BLOOM_TEST_KEYS / 2; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    if(check_keys(map, 0, BLOOM_TEST_KEYS / 2) != SUCCESS)
+    {
+        PRINT_ERR("wrong lookup result after growing the filter");
+        error_status = ERROR;
+    }
+
+    hashmap_set_seed(map, 42);
+
+    if(check_keys(map, 0, BLOOM_TEST_KEYS / 2) != SUCCESS)
+    {
+        PRINT_ERR("wrong lookup result after reseeding");
+        error_status = ERROR;
+    }
+
+    hashmap_clear(map, NULL);
+
+    if(check_keys(map, 0, 0) != SUCCESS)
+    {
+        PRINT_ERR("wrong lookup result after clearing");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test lookups while deletes make the filter stale and rebuild it
+ * @details Deleting three quarters of the keys rebuilds the filter on the way. Pushing a deleted key again has to
+ * get through the filter's stale bits as a new key.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(bloom_delete_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_BLOOM, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(BLOOM_TEST_KEYS, &config);
+    char key[32];
+
+    for(int i = 0; i < BLOOM_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    for(int i = 0; i < 3 * BLOOM_TEST_KEYS / 4; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+
+        if(hashmap_delete(map, key, NULL) != SUCCESS || hashmap_delete(map, key, NULL) != ERROR)
+        {
+            PRINT_ERR("hashmap_delete() failed with a filter");
+            error_status = ERROR;
+        }
+    }
+
+    if(check_keys(map, 3 * BLOOM_TEST_KEYS / 4, BLOOM_TEST_KEYS) != SUCCESS)
+    {
+        PRINT_ERR("wrong lookup result after deletes");
+        error_status = ERROR;
+    }
+
+    snprintf(key, sizeof(key), "key-%d", 0);
+
+    if(hashmap_push(map, key, &values[0]) != SUCCESS || hashmap_get(map, key) != &values[0])
+    {
+        PRINT_ERR("deleted key could not be pushed again");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file test_hashmap_clear.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_clear() and hashmap_reserve() library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+
+#define CLEAR_TEST_KEYS 200
+
+static int freed_count = 0;
+
+
+/**
+ * @brief Counts the values handed to it instead of freeing them
+ * 
+ * @param value - value being freed
+ */
+static void count_free(void* value)
+{
+    (void)value;
+    freed_count++;
+}
+
+/**
+ * @brief Test clearing a map and reusing it
+ * @details Both the short touched-bucket path and the full scan of a map with more keys than buckets are covered.
+ * Every value should be passed to fn once and the keys should be pushable again.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(clear_reuse_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1000);
+    static int values[CLEAR_TEST_KEYS];
+    char key[32];
+
+    for(int round = 0; round < 3; round++)
+    {
+        // Few keys the first rounds, then enough that the touched bucket list gives up
+        int key_count = (round < 2) ? 10 : CLEAR_TEST_KEYS;
+
+        for(int i = 0; i < key_count; i++)
+        {
+            snprintf(key, sizeof(key), "key-%d", i);
+
+            if(hashmap_push(map, key, &values[i]) != SUCCESS)
+            {
+                PRINT_ERR("hashmap_push() failed after hashmap_clear()");
+                error_status = ERROR;
+            }
+        }
+
+        freed_count = 0;
+
+        if(hashmap_clear(map, count_free) != SUCCESS || freed_count != key_count)
+        {
+            PRINT_ERR("hashmap_clear() did not free every value once");
+            error_status = ERROR;
+        }
+
+        snprintf(key, sizeof(key), "key-%d", 0);
+
+        if(hashmap_get(map, key) != NULL || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+        {
+            PRINT_ERR("hashmap_get() found a key after hashmap_clear()");
+            error_status = ERROR;
+        }
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test clearing a map that shares its buckets with a snapshot
+ * @details The snapshot should keep every key while the map ends up empty
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(clear_snapshot_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(20);
+    hashmap_t* snapshot = NULL;
+    hashmap_stats_t stats;
+    int values[2] = {1, 2};
+
+    hashmap_push(map, "one", &values[0]);
+    hashmap_push(map, "two", &values[1]);
+    snapshot = hashmap_snapshot(map);
+
+    if(hashmap_clear(map, NULL) != SUCCESS)
+    {
+        PRINT_ERR("hashmap_clear() failed");
+        error_status = ERROR;
+    }
+
+    if(hashmap_get(snapshot, "one") != &values[0] || hashmap_get(snapshot, "two") != &values[1])
+    {
+        PRINT_ERR("snapshot lost a key when the map was cleared");
+        error_status = ERROR;
+    }
+
+    hashmap_stats(map, &stats);
+
+    if(stats.size != 0 || stats.used_buckets != 0 || hashmap_get(map, "one") != NULL)
+    {
+        PRINT_ERR("map is not empty after hashmap_clear()");
+        error_status = ERROR;
+    }
+
+    if(hashmap_clear(snapshot, NULL) != ERROR || hashmap_errno() != HASHMAP_ERR_READ_ONLY)
+    {
+        PRINT_ERR("hashmap_clear() on a snapshot did not fail with HASHMAP_ERR_READ_ONLY");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(snapshot, NULL);
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test growing a map with hashmap_reserve()
+ * @details Keys should survive the rehash, smaller requests should be ignored and 0 should be rejected
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(reserve_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(4);
+    hashmap_stats_t stats;
+    static int values[CLEAR_TEST_KEYS];
+    char key[32];
+
+    for(int i = 0; i < CLEAR_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    if(hashmap_reserve(map, 512) != SUCCESS || hashmap_reserve(map, 8) != SUCCESS)
+    {
+        PRINT_ERR("hashmap_reserve() failed");
+        error_status = ERROR;
+    }
+
+    hashmap_stats(map, &stats);
+
+    if(stats.capacity != 512 || stats.size != CLEAR_TEST_KEYS)
+    {
+        PRINT_ERR("hashmap_reserve() did not grow the map to the requested capacity");
+        error_status = ERROR;
+    }
+
+    for(int i = 0; i < CLEAR_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+
+        if(hashmap_get(map, key) != &values[i])
+        {
+            PRINT_ERR("hashmap_get() lost a key after hashmap_reserve()");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    if(hashmap_reserve(map, 0) != ERROR || hashmap_errno() != HASHMAP_ERR_INVALID_CAPACITY)
+    {
+        PRINT_ERR("hashmap_reserve() did not fail with HASHMAP_ERR_INVALID_CAPACITY");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file test_hashmap_compact.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_compact_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdio.h>
+
+#include "test.h"
+#include "hashmap_compact.h"
+
+#define COMPACT_TEST_KEYS 5000
+
+
+/**
+ * @brief Test pushing, getting and deleting many string keys
+ * @details The index has to widen from 8 to 16 bit slots and deleted entries have to be reclaimed on resize
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(compact_push_get_delete_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_compact_t* map = hashmap_compact_create(1);
+    static int values[COMPACT_TEST_KEYS];
+    char key[32];
+
+    for(int i = 0; i < COMPACT_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+
+        if(hashmap_compact_push(map, key, &values[i]) != SUCCESS)
+        {
+            PRINT_ERR("hashmap_compact_push() failed");
+            error_status = ERROR;
+        }
+    }
+
+    // Delete every other key, then push them back so the deleted entries get compacted away
+    for(int round = 0; round < 2; round++)
+    {
+        for(int i = 0; i < COMPACT_TEST_KEYS; i += 2)
+        {
+            snprintf(key, sizeof(key), "key-%d", i);
+
+            if(hashmap_compact_delete(map, key, NULL) != SUCCESS)
+            {
+                PRINT_ERR("hashmap_compact_delete() failed");
+                error_status = ERROR;
+            }
+
+            if(round == 0) hashmap_compact_push(map, key, &values[i]);
+        }
+    }
+
+    for(int i = 0; i < COMPACT_TEST_KEYS; i++)
+    {
+        void* expected = (i % 2 == 0) ? NULL : &values[i];
+
+        snprintf(key, sizeof(key), "key-%d", i);
+
+        if(hashmap_compact_get(map, key) != expected)
+        {
+            PRINT_ERR("hashmap_compact_get() returned the wrong value");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    if(hashmap_compact_size(map) != COMPACT_TEST_KEYS / 2)
+    {
+        PRINT_ERR("hashmap_compact_size() is wrong after deletes");
+        error_status = ERROR;
+    }
+
+    hashmap_compact_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that hashmap_compact_next() walks the keys in insertion order
+ * @details Deleted keys are skipped and a key pushed again after being deleted moves to the end
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(compact_insertion_order_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_compact_t* map = hashmap_compact_create(4);
+    const char* pushed[] = {"delta", "alpha", "echo", "charlie", "bravo"};
+    const char* expected[] = {"delta", "echo", "charlie", "bravo", "alpha"};
+    int values[5] = {0};
+    size_t cursor = 0;
+    size_t count = 0;
+    const char* key = NULL;
+    void* value = NULL;
+
+    for(int i = 0; i < 5; i++)
+    {
+        hashmap_compact_push(map, pushed[i], &values[i]);
+    }
+
+    hashmap_compact_delete(map, "alpha", NULL);
+    hashmap_compact_push(map, "alpha", &values[1]);
+
+    while(hashmap_compact_next(map, &cursor, &key, &value) == SUCCESS)
+    {
+        if(count >= 5 || strcmp(key, expected[count]) != 0 || value != hashmap_compact_get(map, key))
+        {
+            PRINT_ERR("hashmap_compact_next() did not follow insertion order");
+            error_status = ERROR;
+            break;
+        }
+
+        count++;
+    }
+
+    if(count != 5 || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_compact_next() did not end with HASHMAP_ERR_NOT_FOUND after every key");
+        error_status = ERROR;
+    }
+
+    hashmap_compact_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test passing a duplicate key and a non existent key
+ * @details Should fail with HASHMAP_ERR_DUPLICATE and HASHMAP_ERR_NOT_FOUND
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(compact_duplicate_and_missing_key_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_compact_t* map = hashmap_compact_create(20);
+    int value = 0;
+
+    hashmap_compact_push(map, "key", &value);
+
+    if(hashmap_compact_push(map, "key", &value) != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("hashmap_compact_push() did not fail with HASHMAP_ERR_DUPLICATE");
+        error_status = ERROR;
+    }
+
+    if(hashmap_compact_get(map, "missing") != NULL || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_compact_get() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    if(hashmap_compact_delete(map, "missing", NULL) != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_compact_delete() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    hashmap_compact_destroy(map, NULL);
+
+    return error_status;
+}
@@ -0,0 +1,259 @@
+/**
+ * @file test_hashmap_concurrent.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_concurrent_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "test.h"
+#include "hashmap_concurrent.h"
+
+#define CONCURRENT_THREADS 4
+#define CONCURRENT_KEYS 20000   // Keys pushed per writer thread
+#define CONCURRENT_STABLE_KEYS 2000 // Keys readers look up while the map grows under them
+
+// Work shared with the threads of a test
+typedef struct concurrent_test
+{
+    hashmap_concurrent_t* map;  // Map under test
+    int thread_idx;             // Index of the thread, picks its keys
+    atomic_int* writers_done;   // Writers that finished, readers stop when all have
+    atomic_int* failures;       // Operations that went wrong
+}concurrent_test_t;
+
+static int values[CONCURRENT_THREADS][CONCURRENT_KEYS];
+static int stable_values[CONCURRENT_STABLE_KEYS];
+
+
+/**
+ * @brief Pushes the thread's keys, checking each can be read back, then deletes every other one
+ * 
+ * @param arg - concurrent_test_t of the thread
+ * @return void* - NULL
+ */
+static void* writer_thread(void* arg)
+{
+    concurrent_test_t* test = (concurrent_test_t *)arg;
+    char key[32];
+
+    for(int i = 0; i < CONCURRENT_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "t%d-%d", test->thread_idx, i);
+
+        if(hashmap_concurrent_push(test->map, key, &values[test->thread_idx][i]) != SUCCESS ||
+           hashmap_concurrent_get(test->map, key) != &values[test->thread_idx][i])
+        {
+            atomic_fetch_add(test->failures, 1);
+        }
+    }
+
+    for(int i = 0; i < CONCURRENT_KEYS; i += 2)
+    {
+        snprintf(key, sizeof(key), "t%d-%d", test->thread_idx, i);
+
+        if(hashmap_concurrent_delete(test->map, key, NULL) != SUCCESS) atomic_fetch_add(test->failures, 1);
+    }
+
+    if(test->writers_done != NULL) atomic_fetch_add(test->writers_done, 1);
+
+    return NULL;
+}
+
+/**
+ * @brief Looks up the stable keys until every writer finished
+ * 
+ * @param arg - concurrent_test_t of the thread
+ * @return void* - NULL
+ */
+static void* reader_thread(void* arg)
+{
+    concurrent_test_t* test = (concurrent_test_t *)arg;
+    char key[32];
+
+    while(atomic_load(test->writers_done) < CONCURRENT_THREADS / 2)
+    {
+        for(int i = 0; i < CONCURRENT_STABLE_KEYS; i++)
+        {
+            snprintf(key, sizeof(key), "stable-%d", i);
+
+            if(hashmap_concurrent_get(test->map, key) != &stable_values[i]) atomic_fetch_add(test->failures, 1);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Checks that every writer's odd keys are in the map and its even keys are not
+ * 
+ * @param map - pointer to the map
+ * @param writer_count - number of writer threads that ran
+ * @return STATUS - SUCCESS or ERROR
+ */
+static STATUS check_writer_keys(hashmap_concurrent_t* map, int writer_count)
+{
+    char key[32];
+
+    for(int thread_idx = 0; thread_idx < writer_count; thread_idx++)
+    {
+        for(int i = 0; i < CONCURRENT_KEYS; i++)
+        {
+            void* expected = (i % 2 == 0) ? NULL : &values[thread_idx][i];
+
+            snprintf(key, sizeof(key), "t%d-%d", thread_idx, i);
+
+            if(hashmap_concurrent_get(map, key) != expected) return ERROR;
+        }
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * @brief Test passing duplicate and non existent keys
+ * @details Should fail with HASHMAP_ERR_DUPLICATE and HASHMAP_ERR_NOT_FOUND
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(concurrent_duplicate_and_missing_key_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_concurrent_t* map = hashmap_concurrent_create(20);
+    int value = 0;
+
+    hashmap_concurrent_push(map, "key", &value);
+
+    if(hashmap_concurrent_push(map, "key", &value) != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("hashmap_concurrent_push() did not fail with HASHMAP_ERR_DUPLICATE");
+        error_status = ERROR;
+    }
+
+    if(hashmap_concurrent_get(map, "missing") != NULL || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_concurrent_get() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    if(hashmap_concurrent_delete(map, "missing", NULL) != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_concurrent_delete() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test several threads pushing and deleting at once while the map grows from its smallest size
+ * @details Every push and delete should succeed and the map should end up with exactly the keys left behind
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(concurrent_parallel_writers_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_concurrent_t* map = hashmap_concurrent_create(1);
+    pthread_t threads[CONCURRENT_THREADS];
+    concurrent_test_t tests[CONCURRENT_THREADS];
+    atomic_int failures = 0;
+
+    for(int thread_idx = 0; thread_idx < CONCURRENT_THREADS; thread_idx++)
+    {
+        tests[thread_idx].map = map;
+        tests[thread_idx].thread_idx = thread_idx;
+        tests[thread_idx].writers_done = NULL;
+        tests[thread_idx].failures = &failures;
+        pthread_create(&threads[thread_idx], NULL, writer_thread, &tests[thread_idx]);
+    }
+
+    for(int thread_idx = 0; thread_idx < CONCURRENT_THREADS; thread_idx++)
+    {
+        pthread_join(threads[thread_idx], NULL);
+    }
+
+    if(atomic_load(&failures) != 0)
+    {
+        PRINT_ERR("a push, get or delete failed while other threads were writing");
+        error_status = ERROR;
+    }
+
+    if(hashmap_concurrent_size(map) != CONCURRENT_THREADS * CONCURRENT_KEYS / 2 || hashmap_concurrent_capacity(map) <= 16)
+    {
+        PRINT_ERR("hashmap_concurrent_size() is wrong or the map did not grow");
+        error_status = ERROR;
+    }
+
+    if(check_writer_keys(map, CONCURRENT_THREADS) != SUCCESS)
+    {
+        PRINT_ERR("map does not hold exactly the keys left by the writers");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that readers keep finding every key while writers make the map grow several times
+ * @details Readers must never miss a key that was in the map before they started, even while its bin is moved
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(concurrent_readers_during_resize_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_concurrent_t* map = hashmap_concurrent_create(CONCURRENT_STABLE_KEYS);
+    pthread_t threads[CONCURRENT_THREADS];
+    concurrent_test_t tests[CONCURRENT_THREADS];
+    atomic_int writers_done = 0;
+    atomic_int failures = 0;
+    char key[32];
+
+    for(int i = 0; i < CONCURRENT_STABLE_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "stable-%d", i);
+        hashmap_concurrent_push(map, key, &stable_values[i]);
+    }
+
+    // Half the threads write, the other half read until the writers are done
+    for(int thread_idx = 0; thread_idx < CONCURRENT_THREADS; thread_idx++)
+    {
+        tests[thread_idx].map = map;
+        tests[thread_idx].thread_idx = thread_idx / 2;
+        tests[thread_idx].writers_done = &writers_done;
+        tests[thread_idx].failures = &failures;
+        pthread_create(&threads[thread_idx], NULL, (thread_idx % 2 == 0) ? writer_thread : reader_thread, &tests[thread_idx]);
+    }
+
+    for(int thread_idx = 0; thread_idx < CONCURRENT_THREADS; thread_idx++)
+    {
+        pthread_join(threads[thread_idx], NULL);
+    }
+
+    if(atomic_load(&failures) != 0)
+    {
+        PRINT_ERR("a reader missed a key while the map was growing");
+        error_status = ERROR;
+    }
+
+    if(check_writer_keys(map, CONCURRENT_THREADS / 2) != SUCCESS)
+    {
+        PRINT_ERR("map does not hold exactly the keys left by the writers");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_destroy(map, NULL);
+
+    return error_status;
+}
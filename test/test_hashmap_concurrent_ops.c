@@ -0,0 +1,228 @@
+/**
+ * @file test_hashmap_concurrent_ops.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the atomic value operations of hashmap_concurrent_t
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "test.h"
+#include "hashmap_concurrent.h"
+
+#define OPS_THREADS 4
+#define OPS_ROUNDS 10000    // Increments per thread
+#define OPS_COUNTERS 8      // Keys the increments are spread over
+
+
+/**
+ * @brief Bumps the counters with hashmap_concurrent_fetch_add_u64()
+ * 
+ * @param arg - the map
+ * @return void* - NULL
+ */
+static void* fetch_add_thread(void* arg)
+{
+    hashmap_concurrent_t* map = (hashmap_concurrent_t *)arg;
+    char key[32];
+
+    for(int i = 0; i < OPS_ROUNDS; i++)
+    {
+        snprintf(key, sizeof(key), "counter-%d", i % OPS_COUNTERS);
+        hashmap_concurrent_fetch_add_u64(map, key, 1, NULL);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Bumps the inline integer of "cas" with a compare-and-swap retry loop
+ * 
+ * @param arg - the map
+ * @return void* - NULL
+ */
+static void* cas_thread(void* arg)
+{
+    hashmap_concurrent_t* map = (hashmap_concurrent_t *)arg;
+
+    for(int i = 0; i < OPS_ROUNDS; i++)
+    {
+        void* expected = hashmap_concurrent_get(map, "cas");
+
+        while(hashmap_concurrent_cas_value(map, "cas", &expected, (void *)((uintptr_t)expected + 1)) != SUCCESS);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Adds the int in ctx to the inline integer value, removing the key once it drops to 0
+ * 
+ * @param key - the key
+ * @param value - current value, NULL if the key is missing
+ * @param ctx - pointer to the int to add
+ * @return void* - the new value
+ */
+static void* add_or_remove(const char* key, void* value, void* ctx)
+{
+    (void)key;
+    return (void *)((uintptr_t)value + (uintptr_t)(intptr_t)*(int *)ctx);
+}
+
+/**
+ * @brief Test threads bumping shared counters with hashmap_concurrent_fetch_add_u64()
+ * @details No increment should be lost, counters should be created on first use and readable through
+ * hashmap_concurrent_get()
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(concurrent_fetch_add_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_concurrent_t* map = hashmap_concurrent_create(1);
+    pthread_t threads[OPS_THREADS];
+    uint64_t total = 0;
+    char key[32];
+
+    for(int thread_idx = 0; thread_idx < OPS_THREADS; thread_idx++)
+    {
+        pthread_create(&threads[thread_idx], NULL, fetch_add_thread, map);
+    }
+
+    for(int thread_idx = 0; thread_idx < OPS_THREADS; thread_idx++)
+    {
+        pthread_join(threads[thread_idx], NULL);
+    }
+
+    for(int i = 0; i < OPS_COUNTERS; i++)
+    {
+        uint64_t count = 0;
+
+        snprintf(key, sizeof(key), "counter-%d", i);
+
+        if(hashmap_concurrent_fetch_add_u64(map, key, 0, &count) != SUCCESS)
+        {
+            PRINT_ERR("hashmap_concurrent_fetch_add_u64() failed");
+            error_status = ERROR;
+        }
+
+        total += count;
+    }
+
+    if(total != (uint64_t)OPS_THREADS * OPS_ROUNDS || hashmap_concurrent_size(map) != OPS_COUNTERS)
+    {
+        PRINT_ERR("increments were lost or counters were created twice");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_fetch_add_u64(map, "zero", 0, NULL);
+    hashmap_concurrent_fetch_add_u64(map, "wide", UINT64_C(1) << 32, NULL);
+    hashmap_concurrent_fetch_add_u64(map, "wide", 1, NULL);
+
+    _Atomic uint64_t* zero = (_Atomic uint64_t *)hashmap_concurrent_get(map, "zero");
+    _Atomic uint64_t* wide = (_Atomic uint64_t *)hashmap_concurrent_get(map, "wide");
+
+    // A counter at 0 must still be found, and counts past 32 bits must not wrap
+    if(zero == NULL || atomic_load(zero) != 0 || wide == NULL || atomic_load(wide) != (UINT64_C(1) << 32) + 1)
+    {
+        PRINT_ERR("the counters can't be read through hashmap_concurrent_get()");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_destroy(map, free);
+
+    return error_status;
+}
+
+/**
+ * @brief Test hashmap_concurrent_cas_value() mismatches and a parallel retry loop
+ * @details A stale expected value should fail with HASHMAP_ERR_CONFLICT and be refreshed. No retry loop
+ * increment should be lost.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(concurrent_cas_value_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_concurrent_t* map = hashmap_concurrent_create(16);
+    pthread_t threads[OPS_THREADS];
+    void* expected = (void *)(uintptr_t)5;
+
+    hashmap_concurrent_push(map, "cas", (void *)(uintptr_t)1);
+
+    if(hashmap_concurrent_cas_value(map, "cas", &expected, (void *)(uintptr_t)6) != ERROR ||
+       hashmap_errno() != HASHMAP_ERR_CONFLICT || expected != (void *)(uintptr_t)1)
+    {
+        PRINT_ERR("hashmap_concurrent_cas_value() did not fail with HASHMAP_ERR_CONFLICT");
+        error_status = ERROR;
+    }
+
+    if(hashmap_concurrent_cas_value(map, "missing", &expected, expected) != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_concurrent_cas_value() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    for(int thread_idx = 0; thread_idx < OPS_THREADS; thread_idx++)
+    {
+        pthread_create(&threads[thread_idx], NULL, cas_thread, map);
+    }
+
+    for(int thread_idx = 0; thread_idx < OPS_THREADS; thread_idx++)
+    {
+        pthread_join(threads[thread_idx], NULL);
+    }
+
+    if(hashmap_concurrent_get(map, "cas") != (void *)(uintptr_t)(1 + OPS_THREADS * OPS_ROUNDS))
+    {
+        PRINT_ERR("compare-and-swap increments were lost");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test hashmap_concurrent_compute() inserting, updating and removing a key
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(concurrent_compute_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_concurrent_t* map = hashmap_concurrent_create(16);
+    int add = 2;
+    int subtract = -2;
+
+    hashmap_concurrent_compute(map, "key", add_or_remove, &add);
+    hashmap_concurrent_compute(map, "key", add_or_remove, &add);
+
+    if(hashmap_concurrent_get(map, "key") != (void *)(uintptr_t)4)
+    {
+        PRINT_ERR("hashmap_concurrent_compute() did not insert then update the key");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_compute(map, "key", add_or_remove, &subtract);
+    hashmap_concurrent_compute(map, "key", add_or_remove, &subtract);
+
+    if(hashmap_concurrent_get(map, "key") != NULL || hashmap_errno() != HASHMAP_ERR_NOT_FOUND ||
+       hashmap_concurrent_size(map) != 0)
+    {
+        PRINT_ERR("hashmap_concurrent_compute() did not remove the key when fn returned NULL");
+        error_status = ERROR;
+    }
+
+    hashmap_concurrent_destroy(map, NULL);
+
+    return error_status;
+}
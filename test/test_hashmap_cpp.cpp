@@ -0,0 +1,180 @@
+/**
+ * @file test_hashmap_cpp.cpp
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the chm::hashmap C++ wrapper
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <algorithm>
+#include <execution>
+#include <string>
+
+extern "C" {
+#include "test.h"
+}
+
+#include "hashmap.hpp"
+
+#define CPP_TEST_KEYS 1000
+
+// Counts the live instances, to check the map destroys what it constructs
+struct tracked
+{
+    static inline int live = 0;
+    int number;
+
+    explicit tracked(int n) : number(n) { live++; }
+    tracked(const tracked& other) : number(other.number) { live++; }
+    ~tracked() { live--; }
+};
+
+/**
+ * @brief Test that try_emplace() and insert_or_assign() construct in place and lookups take string_view slices
+ * @details Errors should throw the standard exception, or a chm::error with the library's message for its code
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(cpp_emplace_lookup_test)
+{
+    STATUS error_status = SUCCESS;
+    chm::hashmap<std::string> map(16);
+    const char line[] = "alpha beta gamma";
+    std::string_view words(line);
+
+    map.try_emplace("alpha", 3, 'a');
+    map.try_emplace("beta", "second");
+    map["gamma"] = "third";
+
+    // Slices of the line are not NUL terminated
+    if(map.find(words.substr(0, 5)) == map.end() || map.find(words.substr(0, 5))->second != "aaa" ||
+       !map.contains(words.substr(6, 4)) || map.at(words.substr(11)) != "third" || map.contains(words.substr(0, 4)))
+    {
+        PRINT_ERR("a string_view lookup returned the wrong pair");
+        error_status = ERROR;
+    }
+
+    auto [kept, inserted] = map.try_emplace("beta", "replaced");
+
+    if(inserted || kept->second != "second")
+    {
+        PRINT_ERR("try_emplace() replaced a value");
+        error_status = ERROR;
+    }
+
+    if(map.insert_or_assign("beta", "replaced").second || map.at("beta") != "replaced" ||
+       !map.insert_or_assign("delta", "fourth").second || map.size() != 4)
+    {
+        PRINT_ERR("insert_or_assign() did not assign or insert");
+        error_status = ERROR;
+    }
+
+    if(map.erase("alpha") != 1 || map.erase("alpha") != 0 || map.contains("alpha") || map.size() != 3)
+    {
+        PRINT_ERR("erase() did not remove the pair");
+        error_status = ERROR;
+    }
+
+    try
+    {
+        map.at("missing");
+        PRINT_ERR("at() did not throw for a missing key");
+        error_status = ERROR;
+    }
+    catch(const std::out_of_range&)
+    {
+    }
+
+    try
+    {
+        chm::hashmap<int> empty(0);
+        PRINT_ERR("a map with no buckets was created");
+        error_status = ERROR;
+    }
+    catch(const chm::error& e)
+    {
+        if(e.code() != HASHMAP_ERR_INVALID_CAPACITY || std::string(e.what()) != "INVALID CAPACITY")
+        {
+            PRINT_ERR("chm::error does not describe its code");
+            error_status = ERROR;
+        }
+    }
+
+    // Every code gets its own message, shared with the C API
+    if(std::string(chm::error(HASHMAP_ERR_DUPLICATE).what()) != hashmap_err_str(HASHMAP_ERR_DUPLICATE) ||
+       std::string(chm::error(HASHMAP_ERR_IO).what()) == std::string(chm::error(HASHMAP_ERR_CONFLICT).what()))
+    {
+        PRINT_ERR("chm::error messages don't match hashmap_err_str()");
+        error_status = ERROR;
+    }
+
+    return error_status;
+}
+
+/**
+ * @brief Test that iterators visit every pair, also with a parallel algorithm, and that moves keep ownership
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(cpp_iterator_move_test)
+{
+    STATUS error_status = SUCCESS;
+
+    {
+        chm::hashmap<tracked> map(64);
+        long long expected = 0;
+        long long sum = 0;
+
+        for(int i = 0; i < CPP_TEST_KEYS; i++)
+        {
+            map.try_emplace(std::to_string(i), i);
+            expected += i;
+        }
+
+        for(const auto& [key, value] : map)
+        {
+            if(std::stoi(std::string(key)) != value.number) error_status = ERROR;
+            sum += value.number;
+        }
+
+        if(error_status == ERROR || sum != expected)
+        {
+            PRINT_ERR("range-for did not visit every pair once");
+            error_status = ERROR;
+        }
+
+        std::for_each(std::execution::par, map.begin(), map.end(), [](auto& pair) { pair.second.number *= 2; });
+
+        if(std::count_if(map.cbegin(), map.cend(), [](const auto& pair) { return pair.second.number % 2 != 0; }) != 0)
+        {
+            PRINT_ERR("a parallel for_each() missed pairs");
+            error_status = ERROR;
+        }
+
+        // Iterators from a lookup keep walking from where the key is
+        if(std::distance(map.find("0"), map.end()) < 1)
+        {
+            PRINT_ERR("an iterator from find() could not be advanced");
+            error_status = ERROR;
+        }
+
+        chm::hashmap<tracked> moved(std::move(map));
+
+        if(moved.size() != CPP_TEST_KEYS || map.size() != 0 || tracked::live != CPP_TEST_KEYS)
+        {
+            PRINT_ERR("moving the map did not move ownership");
+            error_status = ERROR;
+        }
+    }
+
+    if(tracked::live != 0)
+    {
+        PRINT_ERR("the map did not destroy its values");
+        error_status = ERROR;
+    }
+
+    return error_status;
+}
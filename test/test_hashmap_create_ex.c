@@ -0,0 +1,108 @@
+/**
+ * @file test_hashmap_create_ex.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_create_ex() function
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+
+
+/**
+ * @brief Test creating a map backed by huge pages with hashmap_create_ex()
+ * @details The map should behave exactly like one from hashmap_create() and errno should be HASHMAP_ERR_NONE
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(create_ex_hugepage_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_HUGEPAGE | HASHMAP_FLAG_NUMA_INTERLEAVE, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(1000, &config);
+    int* value = (int *)malloc(sizeof(int));
+
+    if(map == NULL)
+    {
+        PRINT_ERR("map is null");
+        free(value);
+        return ERROR;
+    }
+
+    if(hashmap_errno() != HASHMAP_ERR_NONE)
+    {
+        PRINT_ERR("errno is not HASHMAP_ERR_NONE");
+        error_status = ERROR;
+    }
+
+    if(hashmap_push(map, "key", value) != SUCCESS || hashmap_get(map, "key") != (void *)value)
+    {
+        PRINT_ERR("hashmap_get() did not return the pushed value");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, free);
+
+    return error_status;
+}
+
+/**
+ * @brief Test passing conflicting NUMA flags to hashmap_create_ex()
+ * @details Binding and interleaving can't both apply. Should return NULL and errno should be HASHMAP_ERR_INVALID_CONFIG
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(create_ex_conflicting_numa_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_NUMA_BIND | HASHMAP_FLAG_NUMA_INTERLEAVE, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(20, &config);
+
+    if(map != NULL)
+    {
+        PRINT_ERR("map is not null");
+        error_status = ERROR;
+    }
+
+    if(hashmap_errno() != HASHMAP_ERR_INVALID_CONFIG)
+    {
+        PRINT_ERR("errno is not HASHMAP_ERR_INVALID_CONFIG");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test binding to an invalid NUMA node with hashmap_create_ex()
+ * @details Should return NULL and errno should be HASHMAP_ERR_INVALID_CONFIG
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(create_ex_invalid_numa_node_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_NUMA_BIND, -1, NULL };
+    hashmap_t* map = hashmap_create_ex(20, &config);
+
+    if(map != NULL)
+    {
+        PRINT_ERR("map is not null");
+        error_status = ERROR;
+    }
+
+    if(hashmap_errno() != HASHMAP_ERR_INVALID_CONFIG)
+    {
+        PRINT_ERR("errno is not HASHMAP_ERR_INVALID_CONFIG");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file test_hashmap_foreach.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_foreach() library function
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+
+
+/**
+ * @brief Adds each value to the total in ctx
+ * 
+ * @param key - key of the pair
+ * @param value - pointer to an int
+ * @param ctx - pointer to the total
+ */
+static void sum_values(const char* key, void* value, void* ctx)
+{
+    (void)key;
+    *(int *)ctx += *(int *)value;
+}
+
+/**
+ * @brief Test that hashmap_foreach() visits every key once, including keys in sorted buckets
+ * @details The map has fewer buckets than keys so some buckets hold more than a linked list's worth
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(foreach_visits_every_key_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(4);
+    static int values[100];
+    char key[32];
+    int total = 0;
+
+    for(int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    if(hashmap_foreach(map, sum_values, &total) != SUCCESS || total != 99 * 100 / 2)
+    {
+        PRINT_ERR("hashmap_foreach() did not visit every value once");
+        error_status = ERROR;
+    }
+
+    if(hashmap_foreach(map, NULL, NULL) != ERROR || hashmap_errno() != HASHMAP_ERR_NULL_ARG)
+    {
+        PRINT_ERR("hashmap_foreach() did not fail with HASHMAP_ERR_NULL_ARG");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that hashmap_iter_next() returns every value once, resumes from hashmap_iter_seek() and that
+ * hashmap_get_n() finds keys that are not NUL terminated
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(iter_next_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_MULTI, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(4, &config);
+    static int values[100];
+    hashmap_iter_t iter = {0};
+    const char* key_found = NULL;
+    void* value = NULL;
+    char key[32];
+    int total = 0;
+    int after = 0;
+
+    for(int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        snprintf(key, sizeof(key), "key-%d", i % 50);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    while(hashmap_iter_next(map, &iter, &key_found, &value) == SUCCESS) total += *(int *)value;
+
+    if(total != 99 * 100 / 2 || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_iter_next() did not return every value once");
+        error_status = ERROR;
+    }
+
+    // key-7 has a second value, which comes right after the seek
+    if(hashmap_iter_seek(map, "key-7 and more", 5, &iter) != SUCCESS ||
+       hashmap_iter_next(map, &iter, &key_found, &value) != SUCCESS || strcmp(key_found, "key-7") != 0 || *(int *)value != 57)
+    {
+        PRINT_ERR("hashmap_iter_seek() did not resume at the key");
+        error_status = ERROR;
+    }
+
+    while(hashmap_iter_next(map, &iter, NULL, NULL) == SUCCESS) after++;
+
+    if(after >= 100 || hashmap_get_n(map, "key-42!", 6) != &values[42] || hashmap_get_n(map, "key-4\0002", 7) != NULL ||
+       hashmap_get_n(map, "key-", 4) != NULL)
+    {
+        PRINT_ERR("hashmap_get_n() returned the wrong value");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
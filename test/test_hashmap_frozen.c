@@ -0,0 +1,157 @@
+/**
+ * @file test_hashmap_frozen.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for hashmap_freeze() and the frozen hashmap
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+#include "hashmap_frozen.h"
+
+#define FROZEN_TEST_KEYS 5000
+
+/**
+ * @brief Test freezing a map and looking up every key
+ * @details The frozen map must find every key, miss keys that were never pushed, and keep working after the
+ * source map is destroyed
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(frozen_lookup_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1024);
+    hashmap_frozen_t* frozen = NULL;
+    static int values[FROZEN_TEST_KEYS];
+    char key[32];
+
+    for(int i = 0; i < FROZEN_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "route-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    frozen = hashmap_freeze(map);
+    hashmap_destroy(map, NULL);
+
+    if(frozen == NULL || hashmap_frozen_size(frozen) != FROZEN_TEST_KEYS)
+    {
+        PRINT_ERR("hashmap_freeze() failed");
+        hashmap_frozen_destroy(frozen, NULL);
+        return ERROR;
+    }
+
+    for(int i = 0; i < FROZEN_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "route-%d", i);
+
+        if(hashmap_frozen_get(frozen, key) != &values[i])
+        {
+            PRINT_ERR("hashmap_frozen_get() returned the wrong value");
+            error_status = ERROR;
+            break;
+        }
+
+        snprintf(key, sizeof(key), "missing-%d", i);
+
+        if(hashmap_frozen_get(frozen, key) != NULL || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+        {
+            PRINT_ERR("hashmap_frozen_get() found a key that was never pushed");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    hashmap_frozen_destroy(frozen, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test freezing maps whose key count is a power of 2, where the slot is just the low bits of the hash
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(frozen_power_of_two_test)
+{
+    STATUS error_status = SUCCESS;
+    static int values[4096];
+    char key[32];
+
+    for(size_t count = 16; count <= 4096 && error_status == SUCCESS; count *= 16)
+    {
+        hashmap_t* map = hashmap_create(count);
+        hashmap_frozen_t* frozen = NULL;
+
+        for(size_t i = 0; i < count; i++)
+        {
+            snprintf(key, sizeof(key), "route-%zu", i);
+            hashmap_push(map, key, &values[i]);
+        }
+
+        frozen = hashmap_freeze(map);
+        hashmap_destroy(map, NULL);
+
+        if(frozen == NULL || hashmap_frozen_size(frozen) != count)
+        {
+            PRINT_ERR("hashmap_freeze() failed for a power of 2 key count");
+            error_status = ERROR;
+        }
+
+        for(size_t i = 0; i < count && frozen != NULL; i++)
+        {
+            snprintf(key, sizeof(key), "route-%zu", i);
+
+            if(hashmap_frozen_get(frozen, key) != &values[i])
+            {
+                PRINT_ERR("hashmap_frozen_get() returned the wrong value");
+                error_status = ERROR;
+                break;
+            }
+        }
+
+        hashmap_frozen_destroy(frozen, NULL);
+    }
+
+    return error_status;
+}
+
+/**
+ * @brief Test freezing an empty map and taking over the values
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(frozen_empty_and_owned_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(8);
+    hashmap_frozen_t* frozen = hashmap_freeze(map);
+
+    if(frozen == NULL || hashmap_frozen_size(frozen) != 0 || hashmap_frozen_get(frozen, "key") != NULL)
+    {
+        PRINT_ERR("frozen empty map is not empty");
+        error_status = ERROR;
+    }
+
+    hashmap_frozen_destroy(frozen, NULL);
+
+    // The frozen map owns the values once the source is destroyed without freeing them
+    hashmap_push(map, "us", strdup("United States"));
+    hashmap_push(map, "fr", strdup("France"));
+    frozen = hashmap_freeze(map);
+    hashmap_destroy(map, NULL);
+
+    if(frozen == NULL || strcmp((char *)hashmap_frozen_get(frozen, "fr"), "France") != 0)
+    {
+        PRINT_ERR("frozen map lost a value");
+        error_status = ERROR;
+    }
+
+    hashmap_frozen_destroy(frozen, free);
+
+    return error_status;
+}
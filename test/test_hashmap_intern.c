@@ -0,0 +1,182 @@
+/**
+ * @file test_hashmap_intern.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for borrowed keys and the key intern pool
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+#include "hashmap_intern.h"
+
+#define INTERN_TEST_KEYS 100
+
+static const char* stored_keys[2][INTERN_TEST_KEYS];
+static int values[INTERN_TEST_KEYS];
+static int borrowed_mismatches = 0;
+
+/**
+ * @brief Counts the keys that are not the very pointer they were pushed with, which is also the value
+ * 
+ * @param key - stored key
+ * @param value - value of the key
+ * @param ctx - unused
+ */
+static void check_borrowed(const char* key, void* value, void* ctx)
+{
+    (void)ctx;
+    if(key != (const char *)value) borrowed_mismatches++;
+}
+
+/**
+ * @brief Records the stored key pointer of each value
+ * 
+ * @param key - stored key
+ * @param value - element of values
+ * @param ctx - row of stored_keys to fill
+ */
+static void record_key(const char* key, void* value, void* ctx)
+{
+    ((const char **)ctx)[(int *)value - values] = key;
+}
+
+/**
+ * @brief Test that a map with HASHMAP_FLAG_BORROW_KEYS stores the caller's key pointers
+ * @details The keys live in the values and are freed with them, which only works if the map never frees or copies
+ * them, snapshots included
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(borrow_keys_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_BORROW_KEYS, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(8, &config);
+    hashmap_t* snapshot = NULL;
+    char key[32];
+
+    for(int i = 0; i < INTERN_TEST_KEYS; i++)
+    {
+        char* owned = NULL;
+
+        snprintf(key, sizeof(key), "key-%d", i);
+        owned = strdup(key);
+        hashmap_push(map, owned, owned);
+    }
+
+    // Copying segments away from a snapshot has to keep borrowing too
+    snapshot = hashmap_snapshot(map);
+    hashmap_push(map, "static-key", (void *)"static-value");
+    hashmap_foreach(map, check_borrowed, NULL);
+    hashmap_destroy(snapshot, NULL);
+
+    if(borrowed_mismatches != 1 || strcmp((char *)hashmap_get(map, "key-42"), "key-42") != 0)
+    {
+        PRINT_ERR("borrowed keys were copied");
+        error_status = ERROR;
+    }
+
+    hashmap_delete(map, "static-key", NULL);
+
+    for(int i = 0; i < INTERN_TEST_KEYS; i += 2)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_delete(map, key, free);
+    }
+
+    if(hashmap_get(map, "key-42") != NULL || hashmap_get(map, "key-43") == NULL)
+    {
+        PRINT_ERR("wrong keys left after deleting borrowed keys");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, free);
+
+    return error_status;
+}
+
+/**
+ * @brief Test two maps sharing an intern pool
+ * @details Both maps should store the same pooled pointer for each key, and a string should only leave the pool
+ * once neither map holds it
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(intern_pool_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_intern_t* pool = hashmap_intern_create();
+    hashmap_config_t config = { HASHMAP_FLAG_NONE, 0, pool };
+    hashmap_t* maps[2] = { hashmap_create_ex(16, &config), hashmap_create_ex(64, &config) };
+    char key[32];
+
+    for(int i = 0; i < INTERN_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(maps[0], key, &values[i]);
+        hashmap_push(maps[1], key, &values[i]);
+    }
+
+    hashmap_foreach(maps[0], record_key, stored_keys[0]);
+    hashmap_foreach(maps[1], record_key, stored_keys[1]);
+
+    if(hashmap_intern_size(pool) != INTERN_TEST_KEYS || memcmp(stored_keys[0], stored_keys[1], sizeof(stored_keys[0])) != 0)
+    {
+        PRINT_ERR("maps sharing a pool hold separate copies of their keys");
+        error_status = ERROR;
+    }
+
+    hashmap_delete(maps[0], "key-0", NULL);
+
+    if(hashmap_intern_size(pool) != INTERN_TEST_KEYS || hashmap_get(maps[1], "key-0") != &values[0])
+    {
+        PRINT_ERR("a key still used by another map left the pool");
+        error_status = ERROR;
+    }
+
+    hashmap_delete(maps[1], "key-0", NULL);
+    hashmap_destroy(maps[0], NULL);
+
+    if(hashmap_intern_size(pool) != INTERN_TEST_KEYS - 1)
+    {
+        PRINT_ERR("released keys stayed in the pool");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(maps[1], NULL);
+
+    if(hashmap_intern_size(pool) != 0)
+    {
+        PRINT_ERR("pool not empty after destroying every map");
+        error_status = ERROR;
+    }
+
+    hashmap_intern_destroy(pool);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that borrowing and interning keys can't be combined
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(intern_invalid_config_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_intern_t* pool = hashmap_intern_create();
+    hashmap_config_t config = { HASHMAP_FLAG_BORROW_KEYS, 0, pool };
+
+    if(hashmap_create_ex(8, &config) != NULL || hashmap_errno() != HASHMAP_ERR_INVALID_CONFIG)
+    {
+        PRINT_ERR("hashmap_create_ex() accepted borrowed and interned keys together");
+        error_status = ERROR;
+    }
+
+    hashmap_intern_destroy(pool);
+
+    return error_status;
+}
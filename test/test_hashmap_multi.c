@@ -0,0 +1,160 @@
+/**
+ * @file test_hashmap_multi.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for maps created with HASHMAP_FLAG_MULTI
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+#include "hashmap_frozen.h"
+
+#define MULTI_TEST_VALUES 20
+
+static int foreach_count = 0;
+
+/**
+ * @brief Counts the key-value pairs visited
+ * 
+ * @param key - the key
+ * @param value - the value
+ * @param ctx - unused
+ */
+static void count_pairs(const char* key, void* value, void* ctx)
+{
+    (void)key;
+    (void)value;
+    (void)ctx;
+    foreach_count++;
+}
+
+/**
+ * @brief Test pushing several values under one key and reading them back in order
+ * @details A snapshot taken halfway must keep the values it saw while the map keeps appending
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(multi_get_all_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_MULTI, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(8, &config);
+    hashmap_t* snapshot = NULL;
+    static int values[MULTI_TEST_VALUES];
+    void* const* found = NULL;
+    size_t count = 0;
+
+    for(int i = 0; i < MULTI_TEST_VALUES; i++)
+    {
+        if(i == MULTI_TEST_VALUES / 2) snapshot = hashmap_snapshot(map);
+
+        if(hashmap_push(map, "tag", &values[i]) != SUCCESS)
+        {
+            PRINT_ERR("hashmap_push() rejected another value for a key");
+            error_status = ERROR;
+        }
+    }
+
+    hashmap_push(map, "other", &values[0]);
+
+    if(hashmap_get_all(map, "tag", &found, &count) != SUCCESS || count != MULTI_TEST_VALUES)
+    {
+        PRINT_ERR("hashmap_get_all() returned the wrong number of values");
+        error_status = ERROR;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if(found[i] != &values[i])
+        {
+            PRINT_ERR("hashmap_get_all() returned the values out of order");
+            error_status = ERROR;
+        }
+    }
+
+    if(hashmap_get_all(snapshot, "tag", &found, &count) != SUCCESS || count != MULTI_TEST_VALUES / 2)
+    {
+        PRINT_ERR("snapshot saw values pushed after it was taken");
+        error_status = ERROR;
+    }
+
+    hashmap_foreach(map, count_pairs, NULL);
+
+    if(foreach_count != MULTI_TEST_VALUES + 1 || hashmap_get(map, "tag") != &values[0])
+    {
+        PRINT_ERR("hashmap_foreach() or hashmap_get() wrong for a multimap");
+        error_status = ERROR;
+    }
+
+    if(hashmap_get_all(map, "missing", &found, &count) != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND || count != 0)
+    {
+        PRINT_ERR("hashmap_get_all() found a missing key");
+        error_status = ERROR;
+    }
+
+    if(hashmap_freeze(map) != NULL || hashmap_errno() != HASHMAP_ERR_INVALID_CONFIG)
+    {
+        PRINT_ERR("hashmap_freeze() accepted a multimap");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(snapshot, NULL);
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test deleting single values until the key goes away
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(multi_delete_value_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_MULTI, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(8, &config);
+    void* const* found = NULL;
+    size_t count = 0;
+
+    hashmap_push(map, "email", strdup("first"));
+    hashmap_push(map, "email", strdup("second"));
+    hashmap_push(map, "email", strdup("third"));
+    hashmap_get_all(map, "email", &found, &count);
+
+    if(hashmap_delete_value(map, "email", found[1], free) != SUCCESS ||
+       hashmap_get_all(map, "email", &found, &count) != SUCCESS || count != 2 || strcmp((char *)found[1], "third") != 0)
+    {
+        PRINT_ERR("hashmap_delete_value() did not remove just the one value");
+        error_status = ERROR;
+    }
+
+    if(hashmap_delete_value(map, "email", &count, free) != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_delete_value() deleted a value the key doesn't have");
+        error_status = ERROR;
+    }
+
+    hashmap_delete_value(map, "email", found[0], free);
+    hashmap_get_all(map, "email", &found, &count);
+    hashmap_delete_value(map, "email", found[0], free);
+
+    if(hashmap_get(map, "email") != NULL || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("deleting the last value left the key behind");
+        error_status = ERROR;
+    }
+
+    // Deleting the whole key frees every value
+    hashmap_push(map, "email", strdup("first"));
+    hashmap_push(map, "email", strdup("second"));
+    hashmap_delete(map, "email", free);
+    hashmap_push(map, "email", strdup("left for destroy"));
+    hashmap_push(map, "email", strdup("also left for destroy"));
+    hashmap_destroy(map, free);
+
+    return error_status;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file test_hashmap_ordered.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for maps created with HASHMAP_FLAG_ORDERED
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+
+#define ORDERED_TEST_KEYS 2000
+
+// Keys collected by a scan, in the order they were visited
+typedef struct scan_result
+{
+    char keys[ORDERED_TEST_KEYS][MAX_STRING];
+    size_t count;
+}scan_result_t;
+
+// Key pointers handed out by a scan, in the order they were visited
+typedef struct pointer_result
+{
+    const char* keys[ORDERED_TEST_KEYS];
+    size_t count;
+}pointer_result_t;
+
+static int value = 1;
+
+/**
+ * @brief Records each key visited by a scan
+ * 
+ * @param key - the key
+ * @param val - unused
+ * @param ctx - the scan_result_t
+ */
+static void collect_key(const char* key, void* val, void* ctx)
+{
+    scan_result_t* result = (scan_result_t *)ctx;
+
+    (void)val;
+    if(result->count < ORDERED_TEST_KEYS) strcpy(result->keys[result->count++], key);
+}
+
+/**
+ * @brief qsort() comparator for an array of strings
+ * 
+ * @param a - pointer to the first string
+ * @param b - pointer to the second string
+ * @return int
+ */
+static int compare_keys(const void* a, const void* b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+/**
+ * @brief Test that prefix scans return exactly the keys with the prefix, in order, as keys come and go
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(ordered_prefix_scan_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_ORDERED, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(64, &config);
+    static scan_result_t result;
+    char key[MAX_STRING];
+
+    for(int tenant = 0; tenant < 50; tenant++)
+    {
+        for(int item = 0; item < 20; item++)
+        {
+            snprintf(key, sizeof(key), "tenant%d/item%02d", tenant, item);
+            hashmap_push(map, key, &value);
+        }
+    }
+
+    // tenant4/ must not pick up tenant40/ to tenant49/
+    result.count = 0;
+    hashmap_delete(map, "tenant4/item07", NULL);
+
+    if(hashmap_prefix_scan(map, "tenant4/", collect_key, &result) != SUCCESS || result.count != 19)
+    {
+        PRINT_ERR("hashmap_prefix_scan() returned the wrong number of keys");
+        error_status = ERROR;
+    }
+
+    for(size_t i = 0; i < result.count; i++)
+    {
+        if(strncmp(result.keys[i], "tenant4/", 8) != 0 || (i > 0 && strcmp(result.keys[i - 1], result.keys[i]) >= 0))
+        {
+            PRINT_ERR("hashmap_prefix_scan() returned a wrong or unordered key");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    result.count = 0;
+    hashmap_prefix_scan(map, "tenant99", collect_key, &result);
+    hashmap_prefix_scan(map, "tenant4/item07", collect_key, &result);
+
+    if(result.count != 0)
+    {
+        PRINT_ERR("hashmap_prefix_scan() found keys that aren't in the map");
+        error_status = ERROR;
+    }
+
+    hashmap_clear(map, NULL);
+    hashmap_prefix_scan(map, "", collect_key, &result);
+
+    if(result.count != 0)
+    {
+        PRINT_ERR("hashmap_prefix_scan() found keys after hashmap_clear()");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test range scans against a sorted copy of the keys, for bounds that are and aren't keys
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(ordered_range_scan_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_ORDERED, 0, NULL };
+    hashmap_t* map = hashmap_create_ex(256, &config);
+    hashmap_t* snapshot = NULL;
+    static char sorted[ORDERED_TEST_KEYS][MAX_STRING];
+    static scan_result_t result;
+    const char* bounds[][2] = { { NULL, NULL }, { "k", "m" }, { sorted[10], sorted[500] }, { "key", NULL }, { NULL, "c" }, { "z", "a" } };
+
+    srand(42);
+
+    for(int i = 0; i < ORDERED_TEST_KEYS; i++)
+    {
+        snprintf(sorted[i], MAX_STRING, "%c%x", 'a' + rand() % 26, (unsigned)rand());
+        hashmap_push(map, sorted[i], &value);
+    }
+
+    qsort(sorted, ORDERED_TEST_KEYS, MAX_STRING, compare_keys);
+
+    for(size_t b = 0; b < sizeof(bounds) / sizeof(bounds[0]); b++)
+    {
+        size_t expected = 0;
+
+        result.count = 0;
+        hashmap_range_scan(map, bounds[b][0], bounds[b][1], collect_key, &result);
+
+        for(size_t i = 0; i < ORDERED_TEST_KEYS; i++)
+        {
+            if(bounds[b][0] != NULL && strcmp(sorted[i], bounds[b][0]) < 0) continue;
+            if(bounds[b][1] != NULL && strcmp(sorted[i], bounds[b][1]) >= 0) continue;
+
+            // Skip the duplicates rand() may have made
+            if(i > 0 && strcmp(sorted[i], sorted[i - 1]) == 0) continue;
+
+            if(expected >= result.count || strcmp(result.keys[expected], sorted[i]) != 0)
+            {
+                PRINT_ERR("hashmap_range_scan() does not match the sorted keys");
+                error_status = ERROR;
+                break;
+            }
+
+            expected++;
+        }
+
+        if(expected != result.count)
+        {
+            PRINT_ERR("hashmap_range_scan() returned extra keys");
+            error_status = ERROR;
+        }
+    }
+
+    snapshot = hashmap_snapshot(map);
+
+    if(hashmap_range_scan(snapshot, NULL, NULL, collect_key, &result) != ERROR || hashmap_errno() != HASHMAP_ERR_INVALID_CONFIG)
+    {
+        PRINT_ERR("hashmap_range_scan() worked on a map without an index");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(snapshot, NULL);
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Records the pointer of each key visited by a scan
+ * 
+ * @param key - the key
+ * @param val - unused
+ * @param ctx - the pointer_result_t
+ */
+static void collect_pointer(const char* key, void* val, void* ctx)
+{
+    pointer_result_t* pointers = (pointer_result_t *)ctx;
+
+    (void)val;
+    if(pointers->count < ORDERED_TEST_KEYS) pointers->keys[pointers->count++] = key;
+}
+
+/**
+ * @brief Test that the index uses the map's stored keys, and follows them when a snapshot makes the map copy them
+ * @details A map with HASHMAP_FLAG_BORROW_KEYS should scan out the caller's own pointers. A map that copies keys
+ * should still scan every key after reseeding copies its segments away from a snapshot and the snapshot is freed.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(ordered_shared_keys_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t borrow_config = { HASHMAP_FLAG_ORDERED | HASHMAP_FLAG_BORROW_KEYS, 0, NULL };
+    hashmap_config_t config = { HASHMAP_FLAG_ORDERED, 0, NULL };
+    hashmap_t* borrowed = hashmap_create_ex(256, &borrow_config);
+    hashmap_t* map = hashmap_create_ex(256, &config);
+    hashmap_t* snapshot = NULL;
+    static char keys[ORDERED_TEST_KEYS][MAX_STRING];
+    static pointer_result_t pointers;
+    static scan_result_t result;
+
+    // Zero padded so the order of the keys is the order they are pushed in
+    for(int i = 0; i < ORDERED_TEST_KEYS; i++)
+    {
+        snprintf(keys[i], MAX_STRING, "key-%05d", i);
+        hashmap_push(borrowed, keys[i], &value);
+        hashmap_push(map, keys[i], &value);
+    }
+
+    pointers.count = 0;
+    hashmap_range_scan(borrowed, NULL, NULL, collect_pointer, &pointers);
+
+    for(int i = 0; i < ORDERED_TEST_KEYS; i++)
+    {
+        if(pointers.count != ORDERED_TEST_KEYS || pointers.keys[i] != keys[i])
+        {
+            PRINT_ERR("the index did not hand out the borrowed keys");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    snapshot = hashmap_snapshot(map);
+    hashmap_set_seed(map, 42);
+    hashmap_destroy(snapshot, NULL);
+
+    result.count = 0;
+    hashmap_range_scan(map, NULL, NULL, collect_key, &result);
+
+    for(int i = 0; i < ORDERED_TEST_KEYS; i++)
+    {
+        if(result.count != ORDERED_TEST_KEYS || strcmp(result.keys[i], keys[i]) != 0)
+        {
+            PRINT_ERR("the index lost keys copied away from a snapshot");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    hashmap_destroy(borrowed, NULL);
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
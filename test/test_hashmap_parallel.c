@@ -0,0 +1,338 @@
+/**
+ * @file test_hashmap_parallel.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the parallel bulk operations and the deferred destroy
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "test.h"
+
+#define PARALLEL_KEYS 50000
+#define PARALLEL_THREADS 4
+#define CHURN_VALUE 1000000   // Value of the key parallel_clear_churn_test empties and refills
+
+static atomic_long freed_sum;       // Sum of the values passed to counting_free()
+static atomic_long visited_sum;     // Sum of the values passed to counting_visit()
+static atomic_int executor_tasks;   // Tasks run by thread_executor()
+
+// Task handed to thread_executor()
+typedef struct executor_task
+{
+    hashmap_task_fn_t fn;   // Function to run
+    void* arg;              // Passed to fn
+}executor_task_t;
+
+/**
+ * @brief Frees a value and adds it to freed_sum, called from several threads at once
+ * 
+ * @param value - a malloc'd long
+ */
+static void counting_free(void* value)
+{
+    atomic_fetch_add(&freed_sum, *(long *)value);
+    free(value);
+}
+
+/**
+ * @brief Adds a value to visited_sum, called from several threads at once
+ * 
+ * @param key - unused
+ * @param value - a long
+ * @param ctx - unused
+ */
+static void counting_visit(const char* key, void* value, void* ctx)
+{
+    (void)key;
+    (void)ctx;
+    atomic_fetch_add(&visited_sum, *(long *)value);
+}
+
+/**
+ * @brief Runs a task of the library
+ * 
+ * @param arg - the executor_task_t, freed here
+ * @return void* - NULL
+ */
+static void* executor_thread(void* arg)
+{
+    executor_task_t* task = (executor_task_t *)arg;
+
+    task->fn(task->arg);
+    free(task);
+
+    return NULL;
+}
+
+/**
+ * @brief Executor that starts a detached thread per task, standing in for a caller's own thread pool
+ * 
+ * @param fn - task to run
+ * @param arg - its argument
+ * @param ctx - unused
+ */
+static void thread_executor(hashmap_task_fn_t fn, void* arg, void* ctx)
+{
+    executor_task_t* task = (executor_task_t *)malloc(sizeof(executor_task_t));
+    pthread_t thread;
+
+    (void)ctx;
+    atomic_fetch_add(&executor_tasks, 1);
+
+    task->fn = fn;
+    task->arg = arg;
+
+    // Without a thread the task runs here, the library waits for it either way
+    if(pthread_create(&thread, NULL, executor_thread, task) != 0) executor_thread(task);
+    else pthread_detach(thread);
+}
+
+/**
+ * @brief Fills a map with PARALLEL_KEYS malloc'd longs holding 0 to PARALLEL_KEYS - 1
+ * 
+ * @param map - the map
+ * @return long - sum of the values, -1 on failure
+ */
+static long fill_map(hashmap_t* map)
+{
+    char key[MAX_STRING];
+    long sum = 0;
+
+    for(long i = 0; i < PARALLEL_KEYS; i++)
+    {
+        long* value = (long *)malloc(sizeof(long));
+
+        *value = i;
+        snprintf(key, sizeof(key), "key-%ld", i);
+
+        if(hashmap_push(map, key, value) == ERROR)
+        {
+            free(value);
+            return -1;
+        }
+
+        sum += i;
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Test that the parallel reserve keeps every key and that foreach and stats agree with the serial versions
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(parallel_reserve_foreach_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1024);
+    hashmap_parallel_t parallel = { PARALLEL_THREADS, NULL, NULL };
+    hashmap_stats_t serial;
+    hashmap_stats_t split;
+    char key[MAX_STRING];
+    long sum = fill_map(map);
+
+    if(sum < 0 || hashmap_reserve_parallel(map, 1 << 17, &parallel) == ERROR)
+    {
+        PRINT_ERR("could not fill and grow the map");
+        hashmap_destroy(map, free);
+        return ERROR;
+    }
+
+    for(long i = 0; i < PARALLEL_KEYS; i++)
+    {
+        long* value = NULL;
+
+        snprintf(key, sizeof(key), "key-%ld", i);
+        value = (long *)hashmap_get(map, key);
+
+        if(value == NULL || *value != i)
+        {
+            PRINT_ERR("a key was lost growing the map");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    atomic_store(&visited_sum, 0);
+
+    if(hashmap_foreach_parallel(map, counting_visit, NULL, NULL) == ERROR || atomic_load(&visited_sum) != sum)
+    {
+        PRINT_ERR("hashmap_foreach_parallel() did not visit every pair once");
+        error_status = ERROR;
+    }
+
+    if(hashmap_stats(map, &serial) == ERROR || hashmap_stats_parallel(map, &split, &parallel) == ERROR ||
+       serial.size != split.size || serial.capacity != split.capacity ||
+       serial.used_buckets != split.used_buckets || serial.max_chain != split.max_chain)
+    {
+        PRINT_ERR("hashmap_stats_parallel() disagrees with hashmap_stats()");
+        error_status = ERROR;
+    }
+
+    // Pushing again after the rebuild finds the buckets consistent
+    if(hashmap_push(map, "key-0", &sum) != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("a key moved by the rebuild could be pushed twice");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, free);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that the parallel clear and destroy free every value once, through the pool and through an executor
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(parallel_clear_destroy_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1 << 16);
+    hashmap_parallel_t executor = { PARALLEL_THREADS, thread_executor, NULL };
+    hashmap_t* snapshot = NULL;
+    long sum = fill_map(map);
+
+    atomic_store(&freed_sum, 0);
+
+    if(sum < 0 || hashmap_clear_parallel(map, counting_free, NULL) == ERROR || atomic_load(&freed_sum) != sum ||
+       hashmap_size(map) != 0 || hashmap_get(map, "key-1") != NULL)
+    {
+        PRINT_ERR("hashmap_clear_parallel() did not free every value once");
+        error_status = ERROR;
+    }
+
+    // The map shares its buckets with the snapshot, which keeps its pairs after the clear. Only the keys are looked at.
+    sum = fill_map(map);
+    snapshot = hashmap_snapshot(map);
+    atomic_store(&freed_sum, 0);
+
+    if(snapshot == NULL || hashmap_clear_parallel(map, counting_free, NULL) == ERROR || atomic_load(&freed_sum) != sum ||
+       hashmap_get(snapshot, "key-1") == NULL || hashmap_size(map) != 0)
+    {
+        PRINT_ERR("hashmap_clear_parallel() emptied a snapshot");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(snapshot, NULL);
+    hashmap_destroy(map, NULL);
+
+    map = hashmap_create(1 << 16);
+    sum = fill_map(map);
+    atomic_store(&freed_sum, 0);
+    atomic_store(&executor_tasks, 0);
+    hashmap_destroy_parallel(map, counting_free, &executor);
+
+    if(atomic_load(&freed_sum) != sum || atomic_load(&executor_tasks) == 0)
+    {
+        PRINT_ERR("hashmap_destroy_parallel() did not free every value through the executor");
+        error_status = ERROR;
+    }
+
+    return error_status;
+}
+
+/**
+ * @brief Frees a value like counting_free(), holding up the churned value of parallel_clear_churn_test so
+ * workers sharing its bucket would overlap
+ * 
+ * @param value - a malloc'd long
+ */
+static void slow_free(void* value)
+{
+    const struct timespec delay = { 0, 10000000 };
+
+    if(*(long *)value == CHURN_VALUE) nanosleep(&delay, NULL);
+    counting_free(value);
+}
+
+/**
+ * @brief Test that a bucket emptied and refilled many times is swept by one worker only
+ * @details Each time the bucket goes from empty to non-empty it is recorded as dirty again. Pushing other keys in
+ * between spreads the repeats over every worker's slice of the dirty list.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(parallel_clear_churn_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1 << 20);
+    hashmap_parallel_t parallel = { PARALLEL_THREADS, NULL, NULL };
+    char key[MAX_STRING];
+    long sum = CHURN_VALUE;
+    long* value = NULL;
+
+    for(long i = 0; i < 8192; i++)
+    {
+        value = (long *)malloc(sizeof(long));
+        *value = i;
+        snprintf(key, sizeof(key), "key-%ld", i);
+        hashmap_push(map, key, value);
+        sum += i;
+
+        hashmap_push(map, "k", value);
+        hashmap_delete(map, "k", NULL);
+    }
+
+    value = (long *)malloc(sizeof(long));
+    *value = CHURN_VALUE;
+    hashmap_push(map, "k", value);
+    atomic_store(&freed_sum, 0);
+
+    if(hashmap_clear_parallel(map, slow_free, &parallel) == ERROR || atomic_load(&freed_sum) != sum || hashmap_size(map) != 0)
+    {
+        PRINT_ERR("hashmap_clear_parallel() did not free every value exactly once after churn");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that deferred destroys free every value once hashmap_deferred_wait() returns
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(deferred_destroy_test)
+{
+    STATUS error_status = SUCCESS;
+    long sum = 0;
+
+    atomic_store(&freed_sum, 0);
+
+    for(int i = 0; i < 3; i++)
+    {
+        hashmap_t* map = hashmap_create(4096);
+        long filled = fill_map(map);
+
+        if(filled < 0)
+        {
+            PRINT_ERR("could not fill the map");
+            error_status = ERROR;
+        }
+
+        sum += filled;
+        hashmap_destroy_deferred(map, counting_free);
+    }
+
+    hashmap_deferred_wait();
+
+    if(atomic_load(&freed_sum) != sum)
+    {
+        PRINT_ERR("hashmap_deferred_wait() returned before every value was freed");
+        error_status = ERROR;
+    }
+
+    return error_status;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file test_hashmap_prefetch.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for hashmap_prefetch() and buckets holding entries both inline and in overflow nodes
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+
+#define PREFETCH_TEST_KEYS 64
+
+/**
+ * @brief Test that prefetching is only a hint
+ * @details Prefetching present and missing keys should leave the map unchanged, and NULL arguments should set errno.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(prefetch_hint_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(16);
+    int value = 1;
+
+    hashmap_push(map, "present", &value);
+    hashmap_prefetch(map, "present");
+    hashmap_prefetch(map, "missing");
+
+    if(hashmap_errno() != HASHMAP_ERR_NONE || hashmap_get(map, "present") != &value || hashmap_get(map, "missing") != NULL)
+    {
+        PRINT_ERR("hashmap_prefetch() changed the map");
+        error_status = ERROR;
+    }
+
+    hashmap_prefetch(NULL, "present");
+
+    if(hashmap_errno() != HASHMAP_ERR_NULL_ARG)
+    {
+        PRINT_ERR("hashmap_prefetch() did not report a NULL map");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test a single bucket as its inline slots and overflow fill, empty and refill
+ * @details With one bucket every key collides. Deleting every other key leaves holes in the inline slots and
+ * the overflow list that later pushes have to reuse, and a snapshot taken in between must keep its view.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(inline_overflow_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1);
+    hashmap_t* snapshot = NULL;
+    hashmap_stats_t stats;
+    static int values[PREFETCH_TEST_KEYS];
+    char key[32];
+
+    for(int i = 0; i < PREFETCH_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    snapshot = hashmap_snapshot(map);
+
+    for(int i = 0; i < PREFETCH_TEST_KEYS; i += 2)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_delete(map, key, NULL);
+    }
+
+    for(int i = 0; i < PREFETCH_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+
+        if(hashmap_get(map, key) != ((i % 2) ? &values[i] : NULL) || hashmap_get(snapshot, key) != &values[i])
+        {
+            PRINT_ERR("wrong value after deleting every other key");
+            error_status = ERROR;
+        }
+    }
+
+    // Refill the holes, then grow so every entry moves to a new bucket
+    for(int i = 0; i < PREFETCH_TEST_KEYS; i += 2)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    if(hashmap_reserve(map, 4 * PREFETCH_TEST_KEYS) != SUCCESS || hashmap_stats(map, &stats) != SUCCESS || stats.size != PREFETCH_TEST_KEYS)
+    {
+        PRINT_ERR("hashmap_reserve() failed on a refilled bucket");
+        error_status = ERROR;
+    }
+
+    for(int i = 0; i < PREFETCH_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+
+        if(hashmap_get(map, key) != &values[i])
+        {
+            PRINT_ERR("wrong value after refilling and growing");
+            error_status = ERROR;
+        }
+    }
+
+    hashmap_destroy(snapshot, NULL);
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file test_hashmap_seed.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for seeding and the hash flooding defense
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+#include "murmur3.h"
+
+#define FLOOD_CAPACITY 64
+#define FLOOD_KEYS 64
+#define FLOOD_SEED 0x123456789abcdef0ULL
+
+
+/**
+ * @brief Test changing the seed of a map that already holds keys
+ * @details Every key should still be found after hashmap_set_seed() rehashes them, including with SipHash
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(set_seed_rehash_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_config_t config = { HASHMAP_FLAG_SIPHASH, 0, NULL };
+    hashmap_t* maps[2] = { hashmap_create(16), hashmap_create_ex(16, &config) };
+    char key[MAX_STRING] = {0};
+    static int values[100];
+
+    for(int m = 0; m < 2; m++)
+    {
+        for(int i = 0; i < 100; i++)
+        {
+            snprintf(key, MAX_STRING, "key-%d", i);
+            hashmap_push(maps[m], key, &values[i]);
+        }
+
+        hashmap_set_seed(maps[m], FLOOD_SEED);
+
+        if(hashmap_errno() != HASHMAP_ERR_NONE)
+        {
+            PRINT_ERR("errno is not HASHMAP_ERR_NONE");
+            error_status = ERROR;
+        }
+
+        for(int i = 0; i < 100; i++)
+        {
+            snprintf(key, MAX_STRING, "key-%d", i);
+
+            if(hashmap_get(maps[m], key) != &values[i])
+            {
+                PRINT_ERR("key lost after hashmap_set_seed()");
+                error_status = ERROR;
+                break;
+            }
+        }
+
+        hashmap_destroy(maps[m], NULL);
+    }
+
+    return error_status;
+}
+
+/**
+ * @brief Test pushing keys crafted to collide under a known Murmur3 seed
+ * @details The map should notice the long chain, switch to a keyed hash and spread the keys out again. A later
+ * hashmap_set_seed() should bring back Murmur3.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(flooding_defense_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(FLOOD_CAPACITY);
+    hashmap_stats_t stats = {0};
+    char key[MAX_STRING] = {0};
+    int value = 0;
+    int found = 0;
+
+    hashmap_set_seed(map, FLOOD_SEED);
+
+    // Search for keys that all land in bucket 0, the way an attacker who knows the seed would
+    for(unsigned long i = 0; found < FLOOD_KEYS; i++)
+    {
+        uint64_t hash[2] = {0};
+
+        snprintf(key, MAX_STRING, "attack-%lu", i);
+        MurmurHash3_x64_128_seed64(key, (int)strlen(key), FLOOD_SEED, hash);
+
+        if(hash[0] % FLOOD_CAPACITY == 0)
+        {
+            hashmap_push(map, key, &value);
+            found++;
+        }
+    }
+
+    hashmap_stats(map, &stats);
+
+    if(stats.size != FLOOD_KEYS)
+    {
+        PRINT_ERR("keys were lost while defending");
+        error_status = ERROR;
+    }
+
+    if(stats.max_chain >= FLOOD_KEYS / 2)
+    {
+        PRINT_ERR("colliding keys still share one bucket");
+        error_status = ERROR;
+    }
+
+    // Setting the seed again goes back to Murmur3, where the keys collide once more
+    hashmap_set_seed(map, FLOOD_SEED);
+    hashmap_stats(map, &stats);
+
+    if(stats.size != FLOOD_KEYS || stats.max_chain != FLOOD_KEYS)
+    {
+        PRINT_ERR("hashmap_set_seed() did not restore the configured hash");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
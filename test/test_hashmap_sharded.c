@@ -0,0 +1,170 @@
+/**
+ * @file test_hashmap_sharded.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_sharded_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "test.h"
+#include "hashmap_sharded.h"
+
+#define SHARDED_THREADS 4
+#define SHARDED_KEYS 5000   // Counters pushed per thread
+
+// Work of one thread
+typedef struct sharded_test
+{
+    hashmap_sharded_t* map; // Map under test
+    int thread_idx;         // Index of the thread, picks its keys
+    atomic_int* failures;   // Operations that went wrong
+}sharded_test_t;
+
+static long counters[SHARDED_THREADS][SHARDED_KEYS];
+
+
+/**
+ * @brief Pushes the thread's counters and bumps each through hashmap_sharded_get()
+ * 
+ * @param arg - sharded_test_t of the thread
+ * @return void* - NULL
+ */
+static void* counter_thread(void* arg)
+{
+    sharded_test_t* test = (sharded_test_t *)arg;
+    char key[32];
+
+    for(int i = 0; i < SHARDED_KEYS; i++)
+    {
+        long* counter = NULL;
+
+        snprintf(key, sizeof(key), "t%d-%d", test->thread_idx, i);
+        counters[test->thread_idx][i] = 0;
+
+        if(hashmap_sharded_push(test->map, key, &counters[test->thread_idx][i]) != SUCCESS)
+        {
+            atomic_fetch_add(test->failures, 1);
+            continue;
+        }
+
+        counter = (long *)hashmap_sharded_get(test->map, key);
+
+        if(counter == NULL) atomic_fetch_add(test->failures, 1);
+        else *counter += i;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Adds each counter to the total in ctx
+ * 
+ * @param key - key of the pair
+ * @param value - pointer to a long
+ * @param ctx - pointer to the total
+ */
+static void sum_counters(const char* key, void* value, void* ctx)
+{
+    (void)key;
+    *(long *)ctx += *(long *)value;
+}
+
+/**
+ * @brief Test several threads pushing into the shards at once, then totalling them with hashmap_sharded_foreach()
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(sharded_parallel_push_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_sharded_t* map = hashmap_sharded_create(SHARDED_THREADS, 1024);
+    pthread_t threads[SHARDED_THREADS];
+    sharded_test_t tests[SHARDED_THREADS];
+    atomic_int failures = 0;
+    long total = 0;
+
+    for(int thread_idx = 0; thread_idx < SHARDED_THREADS; thread_idx++)
+    {
+        tests[thread_idx].map = map;
+        tests[thread_idx].thread_idx = thread_idx;
+        tests[thread_idx].failures = &failures;
+        pthread_create(&threads[thread_idx], NULL, counter_thread, &tests[thread_idx]);
+    }
+
+    for(int thread_idx = 0; thread_idx < SHARDED_THREADS; thread_idx++)
+    {
+        pthread_join(threads[thread_idx], NULL);
+    }
+
+    if(atomic_load(&failures) != 0 || hashmap_sharded_size(map) != SHARDED_THREADS * SHARDED_KEYS)
+    {
+        PRINT_ERR("a push or get failed while other threads were pushing");
+        error_status = ERROR;
+    }
+
+    if(hashmap_sharded_foreach(map, sum_counters, &total) != SUCCESS ||
+       total != (long)SHARDED_THREADS * (SHARDED_KEYS - 1) * SHARDED_KEYS / 2)
+    {
+        PRINT_ERR("hashmap_sharded_foreach() total is wrong");
+        error_status = ERROR;
+    }
+
+    hashmap_sharded_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test shard count rounding, duplicate keys and non existent keys
+ * @details 3 shards should become 4, errors should come back from the shard's map
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(sharded_errors_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_sharded_t* map = hashmap_sharded_create(3, 16);
+    int value = 0;
+
+    if(hashmap_sharded_shard_count(map) != 4)
+    {
+        PRINT_ERR("shard count was not rounded up to a power of 2");
+        error_status = ERROR;
+    }
+
+    hashmap_sharded_push(map, "key", &value);
+
+    if(hashmap_sharded_push(map, "key", &value) != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("hashmap_sharded_push() did not fail with HASHMAP_ERR_DUPLICATE");
+        error_status = ERROR;
+    }
+
+    if(hashmap_sharded_delete(map, "missing", NULL) != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_sharded_delete() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    if(hashmap_sharded_delete(map, "key", NULL) != SUCCESS || hashmap_sharded_size(map) != 0)
+    {
+        PRINT_ERR("hashmap_sharded_delete() did not remove the key");
+        error_status = ERROR;
+    }
+
+    if(hashmap_sharded_create(0, 0) != NULL || hashmap_errno() != HASHMAP_ERR_INVALID_CAPACITY)
+    {
+        PRINT_ERR("hashmap_sharded_create() did not fail with HASHMAP_ERR_INVALID_CAPACITY");
+        error_status = ERROR;
+    }
+
+    hashmap_sharded_destroy(map, NULL);
+
+    return error_status;
+}
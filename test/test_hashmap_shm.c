@@ -0,0 +1,334 @@
+/**
+ * @file test_hashmap_shm.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_shm_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "test.h"
+#include "hashmap_shm.h"
+
+#define SHM_TEST_BYTES (1 << 20)
+#define SHM_TEST_CHILDREN 4
+#define SHM_TEST_CHILD_KEYS 500
+
+/**
+ * @brief Writes a segment name unique to this process and test
+ * 
+ * @param name - destination, MAX_STRING bytes
+ * @param test - name of the test
+ */
+static void shm_test_name(char* name, const char* test)
+{
+    snprintf(name, MAX_STRING, "/hashmap_%s_%d", test, (int)getpid());
+}
+
+/**
+ * @brief Test that pairs pushed through one mapping are read in place through another, at another address
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(shm_push_get_test)
+{
+    STATUS error_status = SUCCESS;
+    char name[MAX_STRING];
+    hashmap_shm_t* map = NULL;
+    hashmap_shm_t* other = NULL;
+    const int* value = NULL;
+    size_t len = 0;
+    int number = 42;
+
+    shm_test_name(name, "push_get");
+    map = hashmap_shm_create(name, 64, SHM_TEST_BYTES);
+    other = hashmap_shm_open(name);
+
+    if(map == NULL || other == NULL)
+    {
+        PRINT_ERR("could not create and open the segment");
+        if(map != NULL) hashmap_shm_close(map);
+        hashmap_shm_unlink(name);
+        return ERROR;
+    }
+
+    if(hashmap_shm_push(map, "answer", &number, sizeof(number)) == ERROR || hashmap_shm_push(map, "empty", NULL, 0) == ERROR)
+    {
+        PRINT_ERR("hashmap_shm_push() failed");
+        error_status = ERROR;
+    }
+
+    value = (const int *)hashmap_shm_get(other, "answer", &len);
+
+    if(value == NULL || len != sizeof(int) || *value != 42 || hashmap_shm_size(other) != 2)
+    {
+        PRINT_ERR("the other mapping doesn't see the pushed pair");
+        error_status = ERROR;
+    }
+
+    if(hashmap_shm_push(other, "answer", &number, sizeof(number)) != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("hashmap_shm_push() accepted a duplicate key");
+        error_status = ERROR;
+    }
+
+    number = 7;
+    hashmap_shm_set(other, "answer", &number, sizeof(number));
+
+    // The old bytes stay readable, the map hands out the new ones
+    if(value == NULL || *value != 42 || *(const int *)hashmap_shm_get(map, "answer", NULL) != 7 || hashmap_shm_size(map) != 2)
+    {
+        PRINT_ERR("hashmap_shm_set() did not replace the value");
+        error_status = ERROR;
+    }
+
+    if(hashmap_shm_delete(map, "answer") == ERROR || hashmap_shm_get(other, "answer", NULL) != NULL ||
+       hashmap_shm_delete(map, "answer") != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND || hashmap_shm_size(other) != 1)
+    {
+        PRINT_ERR("hashmap_shm_delete() did not remove the key");
+        error_status = ERROR;
+    }
+
+    hashmap_shm_close(other);
+    hashmap_shm_close(map);
+
+    if(hashmap_shm_unlink(name) == ERROR || hashmap_shm_open(name) != NULL || hashmap_errno() != HASHMAP_ERR_IO)
+    {
+        PRINT_ERR("the segment outlived hashmap_shm_unlink()");
+        error_status = ERROR;
+    }
+
+    return error_status;
+}
+
+/**
+ * @brief Test that forked processes pushing into one map all see each other's keys
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(shm_fork_test)
+{
+    STATUS error_status = SUCCESS;
+    char name[MAX_STRING];
+    char key[MAX_STRING];
+    pid_t children[SHM_TEST_CHILDREN];
+    hashmap_shm_t* map = NULL;
+
+    shm_test_name(name, "fork");
+    map = hashmap_shm_create(name, 256, SHM_TEST_BYTES);
+
+    if(map == NULL)
+    {
+        PRINT_ERR("could not create the segment");
+        return ERROR;
+    }
+
+    hashmap_shm_push(map, "parent", "ready", 6);
+
+    for(int child = 0; child < SHM_TEST_CHILDREN; child++)
+    {
+        children[child] = fork();
+
+        if(children[child] == 0)
+        {
+            int failed = hashmap_shm_get(map, "parent", NULL) == NULL;
+
+            for(int i = 0; i < SHM_TEST_CHILD_KEYS; i++)
+            {
+                snprintf(key, sizeof(key), "child-%d-%d", child, i);
+                if(hashmap_shm_push(map, key, &i, sizeof(i)) == ERROR) failed = 1;
+            }
+
+            _exit(failed);
+        }
+    }
+
+    for(int child = 0; child < SHM_TEST_CHILDREN; child++)
+    {
+        int status = 0;
+
+        if(children[child] < 0 || waitpid(children[child], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            PRINT_ERR("a child process failed");
+            error_status = ERROR;
+        }
+    }
+
+    for(int child = 0; child < SHM_TEST_CHILDREN && error_status == SUCCESS; child++)
+    {
+        for(int i = 0; i < SHM_TEST_CHILD_KEYS; i++)
+        {
+            const int* value = NULL;
+
+            snprintf(key, sizeof(key), "child-%d-%d", child, i);
+            value = (const int *)hashmap_shm_get(map, key, NULL);
+
+            if(value == NULL || *value != i)
+            {
+                PRINT_ERR("a key pushed by a child is missing");
+                error_status = ERROR;
+                break;
+            }
+        }
+    }
+
+    if(hashmap_shm_size(map) != SHM_TEST_CHILDREN * SHM_TEST_CHILD_KEYS + 1)
+    {
+        PRINT_ERR("the size doesn't count every child's keys");
+        error_status = ERROR;
+    }
+
+    hashmap_shm_close(map);
+    hashmap_shm_unlink(name);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that a full segment rejects pushes and that the segment name can't be created twice
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(shm_full_test)
+{
+    STATUS error_status = SUCCESS;
+    char name[MAX_STRING];
+    char key[MAX_STRING];
+    hashmap_shm_t* map = NULL;
+    size_t pushed = 0;
+
+    shm_test_name(name, "full");
+    map = hashmap_shm_create(name, 16, 4096);
+
+    if(map == NULL)
+    {
+        PRINT_ERR("could not create the segment");
+        return ERROR;
+    }
+
+    while(pushed < 4096)
+    {
+        snprintf(key, sizeof(key), "key-%zu", pushed);
+        if(hashmap_shm_push(map, key, &pushed, sizeof(pushed)) == ERROR) break;
+        pushed++;
+    }
+
+    if(pushed == 0 || pushed == 4096 || hashmap_errno() != HASHMAP_ERR_ALLOC_FAILED || hashmap_shm_size(map) != pushed ||
+       hashmap_shm_free_bytes(map) >= 4096)
+    {
+        PRINT_ERR("the full segment did not reject the push");
+        error_status = ERROR;
+    }
+
+    if(hashmap_shm_create(name, 16, 4096) != NULL || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("an existing segment was created again");
+        error_status = ERROR;
+    }
+
+    hashmap_shm_close(map);
+    hashmap_shm_unlink(name);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that setting keys over and over, well past the segment size, keeps working by compacting when it fills
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(shm_compact_test)
+{
+    STATUS error_status = SUCCESS;
+    char name[MAX_STRING];
+    char next_name[MAX_STRING];
+    char label[32];
+    char key[MAX_STRING];
+    hashmap_shm_t* map = NULL;
+    hashmap_shm_t* fresh = NULL;
+    const size_t* value = NULL;
+    size_t written = 0;
+    size_t compactions = 0;
+    size_t len = 0;
+
+    shm_test_name(name, "compact_0");
+    map = hashmap_shm_create(name, 16, 4096);
+
+    if(map == NULL)
+    {
+        PRINT_ERR("could not create the segment");
+        return ERROR;
+    }
+
+    // Sixteen keys set round robin write many times the segment's bytes
+    for(size_t round = 0; round < 64 * 4096 / sizeof(size_t) && error_status == SUCCESS; round++)
+    {
+        snprintf(key, sizeof(key), "key-%zu", round % 16);
+
+        if(hashmap_shm_set(map, key, &round, sizeof(round)) == SUCCESS)
+        {
+            written += sizeof(round);
+            continue;
+        }
+
+        if(hashmap_errno() != HASHMAP_ERR_ALLOC_FAILED)
+        {
+            PRINT_ERR("hashmap_shm_set() failed for another reason than a full segment");
+            error_status = ERROR;
+            break;
+        }
+
+        snprintf(label, sizeof(label), "compact_%zu", ++compactions);
+        shm_test_name(next_name, label);
+        fresh = hashmap_shm_compact(map, next_name, 0);
+
+        if(fresh == NULL || hashmap_shm_size(fresh) != hashmap_shm_size(map) || hashmap_shm_free_bytes(fresh) <= hashmap_shm_free_bytes(map))
+        {
+            PRINT_ERR("hashmap_shm_compact() did not move the live pairs into a roomier segment");
+            error_status = ERROR;
+            break;
+        }
+
+        if(hashmap_shm_set(map, key, &round, sizeof(round)) != ERROR || hashmap_errno() != HASHMAP_ERR_READ_ONLY)
+        {
+            PRINT_ERR("the compacted segment still took a write");
+            error_status = ERROR;
+        }
+
+        hashmap_shm_close(map);
+        hashmap_shm_unlink(name);
+        map = fresh;
+        strcpy(name, next_name);
+        round--;
+    }
+
+    if(error_status == SUCCESS && (compactions == 0 || written <= 4096 || hashmap_shm_size(map) != 16))
+    {
+        PRINT_ERR("the sets never outgrew the segment");
+        error_status = ERROR;
+    }
+
+    for(size_t idx = 0; idx < 16 && error_status == SUCCESS; idx++)
+    {
+        snprintf(key, sizeof(key), "key-%zu", idx);
+        value = (const size_t *)hashmap_shm_get(map, key, &len);
+
+        if(value == NULL || len != sizeof(size_t) || *value != 64 * 4096 / sizeof(size_t) - 16 + idx)
+        {
+            PRINT_ERR("a pair lost its last value across compactions");
+            error_status = ERROR;
+        }
+    }
+
+    hashmap_shm_close(map);
+    hashmap_shm_unlink(name);
+
+    return error_status;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_hashmap_snapshot.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_snapshot() library function
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+
+
+/**
+ * @brief Test that a snapshot keeps its view while the map is modified
+ * @details Keys pushed or deleted after hashmap_snapshot() should only be visible through the live map
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(snapshot_consistent_view_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(20);
+    hashmap_t* snapshot = NULL;
+    int values[3] = {1, 2, 3};
+
+    hashmap_push(map, "one", &values[0]);
+    hashmap_push(map, "two", &values[1]);
+
+    snapshot = hashmap_snapshot(map);
+
+    if(snapshot == NULL)
+    {
+        PRINT_ERR("hashmap_snapshot() returned NULL");
+        hashmap_destroy(map, NULL);
+        return ERROR;
+    }
+
+    hashmap_push(map, "three", &values[2]);
+    hashmap_delete(map, "one", NULL);
+
+    if(hashmap_get(snapshot, "one") != &values[0] || hashmap_get(snapshot, "two") != &values[1])
+    {
+        PRINT_ERR("snapshot lost a key that existed when it was taken");
+        error_status = ERROR;
+    }
+
+    if(hashmap_get(snapshot, "three") != NULL)
+    {
+        PRINT_ERR("snapshot sees a key pushed after it was taken");
+        error_status = ERROR;
+    }
+
+    if(hashmap_get(map, "one") != NULL || hashmap_get(map, "three") != &values[2])
+    {
+        PRINT_ERR("live map does not reflect its own changes");
+        error_status = ERROR;
+    }
+
+    // The snapshot outliving its map should still read correctly
+    hashmap_destroy(map, NULL);
+
+    if(hashmap_get(snapshot, "two") != &values[1])
+    {
+        PRINT_ERR("snapshot lost a key after the map was destroyed");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(snapshot, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test modifying a snapshot
+ * @details hashmap_push() and hashmap_delete() should return ERROR and errno should be HASHMAP_ERR_READ_ONLY
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(snapshot_read_only_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(20);
+    hashmap_t* snapshot = NULL;
+    int value = 1;
+
+    hashmap_push(map, "key", &value);
+    snapshot = hashmap_snapshot(map);
+
+    if(hashmap_push(snapshot, "other", &value) != ERROR || hashmap_errno() != HASHMAP_ERR_READ_ONLY)
+    {
+        PRINT_ERR("hashmap_push() on a snapshot did not fail with HASHMAP_ERR_READ_ONLY");
+        error_status = ERROR;
+    }
+
+    if(hashmap_delete(snapshot, "key", NULL) != ERROR || hashmap_errno() != HASHMAP_ERR_READ_ONLY)
+    {
+        PRINT_ERR("hashmap_delete() on a snapshot did not fail with HASHMAP_ERR_READ_ONLY");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(snapshot, NULL);
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
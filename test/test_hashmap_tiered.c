@@ -0,0 +1,292 @@
+/**
+ * @file test_hashmap_tiered.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_tiered_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "test.h"
+#include "hashmap_tiered.h"
+
+#define TIERED_TEST_KEYS 2000
+#define TIERED_TEST_HOT 100
+#define TIERED_CHURN_ROUNDS 200000  // Push and delete pairs of the churn test
+#define TIERED_CHURN_SLACK (1 << 20) // Bytes the heap may grow by during the churn test
+
+// Values seen by the async test
+typedef struct tiered_results tiered_results_t;
+struct tiered_results
+{
+    int found;      // Values that matched their key
+    int missing;    // Keys delivered without a value
+    int wrong;      // Values that did not match their key
+};
+
+/**
+ * @brief Writes an int value as its bytes
+ * 
+ * @param value - pointer to the int
+ * @param buf - destination
+ * @param space - room in buf
+ * @return size_t - sizeof(int)
+ */
+static size_t encode_int(const void* value, void* buf, size_t space)
+{
+    if(space >= sizeof(int)) memcpy(buf, value, sizeof(int));
+    return sizeof(int);
+}
+
+/**
+ * @brief Makes a new int value from its bytes
+ * 
+ * @param bytes - the bytes
+ * @param len - must be sizeof(int)
+ * @return void* - the new int, NULL if len is wrong
+ */
+static void* decode_int(const void* bytes, size_t len)
+{
+    int* value = (len == sizeof(int)) ? (int *)malloc(sizeof(int)) : NULL;
+
+    if(value != NULL) memcpy(value, bytes, sizeof(int));
+    return value;
+}
+
+/**
+ * @brief Allocates an int value
+ * 
+ * @param number - the int
+ * @return int*
+ */
+static int* new_int(int number)
+{
+    int* value = (int *)malloc(sizeof(int));
+
+    *value = number;
+    return value;
+}
+
+/**
+ * @brief Creates a tiered map with TIERED_TEST_KEYS int values, keys "key<i>" for value i
+ * 
+ * @param path - file for the cold pairs
+ * @return hashmap_tiered_t* - the map, NULL if error
+ */
+static hashmap_tiered_t* tiered_fill(const char* path)
+{
+    hashmap_tiered_config_t config = { TIERED_TEST_HOT, 16, encode_int, decode_int, free };
+    hashmap_tiered_t* map = hashmap_tiered_create(path, 256, &config);
+    char key[MAX_STRING];
+
+    for(int i = 0; map != NULL && i < TIERED_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+        hashmap_tiered_push(map, key, new_int(i));
+    }
+
+    return map;
+}
+
+/**
+ * @brief Records a value delivered by hashmap_tiered_get_async()
+ * 
+ * @param key - key looked up
+ * @param value - its value or NULL
+ * @param ctx - the tiered_results_t
+ */
+static void count_result(const char* key, void* value, void* ctx)
+{
+    tiered_results_t* results = (tiered_results_t *)ctx;
+
+    if(value == NULL) results->missing++;
+    else if(*(int *)value == atoi(key + 3)) results->found++;
+    else results->wrong++;
+}
+
+/**
+ * @brief Test that pairs past hot_limit are spilled to disk and read back with their values
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(tiered_spill_test)
+{
+    STATUS error_status = SUCCESS;
+    char path[] = "/tmp/hashmap_tiered_XXXXXX";
+    int fd = mkstemp(path);
+    hashmap_tiered_t* map = NULL;
+    char key[MAX_STRING];
+
+    if(fd < 0) return ERROR;
+    close(fd);
+
+    map = tiered_fill(path);
+
+    if(map == NULL || hashmap_tiered_size(map) != TIERED_TEST_KEYS ||
+       hashmap_tiered_cold_size(map) < TIERED_TEST_KEYS - TIERED_TEST_HOT)
+    {
+        PRINT_ERR("hashmap_tiered_push() did not spill the pairs past hot_limit");
+        error_status = ERROR;
+    }
+
+    int* duplicate = new_int(0);
+
+    if(hashmap_tiered_push(map, "key0", duplicate) != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("hashmap_tiered_push() accepted a key that is on disk");
+        error_status = ERROR;
+    }
+
+    free(duplicate);
+
+    for(int i = 0; map != NULL && i < TIERED_TEST_KEYS; i++)
+    {
+        int* value = NULL;
+
+        snprintf(key, sizeof(key), "key%d", i);
+        value = (int *)hashmap_tiered_get(map, key);
+
+        if(value == NULL || *value != i)
+        {
+            PRINT_ERR("hashmap_tiered_get() returned the wrong value");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    if(hashmap_tiered_delete(map, "key0") != SUCCESS || hashmap_tiered_get(map, "key0") != NULL ||
+       hashmap_tiered_size(map) != TIERED_TEST_KEYS - 1)
+    {
+        PRINT_ERR("hashmap_tiered_delete() did not remove a cold pair");
+        error_status = ERROR;
+    }
+
+    hashmap_tiered_destroy(map);
+
+    if(access(path, F_OK) == 0)
+    {
+        PRINT_ERR("hashmap_tiered_destroy() left the file behind");
+        unlink(path);
+        error_status = ERROR;
+    }
+
+    return error_status;
+}
+
+/**
+ * @brief Test that batches of asynchronous reads deliver every value, more reads than there are slots
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(tiered_async_test)
+{
+    STATUS error_status = SUCCESS;
+    char path[] = "/tmp/hashmap_tiered_XXXXXX";
+    int fd = mkstemp(path);
+    hashmap_tiered_t* map = NULL;
+    tiered_results_t results = { 0, 0, 0 };
+    char key[MAX_STRING];
+
+    if(fd < 0) return ERROR;
+    close(fd);
+
+    map = tiered_fill(path);
+
+    for(int i = 0; map != NULL && i < TIERED_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+        hashmap_tiered_get_async(map, key, count_result, &results);
+    }
+
+    hashmap_tiered_get_async(map, "missing", count_result, &results);
+
+    while(hashmap_tiered_pending(map) > 0) hashmap_tiered_poll(map, 1);
+
+    if(results.found != TIERED_TEST_KEYS || results.missing != 1 || results.wrong != 0)
+    {
+        PRINT_ERR("hashmap_tiered_get_async() delivered the wrong values");
+        error_status = ERROR;
+    }
+
+    // Reads still queued at destroy are dropped without calling back
+    hashmap_tiered_get_async(map, "key0", count_result, &results);
+    hashmap_tiered_get_async(map, "key1", count_result, &results);
+    hashmap_tiered_destroy(map);
+
+    return error_status;
+}
+
+/**
+ * @brief Returns the bytes allocated from the heap, 0 where that can't be read
+ * 
+ * @return size_t
+ */
+static size_t heap_in_use(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Test that pushing and deleting one key over and over, below hot_limit, doesn't grow the heap
+ * @details Deleted pairs stay on the CLOCK ring until the hand passes, which it never does below hot_limit, so
+ * the ring has to be compacted as they pile up
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(tiered_churn_test)
+{
+    STATUS error_status = SUCCESS;
+    char path[] = "/tmp/hashmap_tiered_XXXXXX";
+    int fd = mkstemp(path);
+    hashmap_tiered_config_t config = { 1000, 16, encode_int, decode_int, free };
+    hashmap_tiered_t* map = NULL;
+    size_t before = 0;
+
+    if(fd < 0) return ERROR;
+    close(fd);
+
+    map = hashmap_tiered_create(path, 256, &config);
+
+    if(map == NULL)
+    {
+        PRINT_ERR("hashmap_tiered_create() failed");
+        return ERROR;
+    }
+
+    hashmap_tiered_push(map, "warm", new_int(0));
+    hashmap_tiered_delete(map, "warm");
+    before = heap_in_use();
+
+    for(int i = 0; i < TIERED_CHURN_ROUNDS; i++)
+    {
+        if(hashmap_tiered_push(map, "churn", new_int(i)) != SUCCESS || hashmap_tiered_delete(map, "churn") != SUCCESS)
+        {
+            PRINT_ERR("push and delete failed while churning");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    if(hashmap_tiered_size(map) != 0 || heap_in_use() > before + TIERED_CHURN_SLACK)
+    {
+        PRINT_ERR("deleted pairs piled up in memory");
+        error_status = ERROR;
+    }
+
+    hashmap_tiered_destroy(map);
+    unlink(path);
+
+    return error_status;
+}
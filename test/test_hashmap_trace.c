@@ -0,0 +1,183 @@
+/**
+ * @file test_hashmap_trace.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the latency histograms
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <pthread.h>
+
+#include "test.h"
+#include "hashmap_trace.h"
+
+#define TRACE_KEYS 1000
+#define TRACE_THREADS 4
+
+#ifdef HASHMAP_TRACE
+
+/**
+ * @brief Pushes, gets and deletes TRACE_KEYS keys in a map of the thread's own, then exits
+ * 
+ * @param arg - unused
+ * @return void* - NULL
+ */
+static void* trace_thread(void* arg)
+{
+    hashmap_t* map = hashmap_create(64);
+    char key[MAX_STRING];
+
+    (void)arg;
+
+    for(int i = 0; i < TRACE_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, map);
+        hashmap_get(map, key);
+        hashmap_delete(map, key, NULL);
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return NULL;
+}
+
+/**
+ * @brief Test that every push, get and delete is counted, from live and exited threads alike, and that reset drops them
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(trace_count_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(16);
+    pthread_t threads[TRACE_THREADS];
+    hashmap_trace_stats_t push;
+    hashmap_trace_stats_t get;
+    hashmap_trace_stats_t del;
+    char key[MAX_STRING];
+
+    hashmap_trace_reset();
+
+    for(int i = 0; i < TRACE_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_push(map, key, map);
+    }
+
+    for(int i = 0; i < TRACE_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key-%d", i);
+        hashmap_get(map, key);
+        hashmap_get_n(map, key, strlen(key));
+    }
+
+    hashmap_delete(map, "missing", NULL);
+
+    for(int i = 0; i < TRACE_THREADS; i++) pthread_create(&threads[i], NULL, trace_thread, NULL);
+    for(int i = 0; i < TRACE_THREADS; i++) pthread_join(threads[i], NULL);
+
+    if(hashmap_trace_stats(HASHMAP_TRACE_PUSH, &push) == ERROR || hashmap_trace_stats(HASHMAP_TRACE_GET, &get) == ERROR ||
+       hashmap_trace_stats(HASHMAP_TRACE_DELETE, &del) == ERROR)
+    {
+        PRINT_ERR("hashmap_trace_stats() failed");
+        hashmap_destroy(map, NULL);
+        return ERROR;
+    }
+
+    if(push.count != TRACE_KEYS * (TRACE_THREADS + 1) || get.count != TRACE_KEYS * (TRACE_THREADS + 2) ||
+       del.count != TRACE_KEYS * TRACE_THREADS + 1)
+    {
+        PRINT_ERR("some calls were not counted");
+        error_status = ERROR;
+    }
+
+    if(push.min_ns > push.p50_ns || push.p50_ns > push.p90_ns || push.p90_ns > push.p99_ns ||
+       push.p99_ns > push.p999_ns || push.p999_ns > push.max_ns || push.mean_ns > (double)push.max_ns)
+    {
+        PRINT_ERR("the percentiles are out of order");
+        error_status = ERROR;
+    }
+
+    // 1000 keys in 16 buckets make long chains, and every get finds its key
+    if(get.max_chain < 16 || get.mean_probes < 1.0 || get.mean_probes > get.mean_chain)
+    {
+        PRINT_ERR("the chain and probe samples don't match the map");
+        error_status = ERROR;
+    }
+
+    hashmap_trace_reset();
+
+    if(hashmap_trace_stats(HASHMAP_TRACE_PUSH, &push) == ERROR || push.count != 0)
+    {
+        PRINT_ERR("hashmap_trace_reset() kept samples");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+#else
+
+/**
+ * @brief Test that a build without HASHMAP_TRACE reports tracing as off
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(trace_disabled_test)
+{
+    hashmap_trace_stats_t stats;
+
+    if(hashmap_trace_stats(HASHMAP_TRACE_GET, &stats) != ERROR || hashmap_errno() != HASHMAP_ERR_INVALID_CONFIG)
+    {
+        PRINT_ERR("hashmap_trace_stats() succeeded without HASHMAP_TRACE");
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+#endif
+
+/**
+ * @brief Test that the dump writes a line per operation, or says tracing is off
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(trace_dump_test)
+{
+    STATUS error_status = SUCCESS;
+    FILE* out = tmpfile();
+    char line[256];
+    int lines = 0;
+
+    if(out == NULL)
+    {
+        PRINT_ERR("could not open a temporary file");
+        return ERROR;
+    }
+
+    hashmap_trace_dump(out);
+    rewind(out);
+
+    while(fgets(line, sizeof(line), out) != NULL) lines++;
+
+#ifdef HASHMAP_TRACE
+    if(lines != HASHMAP_TRACE_OPS + 1)
+#else
+    if(lines != 1)
+#endif
+    {
+        PRINT_ERR("hashmap_trace_dump() wrote the wrong number of lines");
+        error_status = ERROR;
+    }
+
+    fclose(out);
+
+    return error_status;
+}
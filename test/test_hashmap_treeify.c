@@ -0,0 +1,112 @@
+/**
+ * @file test_hashmap_treeify.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for buckets that hold more keys than TREEIFY_THRESHOLD
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+
+#define TREEIFY_TEST_KEYS 200
+
+
+/**
+ * @brief Test pushing, getting and deleting many keys in a single bucket
+ * @details The bucket becomes sorted and turns back into a list as keys are deleted. Every remaining key
+ * should be found at each step.
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(treeify_single_bucket_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1);
+    char key[MAX_STRING] = {0};
+    static int values[TREEIFY_TEST_KEYS];
+
+    for(int i = 0; i < TREEIFY_TEST_KEYS; i++)
+    {
+        snprintf(key, MAX_STRING, "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    // Delete all but the last 3 keys, checking the rest each time the bucket is about to change shape
+    for(int i = 0; i < TREEIFY_TEST_KEYS - 3; i++)
+    {
+        snprintf(key, MAX_STRING, "key-%d", i);
+
+        if(hashmap_delete(map, key, NULL) != SUCCESS)
+        {
+            PRINT_ERR("hashmap_delete() did not find a pushed key");
+            error_status = ERROR;
+            break;
+        }
+
+        for(int j = i + 1; j < TREEIFY_TEST_KEYS && (TREEIFY_TEST_KEYS - i) < 12; j++)
+        {
+            snprintf(key, MAX_STRING, "key-%d", j);
+
+            if(hashmap_get(map, key) != &values[j])
+            {
+                PRINT_ERR("hashmap_get() lost a key while the bucket shrank");
+                error_status = ERROR;
+                break;
+            }
+        }
+    }
+
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test a snapshot of a sorted bucket
+ * @details The copy the live map makes of a sorted bucket should stay sorted and the snapshot unchanged
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(treeify_snapshot_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_t* map = hashmap_create(1);
+    hashmap_t* snapshot = NULL;
+    char key[MAX_STRING] = {0};
+    static int values[TREEIFY_TEST_KEYS];
+
+    for(int i = 0; i < TREEIFY_TEST_KEYS; i++)
+    {
+        snprintf(key, MAX_STRING, "key-%d", i);
+        hashmap_push(map, key, &values[i]);
+    }
+
+    snapshot = hashmap_snapshot(map);
+    hashmap_push(map, "extra", &values[0]);
+
+    for(int i = 0; i < TREEIFY_TEST_KEYS; i++)
+    {
+        snprintf(key, MAX_STRING, "key-%d", i);
+
+        if(hashmap_get(map, key) != &values[i] || hashmap_get(snapshot, key) != &values[i])
+        {
+            PRINT_ERR("sorted bucket lost a key when copied");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    if(hashmap_get(snapshot, "extra") != NULL || hashmap_get(map, "extra") != &values[0])
+    {
+        PRINT_ERR("push after the snapshot is visible in the wrong map");
+        error_status = ERROR;
+    }
+
+    hashmap_destroy(snapshot, NULL);
+    hashmap_destroy(map, NULL);
+
+    return error_status;
+}
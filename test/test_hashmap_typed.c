@@ -0,0 +1,113 @@
+/**
+ * @file test_hashmap_typed.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for maps generated by HASHMAP_DEFINE()
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+#include "hashmap_typed.h"
+
+#define TYPED_TEST_KEYS 5000
+
+typedef struct
+{
+    int x;
+    int y;
+}point_t;
+
+HASHMAP_DEFINE(u64_double_map, uint64_t, double, hashmap_typed_hash_u64, HASHMAP_TYPED_EQ)
+HASHMAP_DEFINE(str_point_map, const char*, point_t, hashmap_typed_hash_str, HASHMAP_TYPED_STR_EQ)
+
+
+/**
+ * @brief Test storing scalar values inline in a generated map
+ * @details Values written through the pointer from get() should stick, and deletes should keep other keys reachable
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(typed_inline_values_test)
+{
+    STATUS error_status = SUCCESS;
+    u64_double_map_t* map = u64_double_map_create(1);
+
+    for(uint64_t key = 0; key < TYPED_TEST_KEYS; key++)
+    {
+        u64_double_map_push(map, key, (double)key / 2);
+    }
+
+    *u64_double_map_get(map, 10) += 100.0;
+
+    for(uint64_t key = 0; key < TYPED_TEST_KEYS; key += 3)
+    {
+        u64_double_map_delete(map, key);
+    }
+
+    for(uint64_t key = 0; key < TYPED_TEST_KEYS; key++)
+    {
+        double* value = u64_double_map_get(map, key);
+        double expected = (double)key / 2 + ((key == 10) ? 100.0 : 0.0);
+
+        if((key % 3 == 0) ? (value != NULL) : (value == NULL || *value != expected))
+        {
+            PRINT_ERR("get() returned the wrong value");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    if(u64_double_map_size(map) != TYPED_TEST_KEYS - (TYPED_TEST_KEYS + 2) / 3)
+    {
+        PRINT_ERR("size() is wrong after deletes");
+        error_status = ERROR;
+    }
+
+    u64_double_map_destroy(map);
+
+    return error_status;
+}
+
+/**
+ * @brief Test string keys with struct values and duplicate detection in a generated map
+ * @details A duplicate push should return HASHMAP_ERR_DUPLICATE and a missing delete HASHMAP_ERR_NOT_FOUND
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(typed_string_keys_test)
+{
+    STATUS error_status = SUCCESS;
+    str_point_map_t* map = str_point_map_create(4);
+    char key[] = "origin";
+    point_t origin = {0, 0};
+    point_t unit = {1, 1};
+
+    str_point_map_push(map, "origin", origin);
+    str_point_map_push(map, "unit", unit);
+
+    // Lookups compare bytes, not pointers
+    if(str_point_map_get(map, key) == NULL || str_point_map_get(map, "unit")->x != 1)
+    {
+        PRINT_ERR("get() did not find a pushed key");
+        error_status = ERROR;
+    }
+
+    if(str_point_map_push(map, key, unit) != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("push() did not return HASHMAP_ERR_DUPLICATE");
+        error_status = ERROR;
+    }
+
+    if(str_point_map_delete(map, "missing") != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("delete() did not return HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    str_point_map_destroy(map);
+
+    return error_status;
+}
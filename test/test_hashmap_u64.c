@@ -0,0 +1,125 @@
+/**
+ * @file test_hashmap_u64.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_u64_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include "test.h"
+#include "hashmap_u64.h"
+
+#define U64_TEST_KEYS 10000
+
+
+/**
+ * @brief Test pushing, getting and deleting many integer keys
+ * @details The map has to grow several times and deletes have to keep every other key reachable
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(u64_push_get_delete_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_u64_t* map = hashmap_u64_create(1);
+    static int values[U64_TEST_KEYS];
+
+    for(uint64_t key = 0; key < U64_TEST_KEYS; key++)
+    {
+        if(hashmap_u64_push(map, key * 7919, &values[key]) != SUCCESS)
+        {
+            PRINT_ERR("hashmap_u64_push() failed");
+            error_status = ERROR;
+        }
+    }
+
+    // Delete every other key
+    for(uint64_t key = 0; key < U64_TEST_KEYS; key += 2)
+    {
+        hashmap_u64_delete(map, key * 7919, NULL);
+    }
+
+    for(uint64_t key = 0; key < U64_TEST_KEYS; key++)
+    {
+        void* expected = (key % 2 == 0) ? NULL : &values[key];
+
+        if(hashmap_u64_get(map, key * 7919) != expected)
+        {
+            PRINT_ERR("hashmap_u64_get() returned the wrong value");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    if(hashmap_u64_size(map) != U64_TEST_KEYS / 2)
+    {
+        PRINT_ERR("hashmap_u64_size() is wrong after deletes");
+        error_status = ERROR;
+    }
+
+    hashmap_u64_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test passing a duplicate key to hashmap_u64_push()
+ * @details Should return ERROR and errno should be HASHMAP_ERR_DUPLICATE
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(u64_duplicate_key_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_u64_t* map = hashmap_u64_create(20);
+    int value = 0;
+
+    hashmap_u64_push(map, 42, &value);
+
+    if(hashmap_u64_push(map, 42, &value) != ERROR)
+    {
+        PRINT_ERR("hashmap_u64_push() did not return ERROR with duplicate key");
+        error_status = ERROR;
+    }
+
+    if(hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("errno is not HASHMAP_ERR_DUPLICATE");
+        error_status = ERROR;
+    }
+
+    hashmap_u64_destroy(map, NULL);
+
+    return error_status;
+}
+
+/**
+ * @brief Test deleting and getting a non existent key
+ * @details Should fail and errno should be HASHMAP_ERR_NOT_FOUND
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(u64_non_existent_key_test)
+{
+    STATUS error_status = SUCCESS;
+    hashmap_u64_t* map = hashmap_u64_create(20);
+
+    if(hashmap_u64_get(map, 7) != NULL || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_u64_get() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    if(hashmap_u64_delete(map, 7, NULL) != ERROR || hashmap_errno() != HASHMAP_ERR_NOT_FOUND)
+    {
+        PRINT_ERR("hashmap_u64_delete() did not fail with HASHMAP_ERR_NOT_FOUND");
+        error_status = ERROR;
+    }
+
+    hashmap_u64_destroy(map, NULL);
+
+    return error_status;
+}
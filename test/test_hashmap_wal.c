@@ -0,0 +1,294 @@
+/**
+ * @file test_hashmap_wal.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashmap_wal_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "test.h"
+#include "hashmap_wal.h"
+
+#define WAL_TEST_KEYS 1000
+#define WAL_TEST_THREADS 4
+#define WAL_TEST_THREAD_KEYS 100
+
+/**
+ * @brief Writes an int value as its bytes
+ * 
+ * @param value - pointer to the int
+ * @param buf - destination
+ * @param space - room in buf
+ * @return size_t - sizeof(int)
+ */
+static size_t encode_int(const void* value, void* buf, size_t space)
+{
+    if(space >= sizeof(int)) memcpy(buf, value, sizeof(int));
+    return sizeof(int);
+}
+
+/**
+ * @brief Makes a new int value from its bytes
+ * 
+ * @param bytes - the bytes
+ * @param len - must be sizeof(int)
+ * @return void* - the new int, NULL if len is wrong
+ */
+static void* decode_int(const void* bytes, size_t len)
+{
+    int* value = (len == sizeof(int)) ? (int *)malloc(sizeof(int)) : NULL;
+
+    if(value != NULL) memcpy(value, bytes, sizeof(int));
+    return value;
+}
+
+/**
+ * @brief Allocates an int value
+ * 
+ * @param number - the int
+ * @return int* 
+ */
+static int* new_int(int number)
+{
+    int* value = (int *)malloc(sizeof(int));
+
+    *value = number;
+    return value;
+}
+
+/**
+ * @brief Removes the files a test left in dir and dir itself
+ * 
+ * @param dir - the directory
+ */
+static void remove_dir(const char* dir)
+{
+    const char* names[] = { "log", "log.old", "snapshot", "snapshot.tmp" };
+    char path[256];
+
+    for(size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        unlink(path);
+    }
+
+    rmdir(dir);
+}
+
+/**
+ * @brief Test that pushes and deletes survive a reopen, and that a torn record at the end of the log is dropped
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(wal_recovery_test)
+{
+    STATUS error_status = SUCCESS;
+    char dir[] = "/tmp/hashmap_wal_XXXXXX";
+    hashmap_wal_config_t config = { HASHMAP_WAL_SYNC_NONE, 0, 0, encode_int, decode_int, free };
+    hashmap_wal_t* wal = NULL;
+    char key[MAX_STRING];
+    char path[256];
+    int fd = -1;
+
+    if(mkdtemp(dir) == NULL) return ERROR;
+
+    wal = hashmap_wal_open(dir, 256, &config);
+
+    for(int i = 0; i < WAL_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+        hashmap_wal_push(wal, key, new_int(i));
+    }
+
+    for(int i = 0; i < WAL_TEST_KEYS; i += 2)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+        hashmap_wal_delete(wal, key);
+    }
+
+    int* duplicate = new_int(0);
+
+    if(hashmap_wal_push(wal, "key1", duplicate) != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("hashmap_wal_push() accepted a duplicate key");
+        error_status = ERROR;
+    }
+
+    free(duplicate);
+
+    hashmap_wal_close(wal);
+
+    // Half a record, as left by a crash in the middle of a write
+    snprintf(path, sizeof(path), "%s/log", dir);
+    fd = open(path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if(fd >= 0 && write(fd, "\x01\x02\x03\x04\x05\x00\x00", 7) != 7) error_status = ERROR;
+    if(fd >= 0) close(fd);
+
+    wal = hashmap_wal_open(dir, 256, &config);
+
+    if(wal == NULL || hashmap_wal_size(wal) != WAL_TEST_KEYS / 2)
+    {
+        PRINT_ERR("hashmap_wal_open() did not recover the pairs");
+        error_status = ERROR;
+    }
+
+    for(int i = 0; wal != NULL && i < WAL_TEST_KEYS; i++)
+    {
+        int* value = NULL;
+
+        snprintf(key, sizeof(key), "key%d", i);
+        value = (int *)hashmap_wal_get(wal, key);
+
+        if((i % 2 == 0) != (value == NULL) || (value != NULL && *value != i))
+        {
+            PRINT_ERR("hashmap_wal_get() returned the wrong value after recovery");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    hashmap_wal_close(wal);
+    remove_dir(dir);
+
+    return error_status;
+}
+
+/**
+ * @brief Test that compaction shrinks the log and keeps every pair
+ * @details A small compact_bytes makes the background thread compact while the test keeps pushing
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(wal_compaction_test)
+{
+    STATUS error_status = SUCCESS;
+    char dir[] = "/tmp/hashmap_wal_XXXXXX";
+    hashmap_wal_config_t config = { HASHMAP_WAL_SYNC_INTERVAL, 1, 4096, encode_int, decode_int, free };
+    hashmap_wal_t* wal = NULL;
+    char key[MAX_STRING];
+    char path[256];
+    struct stat info;
+
+    if(mkdtemp(dir) == NULL) return ERROR;
+
+    wal = hashmap_wal_open(dir, 256, &config);
+
+    // Keep replacing the same few keys so the log grows while the map doesn't
+    for(int i = 0; i < WAL_TEST_KEYS * 10; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i % 10);
+        hashmap_wal_delete(wal, key);
+        hashmap_wal_push(wal, key, new_int(i));
+    }
+
+    if(hashmap_wal_compact(wal) != SUCCESS)
+    {
+        PRINT_ERR("hashmap_wal_compact() failed");
+        error_status = ERROR;
+    }
+
+    snprintf(path, sizeof(path), "%s/log", dir);
+
+    if(stat(path, &info) != 0 || info.st_size != 0)
+    {
+        PRINT_ERR("the log was not emptied by compaction");
+        error_status = ERROR;
+    }
+
+    hashmap_wal_close(wal);
+    wal = hashmap_wal_open(dir, 256, &config);
+
+    for(int i = 0; i < 10; i++)
+    {
+        int* value = NULL;
+
+        snprintf(key, sizeof(key), "key%d", i);
+        value = (int *)hashmap_wal_get(wal, key);
+
+        if(value == NULL || *value != WAL_TEST_KEYS * 10 - 10 + i)
+        {
+            PRINT_ERR("a pair was lost by compaction");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    hashmap_wal_close(wal);
+    remove_dir(dir);
+
+    return error_status;
+}
+
+/**
+ * @brief Pushes WAL_TEST_THREAD_KEYS keys of its own
+ * 
+ * @param arg - the durable map, with the thread number stored just before it in the test
+ * @return void* - NULL
+ */
+static void* push_keys(void* arg)
+{
+    hashmap_wal_t* wal = *(hashmap_wal_t **)arg;
+    int thread = *(int *)((hashmap_wal_t **)arg + 1);
+    char key[MAX_STRING];
+
+    for(int i = 0; i < WAL_TEST_THREAD_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "thread%d/key%d", thread, i);
+        hashmap_wal_push(wal, key, new_int(i));
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Test that concurrent writers with HASHMAP_WAL_SYNC_ALWAYS all get their records on disk
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(wal_group_commit_test)
+{
+    STATUS error_status = SUCCESS;
+    char dir[] = "/tmp/hashmap_wal_XXXXXX";
+    hashmap_wal_config_t config = { HASHMAP_WAL_SYNC_ALWAYS, 0, 0, encode_int, decode_int, free };
+    hashmap_wal_t* wal = NULL;
+    pthread_t threads[WAL_TEST_THREADS];
+    struct { hashmap_wal_t* wal; int thread; } args[WAL_TEST_THREADS];
+
+    if(mkdtemp(dir) == NULL) return ERROR;
+
+    wal = hashmap_wal_open(dir, 256, &config);
+
+    for(int t = 0; t < WAL_TEST_THREADS; t++)
+    {
+        args[t].wal = wal;
+        args[t].thread = t;
+        pthread_create(&threads[t], NULL, push_keys, &args[t]);
+    }
+
+    for(int t = 0; t < WAL_TEST_THREADS; t++) pthread_join(threads[t], NULL);
+
+    hashmap_wal_close(wal);
+    wal = hashmap_wal_open(dir, 256, &config);
+
+    if(hashmap_wal_size(wal) != WAL_TEST_THREADS * WAL_TEST_THREAD_KEYS)
+    {
+        PRINT_ERR("pushes from concurrent writers were lost");
+        error_status = ERROR;
+    }
+
+    hashmap_wal_close(wal);
+    remove_dir(dir);
+
+    return error_status;
+}
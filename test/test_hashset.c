@@ -0,0 +1,154 @@
+/**
+ * @file test_hashset.c
+ * @author J. Pisani (jgp9201@gmail.com)
+ * @brief Testing functions for the hashset_t library functions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <stdio.h>
+
+#include "test.h"
+#include "hashset.h"
+
+#define SET_TEST_KEYS 5000
+
+
+/**
+ * @brief Counts the keys passed by hashset_foreach()
+ * 
+ * @param key - unused
+ * @param ctx - pointer to the count
+ */
+static void count_key(const char* key, void* ctx)
+{
+    (void)key;
+    (*(size_t *)ctx)++;
+}
+
+/**
+ * @brief Test adding, finding and removing many keys
+ * @details The set has to grow several times and removals have to keep every other key reachable
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(hashset_add_remove_test)
+{
+    STATUS error_status = SUCCESS;
+    hashset_t* set = hashset_create(1);
+    char key[32];
+    size_t visited = 0;
+
+    for(int i = 0; i < SET_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+
+        if(hashset_add(set, key) != SUCCESS)
+        {
+            PRINT_ERR("hashset_add() failed");
+            error_status = ERROR;
+        }
+    }
+
+    if(hashset_add(set, "key0") != ERROR || hashmap_errno() != HASHMAP_ERR_DUPLICATE)
+    {
+        PRINT_ERR("hashset_add() accepted a duplicate key");
+        error_status = ERROR;
+    }
+
+    // Remove every other key
+    for(int i = 0; i < SET_TEST_KEYS; i += 2)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+        hashset_remove(set, key);
+    }
+
+    for(int i = 0; i < SET_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+
+        if(hashset_contains(set, key) != (i % 2))
+        {
+            PRINT_ERR("hashset_contains() is wrong after removals");
+            error_status = ERROR;
+            break;
+        }
+    }
+
+    hashset_foreach(set, count_key, &visited);
+
+    if(hashset_size(set) != SET_TEST_KEYS / 2 || visited != SET_TEST_KEYS / 2)
+    {
+        PRINT_ERR("hashset_size() or hashset_foreach() is wrong after removals");
+        error_status = ERROR;
+    }
+
+    hashset_destroy(set);
+
+    return error_status;
+}
+
+/**
+ * @brief Test union, intersection and difference of two overlapping sets
+ * @details a holds the multiples of 2 and b the multiples of 3 below SET_TEST_KEYS
+ * 
+ * @return STATUS - SUCCESS or ERROR
+ */
+REGISTER_TEST(hashset_operations_test)
+{
+    STATUS error_status = SUCCESS;
+    hashset_t* a = hashset_create(16);
+    hashset_t* b = hashset_create(16);
+    hashset_t* both = NULL;
+    hashset_t* either = NULL;
+    hashset_t* only_a = NULL;
+    char key[32];
+
+    for(int i = 0; i < SET_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+
+        if(i % 2 == 0) hashset_add(a, key);
+        if(i % 3 == 0) hashset_add(b, key);
+    }
+
+    either = hashset_union(a, b);
+    both = hashset_intersection(a, b);
+    only_a = hashset_difference(a, b);
+
+    if(either == NULL || both == NULL || only_a == NULL)
+    {
+        PRINT_ERR("a set operation returned NULL");
+        error_status = ERROR;
+    }
+
+    for(int i = 0; error_status == SUCCESS && i < SET_TEST_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key%d", i);
+
+        if(hashset_contains(either, key) != (i % 2 == 0 || i % 3 == 0) ||
+           hashset_contains(both, key) != (i % 6 == 0) ||
+           hashset_contains(only_a, key) != (i % 2 == 0 && i % 3 != 0))
+        {
+            PRINT_ERR("a set operation has the wrong keys");
+            error_status = ERROR;
+        }
+    }
+
+    if(hashset_union(a, NULL) != NULL || hashmap_errno() != HASHMAP_ERR_NULL_ARG)
+    {
+        PRINT_ERR("hashset_union() accepted a NULL set");
+        error_status = ERROR;
+    }
+
+    hashset_destroy(either);
+    hashset_destroy(both);
+    hashset_destroy(only_a);
+    hashset_destroy(a);
+    hashset_destroy(b);
+
+    return error_status;
+}